@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Arxiv {
+
+// Finds every occurrence of a fixed set of patterns in one pass over a text,
+// ignoring ASCII case. The patterns are compiled into a deterministic
+// automaton (Aho-Corasick with the failure links folded into a full
+// transition table), so scanning costs one table load per byte plus one
+// step per match, however many patterns there are. Bytes are mapped to
+// classes first, with 'A' and 'a' sharing one, so the table has a column per
+// distinct pattern byte rather than 256.
+//
+// Immutable once built; build a new one when the patterns change. Safe to
+// scan from several threads at once.
+class AhoCorasick {
+  public:
+    // Matches nothing.
+    AhoCorasick() = default;
+    // Pattern ids are indices into `patterns`. Empty patterns never match.
+    explicit AhoCorasick(const std::vector<std::string>& patterns);
+
+    std::size_t Patterns() const { return m_patterns; }
+
+    // True if any pattern occurs in `text`; stops at the first.
+    bool Matches(std::string_view text) const;
+
+    // Calls `fn(id, end)` for every occurrence, `end` being the offset just
+    // past it. Ordered by end, then longest first, then by id.
+    template <typename Fn> void ForEachMatch(std::string_view text, Fn&& fn) const {
+        if (m_output.empty())
+            return;
+        uint32_t state = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            state = m_next[state * m_classes + m_class[static_cast<unsigned char>(text[i])]];
+            for (uint32_t s = m_output[state]; s != NONE; s = m_output[m_fail[s]]) {
+                for (uint32_t id = m_first[s]; id != NONE; id = m_same[id])
+                    fn(std::size_t{id}, i + 1);
+            }
+        }
+    }
+
+    // Number of distinct patterns occurring in `text`. `seen` is working
+    // space; passing the same vector each time avoids allocating.
+    std::size_t CountDistinct(std::string_view text, std::vector<uint8_t>& seen) const;
+
+  private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    std::size_t m_patterns{0};
+    // Byte → column of m_next; 0 for bytes in no pattern.
+    std::array<uint16_t, 256> m_class{};
+    std::size_t m_classes{1};
+    // m_next[state * m_classes + class]: the full transition table.
+    std::vector<uint32_t> m_next;
+    std::vector<uint32_t> m_fail;
+    // Nearest state on the failure chain (starting with the state itself)
+    // where a pattern ends, or NONE.
+    std::vector<uint32_t> m_output;
+    // First pattern ending at a state, then the next with the same text.
+    std::vector<uint32_t> m_first;
+    std::vector<uint32_t> m_same;
+};
+
+} // namespace Arxiv
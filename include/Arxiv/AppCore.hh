@@ -5,15 +5,21 @@
 #ifndef ARXIV_APP_CORE
 #define ARXIV_APP_CORE
 
+#include "Arxiv/AhoCorasick.hh"
 #include "Arxiv/Article.hh"
+#include "Arxiv/Cancellation.hh"
 #include "Arxiv/Config.hh"
 #include "Arxiv/DatabaseManager.hh"
 #include "Arxiv/Fetcher.hh"
 #include "Arxiv/Ranker.hh"
+#include "Arxiv/RefreshScheduler.hh"
+#include "Arxiv/RelatedIndex.hh"
+#include "Arxiv/TermCache.hh"
 
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -26,6 +32,7 @@
 
 namespace Arxiv {
 
+class DaemonFetcher;
 class ReplayRecorder; // forward decl — included only by users that pass one
 
 class AppCore {
@@ -58,35 +65,64 @@ class AppCore {
         FollowedAuthors = 6,
         NewArticles = 7,
         Unread = 8,
+        Related = 9,
         // Filter indices [TagBase, m_project_start_index) are tags.
         // Filter indices [m_project_start_index, ...) are projects.
         // GetFilterView() uses those runtime boundaries — TagBase and Project
         // are used only as return-value tags in switch statements.
-        TagBase = 9,
+        TagBase = 10,
         Project = 100, // sentinel returned by GetFilterView() for project indices
     };
 
     // Article management
     void FetchArticles();
+    // Fetch from the network now — today's listing, or everything since
+    // `since_utc_date` ("YYYY-MM-DD") when given — and store the result.
+    // Blocks; safe to call from a worker thread. The current view picks the
+    // new rows up on the next TryRefetchIfNeeded(). Returns how many
+    // articles were stored.
+    std::size_t FetchFromNetwork(const std::string& since_utc_date = "");
     void ToggleBookmark(const std::string& article_link);
     void MarkArticleRead(const std::string& article_link);
     bool DownloadArticle(const std::string& article_id);
     std::string GetBibtex(const Article& article);
     const std::vector<Article>& GetCurrentArticles() const;
+    // Predicted scores parallel to GetCurrentArticles(), computed once when a
+    // ranked view (Recommended, New Articles) is built and again when a
+    // retrain refetches it, so rendering never runs the model. Empty for
+    // other views and while the ranker is untrained.
+    const std::vector<float>& GetCurrentScores() const { return m_current_scores; }
     std::vector<std::string>& GetCurrentTitles();
 
     // Rating and ranking
+    //
+    // Once the ranker is trained, each rating is also applied straight away
+    // as an online update (Ranker::Update with a replay sample of earlier
+    // ratings) on a background thread, which then flags the view for
+    // refetch. Every `retrain_interval` ratings a warm-start retrain over all
+    // of them consolidates those updates.
+    //
+    // Fetching through a daemon (DaemonFetcher), the daemon owns the model:
+    // ratings and forced retrains are sent to it, nothing is trained or
+    // saved here, and the model and related index it saves are loaded as
+    // they change.
     void RateArticle(const std::string& article_link, int rating);
     // Rate all selected articles (or the focused article if no selection) with
     // the given score, triggering a single retrain check after all ratings are saved.
     void RateSelected(int rating);
+    // Block until every rating queued so far has been applied online.
+    void WaitForOnlineUpdates();
     int GetArticleRating(const std::string& article_link) const;
     float GetPredictedScore(const Article& article) const;
+    // Scores for `articles` in one Ranker::PredictBatch call; empty while the
+    // ranker is untrained.
+    std::vector<float> GetPredictedScores(const std::vector<Article>& articles) const;
     bool IsRankerTrained() const;
     bool IsTraining() const { return m_training.load(); }
     int PendingRatings() const { return m_ratings_since_train; }
     // Called from the UI refresh loop to re-fetch articles after background
-    // training completes. Must be called on the main thread.
+    // training completes, or after a daemon saves a new model. Must be
+    // called on the main thread.
     void TryRefetchIfNeeded();
     // Force a full cold-start retrain (new vocabulary, reset weights) regardless
     // of the pending-ratings counter.
@@ -181,17 +217,36 @@ class AppCore {
     bool HasSearchQuery() const { return m_search.active; }
     std::string GetSearchQuery() const { return m_search.query; }
 
+    // "More like this": switch to the Related view, listing the
+    // RELATED_COUNT stored articles whose feature vectors are nearest
+    // `article_link`'s, nearest first. The index behind it (RelatedIndex)
+    // is saved beside the ranker file, extended as articles are ingested,
+    // trimmed as they are deleted or pruned, and rebuilt whenever the
+    // ranker's vectoriser changes.
+    static constexpr std::size_t RELATED_COUNT = 50;
+    void ShowRelated(const std::string& article_link);
+    std::string GetRelatedLink() const { return m_related_link; }
+    // True while the index lags the published model's vectoriser, i.e. until
+    // the background rebuild after a cold retrain (or first launch) ends.
+    bool IsRelatedBuilding() const;
+
     // Author subscriptions
     void FollowAuthor(const std::string& author_name);
     void UnfollowAuthor(const std::string& author_name);
     std::vector<std::string> GetFollowedAuthors() const;
     std::vector<Article> GetArticlesForFollowedAuthors() const;
 
-    // Background auto-refresh
+    // Background auto-refresh. Polls the network on the arXiv announcement
+    // calendar (see RefreshScheduler); auto_refresh_minutes caps the backoff
+    // while a mailing is late.
     void StartAutoRefresh();
     void StopAutoRefresh();
     bool IsAutoRefreshing() const;
     int GetAutoRefreshMinutes() const;
+    // When the next scheduled network poll is due. Every network fetch —
+    // initial, scheduled or requested — reschedules it and persists the
+    // schedule in the DB.
+    time_point NextRefreshDue() const;
 
     // Initial network fetch state (see FetchMode at top of class).
     // While an Async fetch is in flight, IsFetching() is true so the UI can
@@ -200,6 +255,12 @@ class AppCore {
     bool IsFetching() const { return m_fetching.load(); }
     void WaitForInitialFetch();
 
+    // Ask in-flight network requests, FetchSince paging and ranker training
+    // to stop at their next check so shutdown does not wait on them. Pages
+    // already fetched are still stored; a cancelled training run is dropped.
+    // Irreversible for this AppCore. Also called by the destructor.
+    void CancelBackgroundWork();
+
     // Category (arxiv tag) filter applied across every view. The set is
     // initialised to all configured topics in the constructor — toggling a
     // category off hides it from every list. Each setter triggers
@@ -298,8 +359,18 @@ class AppCore {
     std::vector<std::string> m_topics;
     std::unique_ptr<DatabaseManager> m_db;
     std::unique_ptr<Fetcher> m_fetcher;
-    Ranker m_ranker;
-    mutable std::mutex m_ranker_mutex;
+    // The published model: an immutable snapshot swapped atomically, so
+    // readers take Model() without blocking and a snapshot they hold stays
+    // valid after a newer one is published. Writers copy the current model
+    // (or train a fresh one) and Publish() it while holding m_publish_mutex,
+    // so concurrent writers cannot drop each other's changes.
+    std::shared_ptr<const Ranker> m_ranker = std::make_shared<const Ranker>();
+    std::mutex m_publish_mutex;
+    std::shared_ptr<const Ranker> Model() const;
+    // Quantises `model` first when the config asks for it.
+    void Publish(std::shared_ptr<Ranker> model);
+    // Tokenised article text; filled at ingest, read by training and scoring.
+    mutable TermCache m_term_cache;
     std::thread m_train_thread;
     std::atomic<bool> m_training{false};
     std::atomic<bool> m_needs_refetch{false};
@@ -307,13 +378,69 @@ class AppCore {
     int m_retrain_interval{5};
     float m_recommend_threshold{3.5f};
     std::string m_ranker_path{"ranker.bin"};
+    int m_ranker_hash_bits{0}; // vectoriser for cold retrains
+    bool m_ranker_quantise{false};
+    bool m_ranker_search{false}; // cross-validate cold retrains
 
     // Snapshot training data and spawn a background thread.
     // warm_start=true: keep existing vocab and weights as starting point.
     // warm_start=false: refit vocabulary and reset weights (full retrain).
     void SpawnTrainingThread(bool warm_start);
+    // Fit `ranker`'s vocabulary from the database's document-frequency
+    // table, backfilling term lists first. A no-op when hashed.
+    void FitVocabulary(Ranker& ranker);
+
+    // Related-papers index, tagged with the vectoriser it was built with.
+    // IndexRelated signs `articles` with the published model; RebuildRelated
+    // re-signs every cached term list once `model`'s vectoriser differs from
+    // the index's. Both save the index and hold m_related_build_mutex, so an
+    // ingest cannot slip between a rebuild's snapshot and its swap.
+    RelatedIndex m_related;
+    std::string m_related_path;
+    std::mutex m_related_build_mutex;
+    std::string m_related_link; // article shown by the Related view
+    void IndexRelated(const std::vector<Article>& articles);
+    void RebuildRelated(const Ranker& model);
+    // Cache and index what a fetch stored. A fetch through the daemon
+    // returns nothing; the daemon indexed and saved the articles itself, so
+    // its index is read back instead.
+    void IndexFetched(const std::vector<Article>& articles);
+    // Replace the index with the saved one, if that was built with the
+    // published model's vectoriser.
+    void ReloadRelated();
+
+    // Set when fetching through a daemon, which then owns the model files.
+    // ReloadModels() publishes the model and loads the index it saved since
+    // the last call, going by their modification times; main thread only.
+    const DaemonFetcher* m_daemon{nullptr};
+    std::filesystem::file_time_type m_ranker_saved{};
+    std::filesystem::file_time_type m_related_saved{};
+    void ReloadModels();
+    // Have the daemon store `links`' rating and train on it; ratings it
+    // cannot take are stored here for its next retrain.
+    void SendRatings(const std::vector<std::string>& links, int rating);
+    // Drop deleted or pruned `links` from the term cache and the index.
+    void ForgetArticles(const std::vector<std::string>& links);
+
+    // Online updates. Ratings of articles in the current view are queued
+    // for m_online_thread, started on the first one; it applies each batch
+    // together with a sample of m_replay, the most recent earlier ratings.
+    void QueueOnlineUpdate(const std::vector<std::string>& links, int rating);
+    void RunOnlineUpdates(std::vector<std::pair<TermList, int>> replay);
+    std::thread m_online_thread;
+    std::mutex m_online_mutex;
+    std::condition_variable m_online_cv;
+    std::vector<std::pair<Article, int>> m_online_queue; // guarded by m_online_mutex
+    bool m_online_busy{false};                           // guarded by m_online_mutex
+    bool m_online_stop{false};                           // guarded by m_online_mutex
+    // Guarded by m_publish_mutex: ratings applied online while a retrain is
+    // running, re-applied to the retrained model, and whether the model has
+    // online updates not yet saved.
+    std::vector<std::pair<TermList, int>> m_online_since_snapshot;
+    bool m_online_unsaved{false};
 
     std::vector<Article> m_current_articles;
+    std::vector<float> m_current_scores; // parallel to m_current_articles, or empty
     std::vector<std::string> m_current_titles;
     std::vector<std::string> m_filter_options;
     std::vector<std::string> m_filter_tag_names;
@@ -371,12 +498,18 @@ class AppCore {
     std::thread m_refresh_thread;
     std::atomic<bool> m_refresh_running{false};
     std::condition_variable m_refresh_cv;
-    std::mutex m_refresh_mutex;
+    mutable std::mutex m_refresh_mutex;
     int m_auto_refresh_minutes{0};
+    RefreshScheduler m_refresh_schedule; // guarded by m_refresh_mutex
+
+    // Feed a finished network fetch to the scheduler, persist the schedule
+    // and wake the refresh thread so it re-reads the due time.
+    void RecordRefresh(std::size_t added);
 
     // Initial network fetch state.
     std::thread m_initial_fetch_thread;
     std::atomic<bool> m_fetching{false};
+    CancellationToken m_cancel;
     ReplayRecorder* m_recorder = nullptr;
 
     // Active arxiv categories — empty = no filter. Initialised in the
@@ -391,6 +524,12 @@ class AppCore {
     // Keyword cold-start
     std::vector<std::string> m_keywords;
 
+    // Followed authors as GetArticlesForFollowedAuthors last read them, and a
+    // matcher over them that is rebuilt whenever the list differs.
+    mutable std::mutex m_author_matcher_mutex;
+    mutable std::vector<std::string> m_matched_authors;
+    mutable AhoCorasick m_author_matcher;
+
     // New-articles tracking: UTC date ("YYYY-MM-DD") that seeds the NewArticles view.
     // Set from the previous session's last_fetch_date on construction.
     std::string m_new_articles_since_date;
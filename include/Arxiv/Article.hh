@@ -6,6 +6,7 @@
 #define ARXIV_ARTICLE
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 #include "spdlog/spdlog.h"
@@ -28,6 +29,10 @@ struct Article {
     bool is_replacement{false};
     // True when the article has been opened in the detail pane or downloaded.
     bool read{false};
+    // Fetcher::ContentHash of the raw feed fields this article was built
+    // from; 0 if unknown. Lets a refresh recognise unchanged items before
+    // converting them.
+    uint64_t content_hash{0};
 
     Article() = default;
 
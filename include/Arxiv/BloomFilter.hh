@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "Arxiv/Hash.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Arxiv {
+
+// Fixed-size Bloom filter over pre-hashed 64-bit keys. No false negatives;
+// false positives at roughly `fp_rate` while Size() <= Capacity(). Probe
+// positions use double hashing (h1 + i * h2) with h2 derived from the key by
+// Hash::Mix, so callers hash once. Not thread-safe.
+class BloomFilter {
+  public:
+    explicit BloomFilter(std::size_t capacity = 0, double fp_rate = 0.01)
+        : m_capacity{std::max<std::size_t>(capacity, 64)} {
+        // m = -n ln p / (ln 2)^2,  k = (m / n) ln 2
+        const double ln2 = std::log(2.0);
+        const double n = static_cast<double>(m_capacity);
+        const double bits = std::ceil(-n * std::log(fp_rate) / (ln2 * ln2));
+        m_words.assign(static_cast<std::size_t>(bits) / 64 + 1, 0);
+        m_bits = m_words.size() * 64;
+        m_probes = std::max(1u, static_cast<unsigned>(std::lround(bits / n * ln2)));
+    }
+
+    void Add(uint64_t key) {
+        const uint64_t h2 = Hash::Mix(key) | 1;
+        for (unsigned i = 0; i < m_probes; ++i) {
+            const std::size_t bit = (key + i * h2) % m_bits;
+            m_words[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+        ++m_size;
+    }
+
+    bool MightContain(uint64_t key) const {
+        const uint64_t h2 = Hash::Mix(key) | 1;
+        for (unsigned i = 0; i < m_probes; ++i) {
+            const std::size_t bit = (key + i * h2) % m_bits;
+            if (!(m_words[bit / 64] & (uint64_t{1} << (bit % 64))))
+                return false;
+        }
+        return true;
+    }
+
+    std::size_t Capacity() const { return m_capacity; }
+    std::size_t Size() const { return m_size; }
+
+  private:
+    std::size_t m_capacity;
+    std::size_t m_size = 0;
+    std::size_t m_bits = 0;
+    unsigned m_probes = 1;
+    std::vector<uint64_t> m_words;
+};
+
+} // namespace Arxiv
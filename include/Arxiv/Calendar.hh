@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+
+namespace Arxiv {
+namespace Calendar {
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's
+// days_from_civil). Avoids timegm, which is not in the C++ standard.
+constexpr int64_t DaysFromCivil(int y, int m, int d) {
+    int64_t year = y;
+    if (m <= 2)
+        --year;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;
+    const int64_t mp = m > 2 ? m - 3 : m + 9;
+    const int64_t doy = (153 * mp + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+} // namespace Calendar
+} // namespace Arxiv
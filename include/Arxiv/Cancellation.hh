@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+
+namespace Arxiv {
+
+// Cooperative cancellation flag. The owner calls Cancel(); long-running work
+// (transfers, the FetchSince page loop, training epochs) polls IsCancelled()
+// at safe points and stops early, keeping whatever it already finished.
+// Cancel() is sticky until Reset(). Workers hold a const pointer, which may
+// be null for "never cancelled".
+class CancellationToken {
+  public:
+    void Cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    void Reset() { m_cancelled.store(false, std::memory_order_relaxed); }
+    bool IsCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    static bool IsCancelled(const CancellationToken* token) {
+        return token && token->IsCancelled();
+    }
+
+  private:
+    std::atomic<bool> m_cancelled{false};
+};
+
+} // namespace Arxiv
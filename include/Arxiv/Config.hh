@@ -37,12 +37,19 @@ class Config {
     const std::vector<KeyMapping>& get_key_mappings() const { return key_mappings_; }
     float get_recommend_threshold() const { return recommend_threshold_; }
     int get_retrain_interval() const { return retrain_interval_; }
+    int get_ranker_hash_bits() const { return ranker_hash_bits_; }
+    bool get_ranker_quantise() const { return ranker_quantise_; }
+    bool get_ranker_search() const { return ranker_search_; }
     const std::string& get_db_file() const { return db_file_; }
     const std::string& get_keywords_file() const { return keywords_file_; }
     const std::string& get_ranker_file() const { return ranker_file_; }
+    const std::string& get_daemon_socket() const { return daemon_socket_; }
     const std::string& get_obsidian_vault() const { return obsidian_vault_; }
     const std::string& get_clipboard_backend() const { return clipboard_backend_; }
     int get_auto_refresh_minutes() const { return auto_refresh_minutes_; }
+    const std::vector<std::string>& get_announcement_holidays() const {
+        return announcement_holidays_;
+    }
     int get_scroll_margin() const { return scroll_margin_; }
     int get_max_article_age_days() const { return max_article_age_days_; }
     std::size_t get_undo_buffer_size() const { return undo_buffer_size_; }
@@ -54,12 +61,19 @@ class Config {
     void set_key_mappings(const std::vector<KeyMapping>& mappings) { key_mappings_ = mappings; }
     void set_recommend_threshold(float t) { recommend_threshold_ = t; }
     void set_retrain_interval(int n) { retrain_interval_ = n; }
+    void set_ranker_hash_bits(int bits) { ranker_hash_bits_ = bits; }
+    void set_ranker_quantise(bool on) { ranker_quantise_ = on; }
+    void set_ranker_search(bool on) { ranker_search_ = on; }
     void set_db_file(const std::string& path) { db_file_ = path; }
     void set_keywords_file(const std::string& path) { keywords_file_ = path; }
     void set_ranker_file(const std::string& path) { ranker_file_ = path; }
+    void set_daemon_socket(const std::string& path) { daemon_socket_ = path; }
     void set_obsidian_vault(const std::string& path) { obsidian_vault_ = path; }
     void set_clipboard_backend(const std::string& b) { clipboard_backend_ = b; }
     void set_auto_refresh_minutes(int m) { auto_refresh_minutes_ = m; }
+    void set_announcement_holidays(const std::vector<std::string>& dates) {
+        announcement_holidays_ = dates;
+    }
     void set_scroll_margin(int n) { scroll_margin_ = n; }
     void set_max_article_age_days(int n) { max_article_age_days_ = n; }
     void set_undo_buffer_size(std::size_t n) { undo_buffer_size_ = n; }
@@ -74,11 +88,22 @@ class Config {
     std::vector<KeyMapping> key_mappings_;
     float recommend_threshold_{3.5f};
     int retrain_interval_{5};
+    // log2 of the ranker's hashed feature columns; 0 = fitted vocabulary.
+    int ranker_hash_bits_{0};
+    // Score with int8 weights (Ranker::Quantise).
+    bool ranker_quantise_{false};
+    // Pick the ranker's hyperparameters by cross-validation on full
+    // retrains (RankerSearch).
+    bool ranker_search_{false};
     std::string db_file_{"articles.db"};
     std::string keywords_file_;
     std::string ranker_file_{"ranker.bin"};
+    // Where `arxiv-tui --daemon` listens; empty = never use a daemon.
+    std::string daemon_socket_;
     std::string obsidian_vault_;
     int auto_refresh_minutes_{0};
+    // US Eastern "YYYY-MM-DD" dates on which arXiv skips its mailing.
+    std::vector<std::string> announcement_holidays_;
     int scroll_margin_{3};
     int max_article_age_days_{0};
     std::size_t undo_buffer_size_{10};
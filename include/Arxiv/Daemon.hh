@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "Arxiv/Article.hh"
+#include "Arxiv/Config.hh"
+#include "Arxiv/Fetcher.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Arxiv {
+
+class AppCore;
+
+// ---------------------------------------------------------------------------
+// Wire protocol
+//
+// One JSON object per line over a SOCK_STREAM Unix socket.
+//   request:  {"id": 7, "op": "rate", "params": {...}}
+//   reply:    {"id": 7, "ok": true, "result": ...}
+//             {"id": 7, "ok": false, "error": "..."}
+//   event:    {"event": "new_articles", "count": 12}
+// Events are only sent to clients that issued "subscribe".
+//
+// Ops: ping, subscribe, fetch ({"since": "YYYY-MM-DD"} optional; replies
+// {"added": n}), rate ({"link", "rating"}), retrain (a cold one). The
+// daemon owns the model: a TUI attached to it sends its ratings and
+// retrains here and only reads the model files (see AppCore).
+// ---------------------------------------------------------------------------
+
+// Serves one AppCore to any number of local clients. Requests are handled one
+// at a time on the thread that calls Run(), so AppCore needs no extra locking;
+// network fetches run on a worker thread and their replies are deferred until
+// the fetch finishes. At most one fetch is in flight — concurrent "fetch"
+// requests share it.
+class Daemon {
+  public:
+    // Binds and listens on `socket_path` (mode 0600). Throws if another
+    // daemon already answers there; a stale socket file is replaced.
+    Daemon(AppCore& core, std::string socket_path);
+    ~Daemon();
+
+    Daemon(const Daemon&) = delete;
+    Daemon& operator=(const Daemon&) = delete;
+
+    // Serve until Stop(). With `auto_refresh` a network fetch is started
+    // whenever AppCore's announcement-aware schedule says one is due.
+    void Run(bool auto_refresh = false);
+
+    // Thread- and async-signal-safe: only writes one byte to a pipe.
+    void Stop();
+
+    const std::string& SocketPath() const { return m_socket_path; }
+
+    // Dispatch a single request without a socket. Exposed for testing;
+    // "fetch" runs synchronously here.
+    nlohmann::json Handle(const nlohmann::json& request);
+
+    // Default socket location: $XDG_RUNTIME_DIR/arxiv-tui.sock when the
+    // runtime dir is set, otherwise `fallback_dir`/daemon.sock.
+    static std::string DefaultSocketPath(const std::string& fallback_dir);
+
+  private:
+    struct Client {
+        int fd = -1;
+        std::string inbox;
+        bool subscribed = false;
+    };
+    struct Waiter {
+        int fd;
+        nlohmann::json id;
+    };
+
+    // Runs `request` for `client`. Returns nullopt when the reply is deferred.
+    std::optional<nlohmann::json> Dispatch(const nlohmann::json& request, Client* client);
+    void Accept();
+    bool ReadFrom(Client& client);
+    void StartFetch(const std::string& since);
+    void FinishFetch();
+    void Broadcast(const nlohmann::json& event);
+    void Send(int fd, const nlohmann::json& message);
+    void Drop(int fd);
+
+    AppCore& m_core;
+    std::string m_socket_path;
+    int m_listen_fd = -1;
+    int m_wake_pipe[2] = {-1, -1};
+    std::atomic<bool> m_running{false};
+    std::vector<Client> m_clients;
+
+    std::thread m_fetch_thread;
+    std::atomic<bool> m_fetch_done{false};
+    std::size_t m_fetched = 0;
+    std::string m_fetch_error;
+    std::vector<Waiter> m_fetch_waiters;
+    bool m_initial_fetch_pending = false;
+};
+
+// Blocking client for a Daemon socket.
+class DaemonClient {
+  public:
+    // nullptr if nothing is listening at `socket_path`.
+    static std::unique_ptr<DaemonClient> Connect(const std::string& socket_path);
+    ~DaemonClient();
+
+    DaemonClient(const DaemonClient&) = delete;
+    DaemonClient& operator=(const DaemonClient&) = delete;
+
+    // Send a request and wait for its reply, queueing any events that arrive
+    // first. Throws std::runtime_error on disconnect, timeout, or an error
+    // reply; returns the reply's "result".
+    nlohmann::json Call(const std::string& op,
+                        const nlohmann::json& params = nlohmann::json::object(),
+                        std::chrono::milliseconds timeout = std::chrono::seconds{30});
+
+    // Next pushed event, waiting up to `timeout`. Requires a prior
+    // Call("subscribe").
+    std::optional<nlohmann::json> NextEvent(std::chrono::milliseconds timeout);
+
+  private:
+    explicit DaemonClient(int fd)
+        : m_fd(fd) {}
+    // Read one line into `line`; false on timeout. Throws on disconnect.
+    bool ReadLine(std::string& line, std::chrono::milliseconds timeout);
+
+    int m_fd;
+    long m_next_id = 1;
+    std::string m_inbox;
+    std::deque<nlohmann::json> m_events;
+};
+
+// Fetcher that asks a running daemon to fetch instead of touching the
+// network. The daemon stores what it fetched, so Fetch/FetchSince return an
+// empty list and the caller re-reads its database as usual. Lets a TUI, GUI,
+// or cron --fetch share the daemon's single fetcher.
+class DaemonFetcher : public Fetcher {
+  public:
+    DaemonFetcher(std::string socket_path,
+                  const std::vector<std::string>& topics,
+                  const std::string& download_dir = "downloads");
+
+    std::vector<Article> Fetch() override;
+    std::vector<Article> FetchSince(const std::string& utc_date) override;
+
+    // Articles the daemon stored on the most recent call.
+    std::size_t LastFetchedCount() const { return m_last_count; }
+    const std::string& SocketPath() const { return m_socket_path; }
+
+  private:
+    std::size_t Request(const nlohmann::json& params);
+
+    std::string m_socket_path;
+    std::size_t m_last_count = 0;
+};
+
+// A DaemonFetcher if a daemon answers at config.get_daemon_socket(),
+// otherwise a network Fetcher.
+std::unique_ptr<Fetcher> MakeFetcher(const Config& config);
+
+} // namespace Arxiv
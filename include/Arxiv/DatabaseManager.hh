@@ -5,6 +5,12 @@
 #ifndef ARXIV_DATABASE_MANAGER
 #define ARXIV_DATABASE_MANAGER
 
+#include "Arxiv/BloomFilter.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <sqlite3.h>
 #include <string>
 #include <vector>
@@ -35,9 +41,14 @@ class DatabaseManager {
     virtual void DeleteArticle(const std::string& link);
     virtual void MarkArticleRead(const std::string& link);
     virtual std::vector<Article> GetUnreadArticles();
+    // True if an article with this link and content hash (see
+    // Fetcher::ContentHash) is stored. An in-memory Bloom filter of stored
+    // (link, hash) pairs, rebuilt at open and extended by AddArticle, answers
+    // most misses without touching SQLite; positives are confirmed exactly.
+    virtual bool IsKnownArticle(const std::string& link, uint64_t content_hash);
     // Delete articles older than max_age_days that are not bookmarked, rated,
-    // or in any project. Pass 0 to disable (no-op).
-    virtual void PruneArticles(int max_age_days);
+    // or in any project, returning their links. Pass 0 to disable (no-op).
+    virtual std::vector<std::string> PruneArticles(int max_age_days);
 
     // Rating management
     virtual void SetRating(const std::string& link, int rating);
@@ -90,25 +101,81 @@ class DatabaseManager {
 
     // Articles submitted on or after the given UTC date ("YYYY-MM-DD")
     virtual std::vector<Article> GetArticlesSince(const std::string& utc_date);
+    // The stored articles among `links`, in that order; missing links are
+    // skipped.
+    virtual std::vector<Article> GetArticles(const std::vector<std::string>& links);
 
     // Bulk insert wrapped in a single SQLite transaction. Hundreds of inserts
     // commit in milliseconds instead of seconds, which keeps the UI thread
     // from being blocked on DB reads while the background fetch is writing.
     virtual void AddArticles(const std::vector<Article>& articles);
 
+    // Tokenised-text cache backing TermCache: the term dictionary (strings
+    // in id order) and one packed term list per article, tagged with the
+    // content hash it was built from. Deleting or pruning an article drops
+    // its row. A document-frequency table over the stored lists is kept up
+    // to date in the same transactions, so fitting a vocabulary does not
+    // need the corpus.
+    struct ArticleTerms {
+        std::string link;
+        uint64_t content_hash{0};
+        std::string terms; // see PackTerms
+    };
+    // The stored terms with ids from `first_id` on, in id order.
+    virtual std::vector<std::string> GetTerms(std::size_t first_id = 0);
+    // One past the greatest stored term id.
+    virtual std::size_t CountTerms();
+    // The stored rows among `links`, in that order; links without one are
+    // skipped.
+    virtual std::vector<ArticleTerms> GetArticleTerms(const std::vector<std::string>& links);
+    // Call `fn` for every stored row, one at a time.
+    virtual void ForEachArticleTerms(const std::function<void(ArticleTerms&)>& fn);
+    // Store `new_terms` under ids first_id, first_id + 1, ... and upsert
+    // `rows`, in one transaction. Several processes may share the file, so
+    // the ids are only taken if the table still ends at first_id (or, with
+    // no new terms, still holds the ids `rows` refer to); otherwise nothing
+    // is written and false is returned, and the caller should read the
+    // terms stored since (GetTerms(first_id)) and number its own after them.
+    virtual bool StoreTerms(std::size_t first_id,
+                            const std::vector<std::string>& new_terms,
+                            const std::vector<ArticleTerms>& rows);
+    virtual void ClearTerms();
+    // The `limit` single-word terms in the most stored lists, as (document
+    // frequency, term), most frequent first; ties go to the greater term,
+    // as in Ranker::FitVocabulary.
+    virtual std::vector<std::pair<int, std::string>> GetTopTerms(std::size_t limit);
+    // Number of stored term lists: the document count for GetTopTerms.
+    virtual std::size_t CountTermLists();
+    // Articles with no stored term list, or one built from other content.
+    virtual std::vector<Article> GetArticlesWithoutTerms();
+
   private:
     sqlite3* db;
+    BloomFilter m_known;
+    std::mutex m_known_mutex;
 
     void SetupTracing();
     void ExecuteSQL(const std::string& sql);
     void Query(const std::string& query);
     Article RowToArticle(sqlite3_stmt* stmt);
+    // A row selected as (link, content_hash, terms).
+    ArticleTerms RowToArticleTerms(sqlite3_stmt* stmt);
     const char* ExtractColumn(sqlite3_stmt* stmt, int index);
     void MigrateNormalizeLinks();
     void MigrateAddReadAt();
     void MigrateAddFTS5();
     void MigrateAddProjectBibPath();
+    void RebuildKnownFilter();
     void CreateTagTables();
+    void CreateTermTables();
+    // Subtract the terms of each packed list in `removed` from the
+    // document-frequency table and add those in `added`. Caller holds a
+    // transaction.
+    void UpdateTermFrequencies(const std::vector<std::string>& removed,
+                               const std::vector<std::string>& added);
+    // Packed term lists of the article_terms rows matching `where`, an SQL
+    // condition that may take `link` as its one parameter.
+    std::vector<std::string> TermBlobs(const char* where, const std::string& link = "");
 
     static int TraceCallback(unsigned type, void*, void* p, void*);
 };
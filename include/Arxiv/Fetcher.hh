@@ -5,10 +5,20 @@
 #ifndef ARXIV_FETCHER
 #define ARXIV_FETCHER
 
+#include "Arxiv/Cancellation.hh"
+#include "Arxiv/Transport.hh"
+
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <filesystem>
+#include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace Arxiv {
@@ -19,8 +29,16 @@ class Article;
 
 class Fetcher {
   public:
+    // Type alias to avoid comma issues when used in trompeloeil MAKE_MOCK macros
+    using BibTeXMap = std::map<std::string, std::string>;
+    /// Returns true if an item with this canonical link and content hash is
+    /// already stored unchanged.
+    using KnownItemFilter = std::function<bool(const std::string& link, uint64_t content_hash)>;
+    /// `transport` defaults to the cpr backend; pass a FixtureTransport to
+    /// run against recorded responses.
     explicit Fetcher(const std::vector<std::string>& topics,
-                     const std::string& base_path = "downloads");
+                     const std::string& base_path = "downloads",
+                     std::unique_ptr<Transport> transport = nullptr);
     virtual ~Fetcher() = default;
     virtual std::vector<Article> Fetch();
     virtual std::vector<Article> FetchToday();
@@ -32,28 +50,72 @@ class Fetcher {
     /// Fetch BibTeX for an arXiv paper. Tries InspireHEP first; returns an
     /// empty string if the lookup fails (caller should generate fallback BibTeX).
     virtual std::string FetchBibTeX(const std::string& paper_id);
+    /// Fetch BibTeX for many arXiv papers at once. Ids are sent to InspireHEP
+    /// as OR-queries of up to INSPIRE_BATCH_SIZE eprints, with at most
+    /// INSPIRE_MAX_IN_FLIGHT requests running concurrently. The result maps
+    /// paper id → BibTeX for hits only; callers generate fallback BibTeX for
+    /// any id that is missing.
+    virtual BibTeXMap FetchBibTeXBatch(const std::vector<std::string>& paper_ids);
+
+    static constexpr std::size_t INSPIRE_BATCH_SIZE = 25;
+    static constexpr std::size_t INSPIRE_MAX_IN_FLIGHT = 4;
+
+    /// Override the InspireHEP API root (default "https://inspirehep.net/api").
+    /// Lets tests point the BibTeX lookups at a local stand-in server.
+    void SetInspireBaseUrl(const std::string& url) { m_inspire_base_url = url; }
+
+    /// When set, the feed parsers drop items the filter reports as known,
+    /// before any LaTeX conversion, so a refresh only returns new or changed
+    /// articles.
+    void SetKnownItemFilter(KnownItemFilter filter) { m_known_filter = std::move(filter); }
+
+    /// Every request polls `token` and is abandoned once it fires; FetchSince
+    /// then stops paging and returns what it already parsed. The token must
+    /// outlive the Fetcher. Null (the default) disables cancellation.
+    void SetCancellationToken(const CancellationToken* token) { m_cancel = token; }
+
+    /// Hash of an item's raw (pre-conversion) feed fields; never 0.
+    /// `revision` is whatever marks a new announcement of the same paper
+    /// (the RSS "arXiv:…vN Announce Type: …" header, the versioned Atom id),
+    /// so a replacement is never mistaken for a stored item.
+    static uint64_t ContentHash(std::string_view title,
+                                std::string_view abstract,
+                                std::string_view authors,
+                                std::string_view revision = {});
 
     /// Normalize an arXiv link to canonical form: https scheme, no version suffix.
     /// e.g. "http://arxiv.org/abs/2605.28788v1" → "https://arxiv.org/abs/2605.28788"
-    static std::string NormalizeLink(const std::string& link);
+    static std::string NormalizeLink(std::string_view link);
 
     // Parsing helpers exposed for testing.
-    std::vector<Article> ParseFeed(const std::string& xml) const;
-    std::vector<Article> ParseAtomFeed(const std::string& xml) const;
-    std::optional<time_point> ParseDate(const std::string& date) const;
-    std::optional<time_point> ParseAtomDate(const std::string& date) const;
-    std::string ReplaceLatexAccents(const std::string& text) const;
-    /// Strip LaTeX formatting commands, leaving plain text.
-    std::string StyleLatex(const std::string& text) const;
-    /// Convert LaTeX formatting commands to Markdown equivalents:
+    /// The feed parsers take the document by value and parse it in place;
+    /// move the body in to avoid copying it.
+    std::vector<Article> ParseFeed(std::string xml) const;
+    /// `entries`, if given, receives the number of <entry> elements seen,
+    /// including any dropped by the known-item filter.
+    std::vector<Article> ParseAtomFeed(std::string xml, std::size_t* entries = nullptr) const;
+    /// Parse an RSS <pubDate>: RFC-822 ("Mon, 25 Mar 2024 00:00:00 -0400")
+    /// or ISO-8601 ("2024-03-25T12:00:00Z"). Zone offsets are honoured; a
+    /// timestamp without one is taken as UTC.
+    std::optional<time_point> ParseDate(std::string_view date) const;
+    std::optional<time_point> ParseAtomDate(std::string_view date) const;
+    std::string ReplaceLatexAccents(std::string_view text) const;
+    /// Convert LaTeX formatting commands to Markdown equivalents (see
+    /// Arxiv::TranscodeLatex):
     /// \textit → *x*, \textbf → **x**, \texttt → `x`, \st → ~~x~~.
     /// $...$ math spans are preserved unchanged.
-    std::string LatexToMarkdown(const std::string& text) const;
+    std::string LatexToMarkdown(std::string_view text) const;
     std::string ConstructPaperUrl(const std::string& paper_id, const std::string& format) const;
+    /// Split a multi-entry InspireHEP BibTeX response into entries keyed by
+    /// their eprint field. Entries without an eprint are dropped.
+    static BibTeXMap ParseInspireBibTeX(const std::string& text);
 
   private:
-    static constexpr bool testing = false;
     std::vector<std::string> m_topics;
+    std::unique_ptr<Transport> m_transport;
+    KnownItemFilter m_known_filter;
+    const CancellationToken* m_cancel = nullptr;
+    std::string m_inspire_base_url{"https://inspirehep.net/api"};
 
     std::optional<std::string> FetchFeeds();
     std::filesystem::path base_path;
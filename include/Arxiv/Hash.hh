@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace Arxiv {
+namespace Hash {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+
+// 64-bit FNV-1a. Stable across platforms and runs, so values may be persisted
+// (fixture file names, the articles.content_hash column). Pass a previous
+// result as `seed` to hash several fields as one stream.
+constexpr uint64_t Fnv1a(std::string_view s, uint64_t seed = FNV_OFFSET) {
+    uint64_t h = seed;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// splitmix64 finaliser: spreads the bits of an already-hashed key, e.g. to
+// derive a second independent-looking hash from the first.
+constexpr uint64_t Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+namespace detail {
+
+constexpr uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+constexpr uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// Little-endian loads; the callers' data was written on the same host.
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+constexpr uint64_t xxh_round(uint64_t acc, uint64_t input) {
+    return rotl(acc + input * XXH_PRIME2, 31) * XXH_PRIME1;
+}
+constexpr uint64_t xxh_merge(uint64_t acc, uint64_t lane) {
+    return (acc ^ xxh_round(0, lane)) * XXH_PRIME1 + XXH_PRIME4;
+}
+
+} // namespace detail
+
+// XXH64 (the reference algorithm, so values match other implementations).
+// Several GB/s, for checksumming bulk data such as saved model files where
+// byte-at-a-time FNV-1a would dominate.
+inline uint64_t Xxh64(const void* data, std::size_t len, uint64_t seed = 0) {
+    using namespace detail;
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        uint64_t v2 = seed + XXH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME1;
+        for (; end - p >= 32; p += 32) {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    } else {
+        h = seed + XXH_PRIME5;
+    }
+    h += len;
+    for (; end - p >= 8; p += 8)
+        h = rotl(h ^ xxh_round(0, read64(p)), 27) * XXH_PRIME1 + XXH_PRIME4;
+    if (end - p >= 4) {
+        h = rotl(h ^ (read32(p) * XXH_PRIME1), 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        h = rotl(h ^ (*p * XXH_PRIME5), 11) * XXH_PRIME1;
+    h ^= h >> 33;
+    h *= XXH_PRIME2;
+    h ^= h >> 29;
+    h *= XXH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace Hash
+} // namespace Arxiv
@@ -47,7 +47,8 @@ class KeyBindings {
         UndoDelete,
         ExportDigestArchive,
         OpenInBrowser,
-        RateSelection
+        RateSelection,
+        ShowRelated
     };
 
     KeyBindings() = default;
@@ -5,16 +5,50 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace Arxiv {
 
-// Strip LaTeX markup from text, returning plain prose suitable for NLP.
+// Plain and Markdown renderings of one LaTeX string.
+struct LatexForms {
+    std::string plain;
+    std::string markdown;
+};
+
+// True if `text` contains a LaTeX metacharacter ('\' or '$'). Text without
+// one is returned unchanged by every function below without being scanned
+// further; most titles and author lists take this path.
+bool HasLatexMarkup(std::string_view text);
+
+// Render `text` as plain prose and as Markdown in a single table-driven scan.
 //
-// Rules applied in order:
+// Shared rules:
+//   - accent and letter macros (\'e, \v{s}, \ss, \o, ...) → UTF-8
+//   - escaped characters (\%, \&, ...) → the character (plain) / kept (Markdown)
+// Plain form (what StripLatex returns):
 //   1. $$...$$ display-math regions → replaced with a space
 //   2. $...$ inline-math regions   → replaced with a space
 //   3. \cmd{content}               → replaced with a space + content
 //   4. bare \cmd tokens            → replaced with a space
-std::string StripLatex(const std::string& text);
+// Markdown form (what LatexToMarkdown returns):
+//   - math regions are kept verbatim
+//   - \textit/\emph/\textsl → *x*, \textbf → **x**, \texttt → `x`, \st → ~~x~~;
+//     \textsc, \underline and similar are stripped to their content
+//   - any other command is kept, with its argument transcoded
+LatexForms TranscodeLatex(std::string_view text);
+
+// Strip LaTeX markup from text, returning plain prose suitable for NLP.
+// Equivalent to TranscodeLatex(text).plain.
+std::string StripLatex(std::string_view text);
+
+// StripLatex into `out`, replacing its contents. Reuses `out`'s capacity, so
+// a buffer kept across calls stops allocating once it has grown to fit.
+void StripLatex(std::string_view text, std::string& out);
+
+// Equivalent to TranscodeLatex(text).markdown.
+std::string LatexToMarkdown(std::string_view text);
+
+// Replace only accent and letter macros; all other markup is kept.
+std::string ReplaceLatexAccents(std::string_view text);
 
 } // namespace Arxiv
@@ -4,8 +4,14 @@
 
 #pragma once
 
+#include "Arxiv/AhoCorasick.hh"
 #include "Arxiv/Article.hh"
+#include "Arxiv/Cancellation.hh"
+#include "Arxiv/Terms.hh"
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -17,32 +23,210 @@ namespace Arxiv {
 // No external ML dependencies — everything is implemented in pure C++17.
 //
 // Architecture: input (MAX_FEATURES) → hidden (HIDDEN_SIZE, ReLU) → output (1 unit)
+// by default; see Hyperparameters for the sizes that can be tuned.
 // Output is linearly scaled to [1.0, 5.0].
-// Training uses mini-batch SGD with MSE loss.
+// Training uses shuffled mini-batch SGD with MSE loss. Each mini-batch is
+// split across a pool of workers with their own gradient accumulators,
+// reduced in worker order before the update. With enough ratings a
+// validation split is held out to pick the epoch count by early stopping,
+// and the network is then refitted on every rating for that many epochs.
+//
+// Articles are vectorised sparsely — a few dozen of the MAX_FEATURES terms
+// are non-zero — and the first layer is a sparse × dense product, so
+// Predict and Train cost O(non-zeros × HIDDEN_SIZE) per article rather than
+// O(MAX_FEATURES × HIDDEN_SIZE).
+//
+// Fitting, training and batch scoring also accept pre-tokenised TermLists
+// (see TermCache), so articles seen before are not tokenised again.
+//
+// Features come from one of two vectorisers, fixed at construction (or by
+// Load):
+//   - vocabulary: the MAX_FEATURES terms with the highest document
+//     frequency, weighted by IDF. FitVocabulary must run before training,
+//     and a refit invalidates the weights.
+//   - hashed: every term and adjacent-term bigram is hashed into one of
+//     2^hash_bits columns with a hash-derived sign, so colliding terms tend
+//     to cancel rather than pile up. There is nothing to fit — new articles
+//     never need a refit and a warm start is always valid.
 class Ranker {
   public:
     static constexpr int MAX_FEATURES = 512;
     static constexpr int HIDDEN_SIZE = 32;
     static constexpr int MIN_TRAIN = 3; // minimum rated articles to enable predictions
-    static constexpr int EPOCHS = 200;
+    static constexpr int EPOCHS = 200; // upper bound; early stopping may end sooner
     static constexpr float LR = 0.01f;
+    static constexpr int BATCH_SIZE = 64;
+    // Ratings needed before VALIDATION_FRACTION of them is held out to
+    // choose the epoch count by early stopping; below this every epoch runs
+    // on all of them.
+    static constexpr int MIN_VALIDATION = 20;
+    static constexpr float VALIDATION_FRACTION = 0.2f;
+    // Epochs without a validation improvement before the epoch search stops.
+    static constexpr int PATIENCE = 10;
+    static constexpr int ONLINE_STEPS = 5; // SGD steps per Update
+    static constexpr uint32_t TITLE_WEIGHT = 2; // title terms count double
+    static constexpr int MIN_HASH_BITS = 8;
+    static constexpr int MAX_HASH_BITS = 20;
+    // Bounds for Hyperparameters; the constants above are the defaults.
+    static constexpr int MIN_HIDDEN = 4;
+    static constexpr int MAX_HIDDEN = 128;
+    static constexpr int MIN_VOCABULARY = 64;
+    static constexpr int MAX_VOCABULARY = 4096;
+
+    // Network size and training schedule, saved with the model.
+    // `max_features` sizes the vocabulary vectoriser only; the hashed one
+    // always has 2^hash_bits columns.
+    struct Hyperparameters {
+        int hidden = HIDDEN_SIZE;
+        float learning_rate = LR;
+        int epochs = EPOCHS;
+        int max_features = MAX_FEATURES;
+
+        bool operator==(const Hyperparameters& other) const {
+            return hidden == other.hidden && learning_rate == other.learning_rate &&
+                   epochs == other.epochs && max_features == other.max_features;
+        }
+        bool operator!=(const Hyperparameters& other) const { return !(*this == other); }
+    };
+
+    // Where a term lands in the feature vector: column `index` (-1 if the
+    // term is not a feature) scaled by `weight` (its IDF, or the ±1 sign of
+    // a hashed term).
+    struct Column {
+        int index = -1;
+        float weight = 0.0f;
 
+        bool operator==(const Column& other) const {
+            return index == other.index && weight == other.weight;
+        }
+    };
+    // Column for each TermDictionary id.
+    using ColumnMap = std::vector<Column>;
+
+    // Non-zero TF-IDF (or hashed TF) entries, sorted by feature index.
+    struct Feature {
+        int index;
+        float value;
+    };
+    using SparseVector = std::vector<Feature>;
+
+    // Vocabulary vectoriser.
     Ranker();
+    // Hashed vectoriser over 2^hash_bits columns, clamped to
+    // [MIN_HASH_BITS, MAX_HASH_BITS]; 0 selects the vocabulary vectoriser.
+    explicit Ranker(int hash_bits);
+
+    bool IsHashed() const { return m_hash_bits > 0; }
 
-    // Build / update IDF weights from the full article corpus.
+    // Replace the hyperparameters, each clamped to its bounds. Discards the
+    // weights, so Train must run again before the ranker scores anything,
+    // and the vocabulary too when max_features changes (FitVocabulary).
+    void SetHyperparameters(const Hyperparameters& params);
+    const Hyperparameters& GetHyperparameters() const { return m_params; }
+    // 0 for the vocabulary vectoriser.
+    int HashBits() const { return m_hash_bits; }
+
+    // Build / update IDF weights from the full article corpus. A no-op for
+    // the hashed vectoriser.
     void FitVocabulary(const std::vector<Article>& articles);
 
     // Train the MLP on the set of rated articles (ratings 1-5).
     // warm_start=true: continue from the current weights (vocabulary must not
     // have changed).  warm_start=false (default): re-initialise weights first.
-    void Train(const std::vector<std::pair<Article, int>>& rated, bool warm_start = false);
+    // `cancel` is polled once per epoch. Returns false when training was
+    // skipped (too few ratings) or cancelled; a cancelled run leaves the
+    // weights half-updated and IsTrained() unchanged, so callers should
+    // discard the model. Mini-batches are spread over up to `max_threads`
+    // workers (0: one per core); the result depends on the worker count
+    // but is otherwise deterministic.
+    bool Train(const std::vector<std::pair<Article, int>>& rated,
+               bool warm_start = false,
+               const CancellationToken* cancel = nullptr,
+               unsigned max_threads = 0);
+
+    // Online learning: ONLINE_STEPS SGD steps over `rated` as one
+    // mini-batch, typically a fresh rating plus a replay sample of older
+    // ones so a single rating cannot drag the model too far. Cheap enough
+    // to run per rating; returns false (and does nothing) until trained.
+    bool Update(const std::vector<std::pair<Article, int>>& rated);
+
+    // --- Pre-tokenised features ------------------------------------------
+
+    // `article`'s terms as ids in `dict` (new terms are interned); title
+    // entries count TITLE_WEIGHT times. With `bigrams`, followed by the
+    // bigrams of adjacent terms within the title and within the abstract,
+    // interned as "first second". Only the hashed vectoriser reads bigrams,
+    // so pass IsHashed(): they would otherwise grow the dictionary several
+    // times over for nothing.
+    static TermList Terms(const Article& article, TermDictionary& dict, bool bigrams);
+    // Identifies the Tokeniser, the title weighting and whether bigrams are
+    // emitted. TermLists built under a different hash must be discarded.
+    static uint64_t TokeniserHash(bool bigrams);
+
+    // Identifies the vectoriser; changes whenever FitVocabulary or Load
+    // changes which term maps to which column, or with what weight.
+    uint64_t VocabularyHash() const;
+    // Extend `columns` to cover every id in `dict`. Entries already present
+    // are kept, so a growing dictionary is mapped incrementally; start from
+    // an empty map whenever VocabularyHash() changes.
+    void MapColumns(const TermDictionary& dict, ColumnMap& columns) const;
+
+    // Same as the Article overloads below, reading TermLists instead of
+    // tokenising. `dict` must cover every id in `docs`; `columns` must come
+    // from MapColumns over a dictionary that does.
+    void FitVocabulary(const std::vector<TermList>& docs, const TermDictionary& dict);
+    // Same again from counts kept elsewhere: `df` holds (document
+    // frequency, term) over `n_docs` documents, e.g. from
+    // DatabaseManager::GetTopTerms(GetHyperparameters().max_features).
+    void FitVocabulary(std::vector<std::pair<int, std::string>> df, std::size_t n_docs);
+    bool Train(const std::vector<std::pair<TermList, int>>& rated,
+               const ColumnMap& columns,
+               bool warm_start = false,
+               const CancellationToken* cancel = nullptr,
+               unsigned max_threads = 0);
+    bool Update(const std::vector<std::pair<TermList, int>>& rated, const ColumnMap& columns);
+    std::vector<float> PredictBatch(const std::vector<TermList>& docs,
+                                    const ColumnMap& columns,
+                                    unsigned max_threads = 0) const;
+    std::vector<float> PredictBatch(const std::vector<SharedTermList>& docs,
+                                    const ColumnMap& columns,
+                                    unsigned max_threads = 0) const;
+    // The L2-normalised feature vector the network sees for `terms`, into
+    // `vec` (see RelatedIndex).
+    void Features(const TermList& terms, const ColumnMap& columns, SparseVector& vec) const {
+        Vectorise(terms, columns, vec);
+    }
 
     // Predict a score in [1.0, 5.0] for an unrated article.
     // Returns 0.0 if the model has not been trained yet.
     float Predict(const Article& article) const;
 
+    // Predict() for every article at once; all 0.0 when untrained. Scores
+    // come back in input order and match Predict() exactly. Vectorising and
+    // the first layer are split across up to `max_threads` workers (0: one
+    // per core, never more than the batch warrants), filling one hidden
+    // matrix for the batch that the output layer then reduces in one pass.
+    // Safe to call concurrently with other const members.
+    std::vector<float> PredictBatch(const std::vector<Article>& articles,
+                                    unsigned max_threads = 0) const;
+
+    // Indices of the `k` highest scores, best first. Equal scores keep their
+    // input order. Uses a partial sort, so a small k over a large batch does
+    // not pay for sorting the rest.
+    static std::vector<std::size_t> TopK(const std::vector<float>& scores, std::size_t k);
+
     bool IsTrained() const { return m_trained; }
 
+    // Post-training quantisation: keep an int8 copy of W1, one scale per
+    // hidden unit, and score with it from then on. Each article's inputs
+    // are quantised too, so the first layer is int8 × int8 summed in int32,
+    // reading a quarter of the bytes fp32 does; scores differ from fp32 by
+    // rounding only (see RankerTest for the bound). The copy is dropped
+    // whenever training or Load replaces the weights, and saved by Save. A
+    // no-op when already quantised.
+    void Quantise();
+    bool IsQuantised() const;
+
     // Keyword cold-start: store interest keywords for scoring before ML training.
     void FitKeywords(const std::vector<std::string>& keywords);
     bool IsFitKeywords() const { return m_fit_keywords; }
@@ -55,41 +239,111 @@ class Ranker {
     // if only keywords fitted, returns PredictKeyword; if neither, returns 0.0.
     float PredictBlended(const Article& article) const;
 
-    // Persist the trained model (vocabulary + weights) to a binary file.
-    // Returns true on success.
+    // Persist the trained model (vocabulary + weights) to a binary file,
+    // replacing `path` atomically. Returns true on success.
     bool Save(const std::string& path) const;
 
-    // Load a previously saved model from a binary file.
-    // Returns true on success; leaves the object unchanged on failure.
+    // Load a previously saved model from a binary file. Current files are
+    // checksummed and memory-mapped: W1 is used straight from the mapping
+    // (shared by copies of this Ranker) until training writes to it. Older
+    // formats are still read. Returns true on success; leaves the object
+    // unchanged on failure.
     bool Load(const std::string& path);
 
   private:
+    Hyperparameters m_params;
+    std::size_t Units() const { return static_cast<std::size_t>(m_params.hidden); }
+
+    // Hashed vectoriser: log2 of the column count; 0 for the vocabulary.
+    int m_hash_bits{0};
+    // Input columns: m_params.max_features, or 2^m_hash_bits when hashed.
+    std::size_t m_features{static_cast<std::size_t>(MAX_FEATURES)};
+
     // Vocabulary: term → column index in the feature vector
     std::unordered_map<std::string, int> m_vocab;
-    // IDF weights indexed by vocab column
+    // IDF weights indexed by vocab column; empty when hashed
     std::vector<float> m_idf;
 
-    // Network weights (row-major)
-    std::vector<float> m_W1; // HIDDEN_SIZE × MAX_FEATURES
-    std::vector<float> m_b1; // HIDDEN_SIZE
-    std::vector<float> m_W2; // HIDDEN_SIZE
+    // Network weights. W1 is stored feature-major so each non-zero input
+    // touches one contiguous row of Units() weights. After Load it lives
+    // in m_mapping and m_W1 is empty; read it through W1Data().
+    std::vector<float> m_W1; // m_features × Units()
+    std::vector<float> m_b1; // Units()
+    std::vector<float> m_W2; // Units()
     float m_b2{0.0f};
 
     bool m_trained{false};
 
+    // Quantised W1 (same layout) and per-hidden-unit scales: W1[k][j] is
+    // about m_W1q_scale[j] * m_W1q[k][j]. Empty unless quantised, or when
+    // both are read from m_mapping.
+    std::vector<int8_t> m_W1q;
+    std::vector<float> m_W1q_scale;
+
+    // Read-only mapping of the file W1 was loaded from (see Ranker.cc).
+    struct Mapping;
+    std::shared_ptr<const Mapping> m_mapping;
+    const float* W1Data() const;
+    const int8_t* W1qData() const;
+    const float* W1qScale() const;
+    // Copy a mapped W1 into m_W1 before anything writes to it. Drops the
+    // quantised copy, which would go stale.
+    void OwnWeights();
+    bool LoadMapped(std::shared_ptr<Mapping> map, const std::string& path);
+    // Versions 1 and 2, read through a stream.
+    bool LoadStream(const std::string& path);
+
     // Keyword cold-start
     std::vector<std::string> m_keywords;
+    AhoCorasick m_keyword_matcher; // over m_keywords
     bool m_fit_keywords{false};
 
-    // Text helpers
-    static std::vector<std::string> Tokenise(const std::string& text);
-    static bool IsStopWord(const std::string& word);
+    // Per-thread tokeniser and vector buffers (see Ranker.cc).
+    struct Scratch;
+    static Scratch& ThreadScratch();
+
+    // TF-IDF vectorisation (L2-normalised) into `vec`, replacing its
+    // contents and reusing its capacity.
+    void Vectorise(const Article& article, SparseVector& vec) const;
+    void Vectorise(const TermList& terms, const ColumnMap& columns, SparseVector& vec) const;
+    // Column and sign of a hashed term, from the FNV-1a hash of its text.
+    Column HashedColumn(uint64_t term_hash) const;
+    // Sort by index, sum entries sharing a column (repeated terms, hash
+    // collisions) and drop any that cancel to zero.
+    static void Compact(SparseVector& vec);
+    // L2-normalise, summing in index order.
+    static void Normalise(SparseVector& vec);
+
+    // Keep the m_features most frequent terms of `df` (document
+    // frequency, term) and set their IDF over `n_docs` documents.
+    void BuildVocabulary(std::vector<std::pair<int, std::string>> df, std::size_t n_docs);
+    // SGD over vectorised samples; shared by both Train overloads. With a
+    // validation split this trains twice: once on the rest to find the best
+    // epoch count, then on everything for that many epochs.
+    bool TrainVectors(const std::vector<SparseVector>& X,
+                      const std::vector<float>& y_target,
+                      bool warm_start,
+                      const CancellationToken* cancel,
+                      unsigned max_threads);
+    bool UpdateVectors(const std::vector<SparseVector>& X, const std::vector<float>& y_target);
 
-    // TF-IDF vectorisation
-    std::vector<float> Vectorise(const Article& article) const;
+    // Gradient accumulators for one training worker (see Ranker.cc).
+    struct Gradients;
+    // Add the MSE gradient of sample `x`, times `scale`, to `g`; returns
+    // the squared error.
+    float Backprop(const SparseVector& x, float target, float scale, Gradients& g) const;
+    // Apply one SGD step from `g` and clear it.
+    void Step(Gradients& g);
+    // Batch scoring over `n` samples, `vectorise(i, x)` writing sample i
+    // into x.
+    template <typename VectoriseFn>
+    std::vector<float> PredictEach(std::size_t n, VectoriseFn vectorise, unsigned max_threads) const;
 
     // Forward pass: returns hidden activations and final output
-    float Forward(const std::vector<float>& x, std::vector<float>& hidden_out) const;
+    float Forward(const SparseVector& x, std::vector<float>& hidden_out) const;
+    // Hidden layer: h[0, Units()) = ReLU(W1 * x + b1), from the int8
+    // weights when quantised.
+    void Hidden(const SparseVector& x, float* h) const;
 
     static float ReLU(float v) { return v > 0.0f ? v : 0.0f; }
     // Scale network output (unbounded) → [1.0, 5.0]
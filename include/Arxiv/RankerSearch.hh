@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "Arxiv/Cancellation.hh"
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/Terms.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Arxiv {
+
+// Model selection for the Ranker: a random search over a grid of
+// Ranker::Hyperparameters, each candidate scored by k-fold cross-validation
+// on the ratings. Every (candidate, fold) pair trains its own single-threaded
+// Ranker, and the pairs are spread over the spare cores, so a search costs
+// about TRIALS × FOLDS trainings of wall time divided by the core count.
+//
+// The vectoriser is fitted to the corpus, not to the ratings, so each
+// distinct max_features is fitted once up front and shared by every fold.
+class RankerSearch {
+  public:
+    static constexpr int FOLDS = 5;
+    static constexpr int TRIALS = 12;
+    // Fewer ratings than this and the folds are too small to tell the
+    // candidates apart; Run returns nothing.
+    static constexpr int MIN_RATINGS = 25;
+
+    struct Trial {
+        Ranker::Hyperparameters params;
+        // Mean squared error of the held-out predictions, in stars².
+        float mse = 0.0f;
+    };
+
+    // Fit `ranker`'s vectoriser after SetHyperparameters (a no-op when
+    // hashed), e.g. AppCore::FitVocabulary.
+    using FitFn = std::function<void(Ranker&)>;
+    // Column map for a fitted ranker, e.g. TermCache::Columns.
+    using ColumnsFn = std::function<Ranker::ColumnMap(const Ranker&)>;
+
+    // Candidates for `prototype`'s vectoriser: the defaults first, then up
+    // to `trials` - 1 others drawn from the grid with `seed`. max_features
+    // only varies for the vocabulary vectoriser.
+    explicit RankerSearch(const Ranker& prototype, int trials = TRIALS, uint32_t seed = 42);
+
+    const std::vector<Ranker::Hyperparameters>& Candidates() const { return m_candidates; }
+
+    // Score every candidate on `rated` (term lists with their 1-5 ratings)
+    // using up to `max_threads` workers (0: one less than the core count,
+    // at least one). `fit` and `columns` run on the calling thread only.
+    // Returns the trials best first, ties in candidate order; empty with
+    // fewer than MIN_RATINGS ratings or when `cancel` fires.
+    std::vector<Trial> Run(const std::vector<std::pair<TermList, int>>& rated,
+                           const FitFn& fit,
+                           const ColumnsFn& columns,
+                           const CancellationToken* cancel = nullptr,
+                           unsigned max_threads = 0) const;
+
+  private:
+    int m_hash_bits; // Ranker::HashBits of the prototype
+    std::vector<Ranker::Hyperparameters> m_candidates;
+    uint32_t m_seed;
+};
+
+} // namespace Arxiv
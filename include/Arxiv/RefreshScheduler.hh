@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "Arxiv/Article.hh"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Arxiv {
+
+// Polling cadence for RefreshScheduler.
+struct RefreshPolicy {
+    std::chrono::minutes dense_interval{1};
+    std::chrono::minutes dense_window{30};
+    std::chrono::minutes max_interval{60};
+};
+
+// Decides when the background refresh should next hit the network.
+//
+// arXiv publishes one mailing per weekday evening — Sunday through Thursday
+// at 20:00 US Eastern — and nothing in between, so polling on a fixed clock
+// is almost always wasted. The scheduler polls at that time, then every
+// `dense_interval` for `dense_window` until a poll stores something, then
+// backs off exponentially (capped at `max_interval`) while the mailing is
+// late. Once a mailing has been seen it sleeps until the next one.
+// Holidays (Eastern dates on which arXiv skips the mailing) come from the
+// config.
+//
+// Not thread-safe; AppCore guards it with its refresh mutex.
+class RefreshScheduler {
+  public:
+    // Mailing time as minutes after local midnight, US Eastern.
+    static constexpr int ANNOUNCE_MINUTE_ET = 20 * 60;
+
+    // `holidays` are "YYYY-MM-DD" Eastern dates; malformed entries are
+    // logged and ignored.
+    explicit RefreshScheduler(RefreshPolicy policy = {},
+                              const std::vector<std::string>& holidays = {});
+
+    // --- Calendar ---------------------------------------------------------
+
+    // UTC offset of US Eastern at `t`: -4 h under daylight time (second
+    // Sunday of March to first Sunday of November, 02:00 local), else -5 h.
+    static std::chrono::seconds EasternOffset(time_point t);
+    // The instant `minute_of_day` minutes after midnight Eastern on y-m-d.
+    static time_point FromEastern(int y, int m, int d, int minute_of_day);
+
+    bool IsMailingDay(int y, int m, int d) const;
+    // Latest expected mailing at or before `t`, and the first one after it.
+    time_point LastMailing(time_point t) const;
+    time_point NextMailing(time_point t) const;
+
+    // --- Polling ----------------------------------------------------------
+
+    // When the next poll is due. The epoch until the first RecordPoll, i.e.
+    // "now".
+    time_point NextDue() const { return m_next_due; }
+
+    // Record a poll made at `now` that stored `added` articles, and schedule
+    // the next one.
+    void RecordPoll(time_point now, std::size_t added);
+
+    // Compact text form of the polling state for DB metadata, so a restart
+    // keeps its backoff and knows which mailing it has already seen.
+    std::string Serialise() const;
+    // Restore from Serialise(); ignores empty or malformed input.
+    void Restore(const std::string& state);
+
+  private:
+    bool IsMailingDay(int64_t eastern_day) const;
+
+    RefreshPolicy m_policy;
+    std::set<int64_t> m_holidays; // days since 1970-01-01, Eastern
+    time_point m_last_seen{};     // expected time of the newest mailing seen
+    int m_misses = 0;             // empty polls since the dense window closed
+    time_point m_next_due{};
+};
+
+} // namespace Arxiv
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Arxiv {
+namespace Simd {
+
+// Float kernels behind the Ranker's inner loops, compiled for several x86
+// instruction sets and picked at runtime from what the CPU reports, so a
+// generic x86-64 build still uses AVX2/FMA or AVX-512 where available. Other
+// architectures get the scalar versions (which the compiler may still
+// auto-vectorise for the baseline target).
+//
+// Vector variants reorder the additions in Dot and fuse multiply-adds, so
+// results match the scalar reference to rounding, not bit for bit. The int8
+// kernel is exact at every level.
+
+enum class Level { Scalar, SSE2, AVX2, AVX512 };
+
+using AxpyFn = void (*)(std::size_t n, float a, const float* x, float* y);
+using DotFn = float (*)(std::size_t n, const float* x, const float* y);
+using AxpyI8Fn = void (*)(std::size_t n, int8_t a, const int8_t* x, int32_t* y);
+
+struct Kernels {
+    Level level;
+    const char* name;
+    AxpyFn axpy; // y[i] += a * x[i]
+    DotFn dot;   // sum of x[i] * y[i]
+    // y[i] += a * x[i] widened to int32; a and x[i] must lie in
+    // [-127, 127], as symmetric quantisation guarantees.
+    AxpyI8Fn axpy_i8;
+};
+
+// Highest level this CPU (and OS) supports. Cached after the first call.
+Level Detect();
+
+// Kernels for `level`, falling back to the best supported level at or
+// below it.
+const Kernels& For(Level level);
+
+// Kernels for Detect(). The environment variable ARXIV_TUI_SIMD
+// ("scalar", "sse2", "avx2", "avx512") caps the level, e.g. to rule the
+// vector paths out when debugging.
+const Kernels& Active();
+
+inline void Axpy(std::size_t n, float a, const float* x, float* y) { Active().axpy(n, a, x, y); }
+inline float Dot(std::size_t n, const float* x, const float* y) { return Active().dot(n, x, y); }
+inline void AxpyI8(std::size_t n, int8_t a, const int8_t* x, int32_t* y) {
+    Active().axpy_i8(n, a, x, y);
+}
+
+} // namespace Simd
+} // namespace Arxiv
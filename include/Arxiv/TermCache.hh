@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "Arxiv/Article.hh"
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/Terms.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Arxiv {
+
+class DatabaseManager;
+
+// Tokenised article text shared by ranker training and scoring, so an
+// article goes through the Tokeniser once rather than on every retrain and
+// view. Lists are persisted in the database (see
+// DatabaseManager::StoreTerms), keyed by link and content hash, and read
+// back on demand; the CAPACITY most recently used stay in memory. An
+// article whose content changes is re-tokenised. The dictionary is loaded
+// on first use, not at construction. The database keeps document
+// frequencies over the persisted lists as they are stored and dropped.
+// Term ids are handed out by the database, which the daemon and the TUI
+// may share: terms another process stored are read in before its rows are
+// used, and a list whose new terms lost the race for their ids is rebuilt.
+// Everything persisted is dropped when Ranker::TokeniserHash() (for this
+// cache's bigram setting) no longer matches the one stored in metadata.
+// Thread-safe.
+class TermCache {
+  public:
+    // Term lists held in memory when backed by a database: about 13 MB at a
+    // hundred terms each.
+    static constexpr std::size_t CAPACITY = 16384;
+
+    // Reads persisted lists from `db` as they are needed; nullptr keeps
+    // every list in memory. `bigrams` is passed to Ranker::Terms: set it
+    // for a hashed ranker. Lists persisted the other way are dropped.
+    explicit TermCache(DatabaseManager* db = nullptr,
+                       bool bigrams = false,
+                       std::size_t capacity = CAPACITY);
+
+    TermCache(const TermCache&) = delete;
+    TermCache& operator=(const TermCache&) = delete;
+
+    // Tokenise and persist any of `articles` not cached yet, e.g. at ingest.
+    void Add(const std::vector<Article>& articles);
+    // Forget `links` once they are deleted or pruned; the database drops
+    // their persisted lists itself.
+    void Remove(const std::vector<std::string>& links);
+    // Term lists for `articles`, in order. Articles not cached yet are
+    // tokenised now and persisted.
+    std::vector<TermList> Get(const std::vector<Article>& articles);
+    // Get() without copying: the lists are shared with the cache, and stay
+    // valid after they are evicted or replaced. Allocates nothing per
+    // article already cached, so scoring a view reads the lists in place.
+    std::vector<SharedTermList> GetShared(const std::vector<Article>& articles);
+    // Get() for the articles of `rated`, paired with their ratings.
+    std::vector<std::pair<TermList, int>> Get(const std::vector<std::pair<Article, int>>& rated);
+
+    // Tokenise and persist every article in the database without an
+    // up-to-date term list, so the document-frequency table
+    // (DatabaseManager::GetTopTerms) covers the whole corpus. A no-op
+    // without a database; errors are logged.
+    void Backfill();
+
+    // Copy of the dictionary; covers every id returned so far, so call it
+    // (and Columns) only after the Get() whose lists it must cover.
+    TermDictionary Dictionary();
+
+    // `ranker`'s column map over the dictionary. Rebuilt only when the
+    // ranker's VocabularyHash() differs from the last call's, and otherwise
+    // just extended over terms interned since.
+    Ranker::ColumnMap Columns(const Ranker& ranker);
+
+    // Lists stored in the database, or held in memory without one.
+    std::size_t Size() const;
+    // Call `fn(link, terms)` for every list. With a database the lists are
+    // streamed from it without holding the cache's lock, so lists stored
+    // meanwhile may be missed; without one the lock is held throughout and
+    // `fn` must not call back into the cache.
+    void ForEach(const std::function<void(const std::string&, const TermList&)>& fn);
+
+    // Metadata key holding the TokeniserHash the stored lists were built with.
+    static constexpr const char* TOKENISER_KEY = "term_cache_tokeniser";
+
+  private:
+    struct Entry {
+        uint64_t content_hash;
+        SharedTermList terms;
+        std::list<std::string>::iterator recent; // position in m_recent
+    };
+
+    // Term lists for `articles`, into `lists` (in order) unless it is null:
+    // from memory, else from the database when stored for the same content,
+    // else tokenised and persisted. Caller holds m_mutex.
+    void Fill(const std::vector<const Article*>& articles, std::vector<SharedTermList>* lists);
+    // One attempt at Fill. Returns false, having undone the lists it built
+    // and the terms it interned, if another process stored terms first.
+    bool TryFill(const std::vector<const Article*>& articles, std::vector<SharedTermList>* lists);
+    // Cache `terms` for `link` as the most recently used, dropping the least
+    // recently used beyond m_capacity. Caller holds m_mutex.
+    void Insert(const std::string& link, uint64_t content_hash, SharedTermList terms);
+    void Erase(const std::string& link);
+    // Read the persisted dictionary, once. On failure the cache carries on
+    // without the database. Caller holds m_mutex.
+    void LoadDictionary();
+    // Read in the terms stored since by another process sharing the
+    // database. On failure the cache carries on without it. Caller holds
+    // m_mutex.
+    void SyncDictionary();
+    // Carry on in memory only, keeping what is cached.
+    void Detach();
+
+    // Fill attempts before giving up on the database.
+    static constexpr int STORE_ATTEMPTS = 3;
+
+    DatabaseManager* m_db;
+    bool m_bigrams;
+    std::size_t m_capacity;
+    mutable std::mutex m_mutex;
+    bool m_dict_loaded = false;
+    TermDictionary m_dict;
+    std::size_t m_stored_terms = 0; // dictionary ids already in the DB
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_recent; // links in m_entries, most recent first
+
+    uint64_t m_columns_vocab = 0;
+    Ranker::ColumnMap m_columns;
+};
+
+} // namespace Arxiv
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Arxiv {
+
+// One term of an article's tokenised text: an id into a TermDictionary and
+// the term's weighted frequency (see Ranker::Terms).
+struct TermCount {
+    uint32_t term;
+    uint32_t count;
+};
+
+// An article's tokenised text, one entry per distinct term, sorted by id.
+using TermList = std::vector<TermCount>;
+// A TermList shared with the cache that holds it, so scoring reads it
+// without a copy.
+using SharedTermList = std::shared_ptr<const TermList>;
+
+// Interned token strings with dense ids handed out in first-seen order. Ids
+// never change once assigned, so TermLists stay valid as the dictionary
+// grows. Not thread-safe.
+class TermDictionary {
+  public:
+    uint32_t Intern(const std::string& term) {
+        auto [it, inserted] = m_ids.emplace(term, static_cast<uint32_t>(m_terms.size()));
+        if (inserted)
+            m_terms.push_back(term);
+        return it->second;
+    }
+
+    // Id of `term`, or -1 if it was never interned.
+    int64_t Find(const std::string& term) const {
+        auto it = m_ids.find(term);
+        return it == m_ids.end() ? int64_t{-1} : int64_t{it->second};
+    }
+
+    const std::string& Term(uint32_t id) const { return m_terms[id]; }
+    std::size_t Size() const { return m_terms.size(); }
+
+    // Forget every id from `size` on.
+    void Truncate(std::size_t size) {
+        while (m_terms.size() > size) {
+            m_ids.erase(m_terms.back());
+            m_terms.pop_back();
+        }
+    }
+
+  private:
+    std::unordered_map<std::string, uint32_t> m_ids;
+    std::vector<std::string> m_terms;
+};
+
+// ---------------------------------------------------------------------------
+// Blob format for persisted TermLists: one record per TermCount, each a
+// little-endian uint32 id followed by a uint32 count.
+// ---------------------------------------------------------------------------
+
+inline std::string PackTerms(const TermList& terms) {
+    auto put_u32 = [](std::string& out, uint32_t v) {
+        for (int shift = 0; shift < 32; shift += 8)
+            out.push_back(static_cast<char>((v >> shift) & 0xffu));
+    };
+    std::string out;
+    out.reserve(terms.size() * 8);
+    for (const auto& t : terms) {
+        put_u32(out, t.term);
+        put_u32(out, t.count);
+    }
+    return out;
+}
+
+// Inverse of PackTerms. False for a truncated blob or an id >= dict_size.
+inline bool UnpackTerms(const std::string& blob, std::size_t dict_size, TermList& terms) {
+    auto get_u32 = [](const char* p) {
+        uint32_t v = 0;
+        for (int i = 3; i >= 0; --i)
+            v = (v << 8) | static_cast<unsigned char>(p[i]);
+        return v;
+    };
+    if (blob.size() % 8 != 0)
+        return false;
+    terms.clear();
+    terms.reserve(blob.size() / 8);
+    for (std::size_t pos = 0; pos < blob.size(); pos += 8) {
+        const TermCount t{get_u32(blob.data() + pos), get_u32(blob.data() + pos + 4)};
+        if (t.term >= dict_size)
+            return false;
+        terms.push_back(t);
+    }
+    return true;
+}
+
+} // namespace Arxiv
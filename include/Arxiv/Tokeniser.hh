@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Arxiv {
+
+// Splits text into the terms the ranker works with: LaTeX is stripped, runs
+// of ASCII letters and digits are lower-cased, and runs of one or two
+// characters or on the stop-word list are dropped.
+//
+// Tokens are views into a buffer owned by the Tokeniser and are valid until
+// the next call. The buffer and the token list keep their capacity, so once
+// they have grown to fit the longest text seen, tokenising does not touch
+// the heap. Not thread-safe; keep one per thread.
+class Tokeniser {
+  public:
+    const std::vector<std::string_view>& operator()(std::string_view text);
+
+    // Constant-time lookup in a perfect hash table built at compile time.
+    static bool IsStopWord(std::string_view word);
+
+    // Identifies the token rules and stop-word list. Changes whenever either
+    // does, so anything persisted from tokens can be invalidated.
+    static uint64_t Fingerprint();
+
+  private:
+    std::string m_buffer;
+    std::vector<std::string_view> m_tokens;
+};
+
+} // namespace Arxiv
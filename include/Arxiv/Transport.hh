@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "Arxiv/Cancellation.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace Arxiv {
+
+struct HttpResponse {
+    long status_code = 0; // 0 when the request never got a response
+    std::string text;
+};
+
+// HTTP transport behind Fetcher. All network access goes through Get, so the
+// fetch → parse → insert pipeline can run against recorded data.
+// Implementations must be safe to call from several threads at once
+// (FetchBibTeXBatch issues concurrent requests).
+class Transport {
+  public:
+    virtual ~Transport() = default;
+
+    // Blocking GET. A zero timeout means no timeout. Once `cancel` fires the
+    // request is abandoned and answered with status 0.
+    HttpResponse Get(const std::string& url,
+                     std::chrono::milliseconds timeout = std::chrono::milliseconds{0},
+                     const CancellationToken* cancel = nullptr) {
+        if (CancellationToken::IsCancelled(cancel))
+            return {};
+        return Perform(url, timeout, cancel);
+    }
+
+  protected:
+    virtual HttpResponse Perform(const std::string& url,
+                                 std::chrono::milliseconds timeout,
+                                 const CancellationToken* cancel) = 0;
+};
+
+// Production backend: libcurl via cpr. Cancellation is checked from curl's
+// progress callback, which curl calls many times a second while data flows
+// and about once a second on a stalled connection.
+class CprTransport : public Transport {
+  protected:
+    HttpResponse Perform(const std::string& url,
+                         std::chrono::milliseconds timeout,
+                         const CancellationToken* cancel) override;
+};
+
+// Offline backend: serves recorded responses (RSS, Atom, PDF, InspireHEP
+// JSON/BibTeX) from a directory, optionally sleeping before each reply to
+// model network latency. The sleep ends early on cancellation.
+//
+// A URL maps to a file under the root as follows: the scheme is dropped and
+// host + path become the relative path ("https://arxiv.org/pdf/2403.15001" →
+// "arxiv.org/pdf/2403.15001"). If the URL has a query string, the file
+// "<host/path>@<16 hex digits of FNV-1a(query)>" is tried first, then the
+// query-less path, so one recording can answer every query for an endpoint.
+// Missing files are answered with 404.
+class FixtureTransport : public Transport {
+  public:
+    explicit FixtureTransport(std::filesystem::path root,
+                              std::chrono::milliseconds latency = std::chrono::milliseconds{0});
+
+    // Safe while requests are in flight; each one reads it once.
+    void SetLatency(std::chrono::milliseconds latency) { m_latency.store(latency); }
+    std::size_t RequestCount() const { return m_requests.load(); }
+
+    // Relative fixture path for `url`, including the query suffix if any.
+    // Use this to name files when recording.
+    static std::filesystem::path KeyFor(const std::string& url);
+
+  protected:
+    HttpResponse Perform(const std::string& url,
+                         std::chrono::milliseconds timeout,
+                         const CancellationToken* cancel) override;
+
+  private:
+    std::filesystem::path m_root;
+    std::atomic<std::chrono::milliseconds> m_latency;
+    std::atomic<std::size_t> m_requests{0};
+};
+
+} // namespace Arxiv
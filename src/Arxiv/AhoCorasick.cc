@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/AhoCorasick.hh"
+
+#include <algorithm>
+
+namespace Arxiv {
+
+namespace {
+
+constexpr unsigned char fold(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + 32) : c;
+}
+
+} // namespace
+
+AhoCorasick::AhoCorasick(const std::vector<std::string>& patterns)
+    : m_patterns(patterns.size()) {
+    // Columns: one per distinct folded byte, upper and lower case together.
+    for (const auto& pattern : patterns) {
+        for (char ch : pattern) {
+            const unsigned char c = fold(static_cast<unsigned char>(ch));
+            if (m_class[c] != 0)
+                continue;
+            m_class[c] = static_cast<uint16_t>(m_classes++);
+            if (c >= 'a' && c <= 'z')
+                m_class[c - 32] = m_class[c];
+        }
+    }
+
+    // The trie, with NONE for missing edges. State 0 is the root.
+    m_next.assign(m_classes, NONE);
+    m_first.assign(1, NONE);
+    m_same.assign(patterns.size(), NONE);
+    bool any = false;
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        if (patterns[id].empty())
+            continue;
+        uint32_t state = 0;
+        for (char ch : patterns[id]) {
+            uint32_t& edge = m_next[state * m_classes + m_class[static_cast<unsigned char>(ch)]];
+            if (edge == NONE) {
+                edge = static_cast<uint32_t>(m_first.size());
+                m_first.push_back(NONE);
+                m_next.resize(m_next.size() + m_classes, NONE);
+            }
+            // Re-read: the resize may have moved the table.
+            state = m_next[state * m_classes + m_class[static_cast<unsigned char>(ch)]];
+        }
+        // Chain duplicates, keeping ids ascending.
+        uint32_t* slot = &m_first[state];
+        while (*slot != NONE)
+            slot = &m_same[*slot];
+        *slot = static_cast<uint32_t>(id);
+        any = true;
+    }
+    if (!any) {
+        m_next.clear();
+        m_first.clear();
+        return;
+    }
+
+    // Breadth-first, so a state's failure target is finished before the
+    // state: fill each missing edge with the failure target's edge.
+    const size_t states = m_first.size();
+    m_fail.assign(states, 0);
+    m_output.assign(states, NONE);
+    std::vector<uint32_t> queue;
+    queue.reserve(states);
+    for (size_t c = 0; c < m_classes; ++c) {
+        uint32_t& edge = m_next[c];
+        if (edge == NONE) {
+            edge = 0;
+        } else {
+            queue.push_back(edge);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t state = queue[head];
+        const uint32_t fail = m_fail[state];
+        m_output[state] = m_first[state] != NONE ? state : m_output[fail];
+        for (size_t c = 0; c < m_classes; ++c) {
+            uint32_t& edge = m_next[state * m_classes + c];
+            const uint32_t fallback = m_next[fail * m_classes + c];
+            if (edge == NONE) {
+                edge = fallback;
+            } else {
+                m_fail[edge] = fallback;
+                queue.push_back(edge);
+            }
+        }
+    }
+}
+
+bool AhoCorasick::Matches(std::string_view text) const {
+    if (m_output.empty())
+        return false;
+    uint32_t state = 0;
+    for (char c : text) {
+        state = m_next[state * m_classes + m_class[static_cast<unsigned char>(c)]];
+        if (m_output[state] != NONE)
+            return true;
+    }
+    return false;
+}
+
+size_t AhoCorasick::CountDistinct(std::string_view text, std::vector<uint8_t>& seen) const {
+    seen.assign(m_patterns, 0);
+    size_t distinct = 0;
+    ForEachMatch(text, [&](size_t id, size_t) {
+        if (!seen[id]) {
+            seen[id] = 1;
+            ++distinct;
+        }
+    });
+    return distinct;
+}
+
+} // namespace Arxiv
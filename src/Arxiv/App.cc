@@ -5,6 +5,7 @@
 #include "Arxiv/App.hh"
 
 #include "Arxiv/Article.hh"
+#include "Arxiv/Daemon.hh"
 
 #include "spdlog/spdlog.h"
 
@@ -14,7 +15,7 @@ using namespace Arxiv;
 ArxivApp::ArxivApp(const Config& config, const std::string& config_path, ReplayRecorder* recorder)
     : core(config,
            std::make_unique<DatabaseManager>(config.get_db_file()),
-           std::make_unique<Fetcher>(config.get_topics(), config.get_download_dir()),
+           MakeFetcher(config),
            AppCore::FetchMode::Async,
            recorder)
     , key_bindings(config.get_key_mappings())
@@ -27,6 +28,8 @@ ArxivApp::ArxivApp(const Config& config, const std::string& config_path, ReplayR
     if (m_recorder)
         m_recorder->RecordEvent("app/ctor_after_appcore");
     core.ReloadKeywords();
+    if (config.get_auto_refresh_minutes() > 0)
+        core.StartAutoRefresh();
     if (m_recorder)
         m_recorder->RecordEvent("app/setup_ui_begin");
     SetupUI();
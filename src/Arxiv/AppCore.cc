@@ -4,7 +4,9 @@
 
 #include "Arxiv/AppCore.hh"
 
+#include "Arxiv/Daemon.hh"
 #include "Arxiv/FuzzyMatch.hh"
+#include "Arxiv/RankerSearch.hh"
 #include "Arxiv/Replay.hh"
 
 #include <nlohmann/json.hpp>
@@ -16,6 +18,7 @@
 #include <fstream>
 #include <functional>
 #include <map>
+#include <random>
 #include <string_view>
 
 #include "fmt/format.h"
@@ -23,6 +26,11 @@
 
 namespace Arxiv {
 
+// Earlier ratings kept by the online-update thread, and how many of them are
+// replayed alongside each new batch.
+static constexpr std::size_t REPLAY_CAPACITY = 256;
+static constexpr std::size_t REPLAY_SAMPLE = 15;
+
 static std::string today_utc_string() {
     auto now = std::chrono::system_clock::now();
     std::time_t t = std::chrono::system_clock::to_time_t(now);
@@ -33,6 +41,51 @@ static std::string today_utc_string() {
     return buf;
 }
 
+// Articles a fetch stored. A DaemonFetcher returns nothing because the daemon
+// stored them itself; it reports the count separately.
+static std::size_t stored_count(const Fetcher& fetcher, const std::vector<Article>& articles) {
+    if (const auto* remote = dynamic_cast<const DaemonFetcher*>(&fetcher))
+        return remote->LastFetchedCount();
+    return articles.size();
+}
+
+// Modification time of `path`, or the epoch when it cannot be read.
+static std::filesystem::file_time_type modified(const std::string& path) {
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? std::filesystem::file_time_type{} : time;
+}
+
+// Run `op` on the daemon behind `remote`, connecting `client` first if
+// needed. False, after logging why, when it is unreachable or fails.
+static bool call_daemon(std::unique_ptr<DaemonClient>& client,
+                        const DaemonFetcher& remote,
+                        const std::string& op,
+                        const nlohmann::json& params = nlohmann::json::object()) {
+    try {
+        if (!client)
+            client = DaemonClient::Connect(remote.SocketPath());
+        if (!client) {
+            spdlog::warn("[AppCore]: No daemon at {} to {}", remote.SocketPath(), op);
+            return false;
+        }
+        client->Call(op, params);
+        return true;
+    } catch (const std::exception& e) {
+        spdlog::warn("[AppCore]: Daemon {} failed: {}", op, e.what());
+        client.reset();
+        return false;
+    }
+}
+
+// The related-papers index lives beside the ranker: ranker.bin → ranker.related.bin.
+static std::string related_index_path(const std::string& ranker_path) {
+    std::filesystem::path path(ranker_path);
+    const std::string extension = path.extension().string();
+    path.replace_extension(".related" + extension);
+    return path.string();
+}
+
 AppCore::AppCore(const Config& config,
                  std::unique_ptr<DatabaseManager> db,
                  std::unique_ptr<Fetcher> fetcher,
@@ -42,10 +95,21 @@ AppCore::AppCore(const Config& config,
     , m_topics(config.get_topics())
     , m_db(std::move(db))
     , m_fetcher(std::move(fetcher))
+    , m_term_cache(m_db.get(), config.get_ranker_hash_bits() > 0)
     , m_retrain_interval(config.get_retrain_interval())
     , m_recommend_threshold(config.get_recommend_threshold())
     , m_ranker_path(config.get_ranker_file())
+    , m_ranker_hash_bits(config.get_ranker_hash_bits())
+    , m_ranker_quantise(config.get_ranker_quantise())
+    , m_ranker_search(config.get_ranker_search())
+    , m_related_path(related_index_path(m_ranker_path))
     , m_auto_refresh_minutes(config.get_auto_refresh_minutes())
+    , m_refresh_schedule(
+          RefreshPolicy{std::chrono::minutes{1},
+                        std::chrono::minutes{30},
+                        std::chrono::minutes{m_auto_refresh_minutes > 0 ? m_auto_refresh_minutes
+                                                                        : 60}},
+          config.get_announcement_holidays())
     , m_recorder(recorder) {
     m_undo_capacity = config.get_undo_buffer_size();
     m_undo_buffer.resize(m_undo_capacity);
@@ -58,6 +122,15 @@ AppCore::AppCore(const Config& config,
     // dialog.
     m_active_categories.insert(m_topics.begin(), m_topics.end());
 
+    // Let the fetcher drop feed items already stored unchanged before any
+    // LaTeX conversion or Article construction; AddArticles then only sees
+    // new or revised items.
+    m_fetcher->SetKnownItemFilter([db = m_db.get()](const std::string& link, uint64_t hash) {
+        return db->IsKnownArticle(link, hash);
+    });
+    m_fetcher->SetCancellationToken(&m_cancel);
+    m_daemon = dynamic_cast<const DaemonFetcher*>(m_fetcher.get());
+
     const std::string today = today_utc_string();
     const std::string prev_fetch = m_db->GetMetadata("last_fetch_date");
     std::string anchor = m_db->GetMetadata("new_articles_anchor");
@@ -72,14 +145,18 @@ AppCore::AppCore(const Config& config,
     }
     m_new_articles_since_date = anchor;
     m_db->SetMetadata("last_fetch_date", today);
+    m_refresh_schedule.Restore(m_db->GetMetadata("refresh_schedule"));
 
     if (m_recorder)
         m_recorder->RecordEvent("appcore/metadata_loaded",
                                 "prev_fetch=" + prev_fetch + " anchor=" + anchor);
 
-    // Prune old articles before showing the list.
+    // Prune old articles before showing the list, and from the saved
+    // related index.
+    m_related_saved = modified(m_related_path);
+    m_related.Load(m_related_path);
     if (m_config.get_max_article_age_days() > 0)
-        m_db->PruneArticles(m_config.get_max_article_age_days());
+        ForgetArticles(m_db->PruneArticles(m_config.get_max_article_age_days()));
 
     // Show whatever is already in the local DB immediately.
     RefreshFilterOptions();
@@ -88,19 +165,41 @@ AppCore::AppCore(const Config& config,
         m_recorder->RecordEvent("appcore/initial_fetcharticles_done",
                                 "count=" + std::to_string(m_current_articles.size()));
 
-    // Try to restore a previously saved model; fall back to training if absent.
-    if (!m_ranker.Load(m_ranker_path)) {
-        auto all_articles = m_db->GetRecent(-1);
-        auto rated = m_db->GetRatedArticles();
-        if (!rated.empty()) {
-            m_ranker.FitVocabulary(all_articles);
-            m_ranker.Train(rated);
-            m_ranker.Save(m_ranker_path);
-        }
+    // Try to restore a previously saved model. Without one, fitting the
+    // vectoriser (for the Related view) and training on any ratings is a
+    // cold retrain, run on the training thread; an index that lags the model
+    // is rebuilt there too. Either way IsRelatedBuilding() is true meanwhile.
+    auto ranker = std::make_shared<Ranker>();
+    m_ranker_saved = modified(m_ranker_path);
+    bool loaded = ranker->Load(m_ranker_path);
+    if (loaded && ranker->IsHashed() != (m_ranker_hash_bits > 0)) {
+        // The term cache follows the configured vectoriser (bigrams are
+        // kept for the hashed one only), so a model saved under the other
+        // one is retrained.
+        spdlog::info("[AppCore]: Saved model uses the other vectoriser; retraining");
+        loaded = false;
+    }
+    if (!loaded)
+        *ranker = Ranker{m_ranker_hash_bits};
+    Publish(std::move(ranker));
+    // An attached daemon trains and indexes instead; TryRefetchIfNeeded
+    // picks up what it saves.
+    if (!m_daemon && !loaded) {
+        SpawnTrainingThread(/*warm_start=*/false);
+    } else if (!m_daemon && IsRelatedBuilding()) {
+        m_train_thread = std::thread([this]() {
+            RebuildRelated(*Model());
+            m_needs_refetch = true;
+            NotifyArticleUpdate();
+        });
     }
+    // Sync callers expect the model and index ready when the constructor
+    // returns.
+    if (fetch_mode == FetchMode::Sync && m_train_thread.joinable())
+        m_train_thread.join();
     if (m_recorder)
         m_recorder->RecordEvent("appcore/ranker_loaded",
-                                std::string("trained=") + (m_ranker.IsTrained() ? "1" : "0"));
+                                std::string("trained=") + (IsRankerTrained() ? "1" : "0"));
 
     // Network fetch. In Async mode it runs on a background thread so the TUI
     // launches immediately; IsFetching() reports its state. In Sync mode
@@ -118,7 +217,8 @@ AppCore::AppCore(const Config& config,
                 "appcore/bg_fetch_begin",
                 "mode=" + std::string(fetch_mode == FetchMode::Async ? "async" : "sync"));
         std::vector<Article> articles;
-        if (!prev_fetch.empty() && prev_fetch < today) {
+        const bool backfill = !prev_fetch.empty() && prev_fetch < today;
+        if (backfill) {
             // Day-boundary crossing: backfill the days we were away. FetchSince
             // also folds in today's announcement, so this single call covers
             // backfill + today — no separate Fetch() needed.
@@ -136,9 +236,15 @@ AppCore::AppCore(const Config& config,
         if (m_recorder)
             m_recorder->RecordEvent("appcore/bg_db_insert_begin");
         m_db->AddArticles(articles);
+        IndexFetched(articles);
         if (m_recorder)
             m_recorder->RecordEvent("appcore/bg_db_insert_end");
 
+        // Shut down mid-backfill: the pages already fetched are stored, but
+        // rewind the fetch date so the next launch covers the rest.
+        if (backfill && m_cancel.IsCancelled())
+            m_db->SetMetadata("last_fetch_date", prev_fetch);
+
         if (fetch_mode == FetchMode::Sync) {
             // Sync callers expect m_current_articles to reflect the fetch
             // immediately after the constructor returns.
@@ -147,6 +253,10 @@ AppCore::AppCore(const Config& config,
             // UI thread will pick this up via TryRefetchIfNeeded.
             m_needs_refetch.store(true);
         }
+        // Before clearing m_fetching, so the refresh thread never sees the
+        // fetch finished without its result in the schedule.
+        if (!m_cancel.IsCancelled())
+            RecordRefresh(stored_count(*m_fetcher, articles));
         m_fetching.store(false);
         if (m_recorder)
             m_recorder->RecordEvent("appcore/bg_fetch_done");
@@ -168,22 +278,73 @@ AppCore::~AppCore() {
     if (m_recorder)
         m_recorder->RecordEvent("appcore/dtor_begin",
                                 std::string("fetching=") + (m_fetching.load() ? "1" : "0"));
+    CancelBackgroundWork();
     StopAutoRefresh();
     WaitForInitialFetch();
+    if (m_online_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_online_mutex);
+            m_online_stop = true;
+        }
+        m_online_cv.notify_all();
+        m_online_thread.join();
+    }
     // Ensure the background training thread has finished before destruction.
     if (m_train_thread.joinable()) {
         m_train_thread.join();
     }
+    // Keep online updates since the last retrain for the next session.
+    if (m_online_unsaved)
+        Model()->Save(m_ranker_path);
     if (m_recorder)
         m_recorder->RecordEvent("appcore/dtor_end");
 }
 
+void AppCore::CancelBackgroundWork() {
+    spdlog::info("[AppCore]: Cancelling background work");
+    m_cancel.Cancel();
+}
+
 void AppCore::WaitForInitialFetch() {
     if (m_initial_fetch_thread.joinable()) {
         m_initial_fetch_thread.join();
     }
 }
 
+std::size_t AppCore::FetchFromNetwork(const std::string& since_utc_date) {
+    std::vector<Article> articles;
+    try {
+        articles =
+            since_utc_date.empty() ? m_fetcher->Fetch() : m_fetcher->FetchSince(since_utc_date);
+    } catch (...) {
+        // A failed poll still counts, so the scheduler backs off.
+        RecordRefresh(0);
+        throw;
+    }
+    m_db->AddArticles(articles);
+    IndexFetched(articles);
+    m_needs_refetch.store(true);
+    const std::size_t stored = stored_count(*m_fetcher, articles);
+    spdlog::info("[AppCore]: Network fetch stored {} article(s)", stored);
+    if (!m_cancel.IsCancelled())
+        RecordRefresh(stored);
+    return stored;
+}
+
+void AppCore::RecordRefresh(std::size_t added) {
+    {
+        std::lock_guard<std::mutex> lock(m_refresh_mutex);
+        m_refresh_schedule.RecordPoll(std::chrono::system_clock::now(), added);
+        m_db->SetMetadata("refresh_schedule", m_refresh_schedule.Serialise());
+    }
+    m_refresh_cv.notify_all();
+}
+
+time_point AppCore::NextRefreshDue() const {
+    std::lock_guard<std::mutex> lock(m_refresh_mutex);
+    return m_refresh_schedule.NextDue();
+}
+
 void AppCore::ToggleCategory(const std::string& cat) {
     if (m_active_categories.count(cat))
         m_active_categories.erase(cat);
@@ -202,6 +363,7 @@ void AppCore::FetchArticles() {
         m_recorder->RecordEvent("appcore/fetcharticles_begin",
                                 "view=" + std::to_string(static_cast<int>(GetFilterView())));
     m_current_articles.clear();
+    m_current_scores.clear();
 
     switch (GetFilterView()) {
     case FilterView::All:
@@ -234,19 +396,14 @@ void AppCore::FetchArticles() {
         break;
     case FilterView::Recommended: {
         auto today_articles = m_db->GetRecent(1);
-        if (m_ranker.IsTrained()) {
-            std::vector<std::pair<float, Article>> scored;
-            scored.reserve(today_articles.size());
-            for (const auto& a : today_articles) {
-                float score = m_ranker.Predict(a);
-                if (score >= m_recommend_threshold)
-                    scored.emplace_back(score, a);
+        const auto scores = GetPredictedScores(today_articles);
+        if (!scores.empty()) {
+            for (size_t i : Ranker::TopK(scores, scores.size())) {
+                if (scores[i] < m_recommend_threshold)
+                    break;
+                m_current_articles.push_back(std::move(today_articles[i]));
+                m_current_scores.push_back(scores[i]);
             }
-            std::sort(scored.begin(), scored.end(), [](const auto& lhs, const auto& rhs) {
-                return lhs.first > rhs.first;
-            });
-            for (auto& [score, article] : scored)
-                m_current_articles.push_back(std::move(article));
         } else {
             m_current_articles = today_articles;
         }
@@ -293,30 +450,32 @@ void AppCore::FetchArticles() {
                                  m_current_articles.end());
         // If a trained ranker is available, surface the most relevant new
         // articles first. No threshold is applied — the user wants to see
-        // *every* new paper, just in priority order. Predict is called
-        // exactly once per article (cached side-vector) to keep the sort
-        // O(N log N) on the comparisons.
-        if (m_ranker.IsTrained() && m_current_articles.size() > 1) {
-            std::vector<std::pair<float, Article>> scored;
-            scored.reserve(m_current_articles.size());
-            {
-                std::lock_guard<std::mutex> lock(m_ranker_mutex);
-                for (auto& a : m_current_articles) {
-                    scored.emplace_back(m_ranker.Predict(a), std::move(a));
+        // *every* new paper, just in priority order. The whole view is
+        // scored in one PredictBatch call and sorted by index.
+        if (m_current_articles.size() > 1) {
+            const auto scores = GetPredictedScores(m_current_articles);
+            if (!scores.empty()) {
+                std::vector<Article> ranked;
+                ranked.reserve(m_current_articles.size());
+                m_current_scores.reserve(scores.size());
+                for (size_t i : Ranker::TopK(scores, scores.size())) {
+                    ranked.push_back(std::move(m_current_articles[i]));
+                    m_current_scores.push_back(scores[i]);
                 }
+                m_current_articles = std::move(ranked);
             }
-            std::sort(scored.begin(), scored.end(), [](const auto& l, const auto& r) {
-                return l.first > r.first;
-            });
-            m_current_articles.clear();
-            for (auto& [s, a] : scored)
-                m_current_articles.push_back(std::move(a));
         }
         break;
     }
     case FilterView::Unread:
         m_current_articles = m_db->GetUnreadArticles();
         break;
+    case FilterView::Related:
+        if (!m_related_link.empty()) {
+            m_current_articles =
+                m_db->GetArticles(m_related.Related(m_related_link, RELATED_COUNT));
+        }
+        break;
     case FilterView::TagBase:
         m_current_articles = m_db->GetArticlesForTag(GetTagNameForFilter(m_filter_index));
         break;
@@ -332,19 +491,32 @@ void AppCore::FetchArticles() {
     // before the schema migration visible until a fresh fetch backfills them.
     const std::set<std::string> all_topics(m_topics.begin(), m_topics.end());
     if (m_active_categories != all_topics) {
-        m_current_articles.erase(std::remove_if(m_current_articles.begin(),
-                                                m_current_articles.end(),
-                                                [this](const Article& a) {
-                                                    if (a.category.empty())
-                                                        return false;
-                                                    for (const auto& cat : m_active_categories) {
-                                                        if (a.category.find(cat) !=
-                                                            std::string::npos)
-                                                            return false;
-                                                    }
-                                                    return true;
-                                                }),
+        auto visible = [this](const Article& a) {
+            if (a.category.empty())
+                return true;
+            for (const auto& cat : m_active_categories) {
+                if (a.category.find(cat) != std::string::npos)
+                    return true;
+            }
+            return false;
+        };
+        // Compact in place, keeping the score column aligned.
+        const bool scored = !m_current_scores.empty();
+        size_t kept = 0;
+        for (size_t i = 0; i < m_current_articles.size(); ++i) {
+            if (!visible(m_current_articles[i]))
+                continue;
+            if (kept != i) {
+                m_current_articles[kept] = std::move(m_current_articles[i]);
+                if (scored)
+                    m_current_scores[kept] = m_current_scores[i];
+            }
+            ++kept;
+        }
+        m_current_articles.erase(m_current_articles.begin() + static_cast<std::ptrdiff_t>(kept),
                                  m_current_articles.end());
+        if (scored)
+            m_current_scores.resize(kept);
     }
 
     RefreshTitles();
@@ -655,11 +827,12 @@ void AppCore::RefreshFilterOptions() {
                         "Recommended",
                         "Followed Authors",
                         "New Articles",
-                        "Unread"};
+                        "Unread",
+                        "Related"};
     m_filter_tag_names.clear();
     m_filter_project_names.clear();
 
-    // Add tags (indices 9, 10, ...)
+    // Add tags (indices 10, 11, ...)
     for (const auto& tag : m_db->GetTags()) {
         m_filter_options.push_back("#" + tag);
         m_filter_tag_names.push_back(tag);
@@ -727,8 +900,14 @@ void AppCore::ClearSearch() {
 void AppCore::RateArticle(const std::string& article_link, int rating) {
     if (rating < 1 || rating > 5)
         return;
+    if (m_daemon) {
+        SendRatings({article_link}, rating);
+        NotifyArticleUpdate();
+        return;
+    }
     m_db->SetRating(article_link, rating);
     spdlog::info("[AppCore]: Rated article {} with {}", article_link, rating);
+    QueueOnlineUpdate({article_link}, rating);
 
     ++m_ratings_since_train;
     spdlog::debug("[AppCore]: {} new rating(s) pending (threshold: {})",
@@ -755,12 +934,18 @@ void AppCore::RateSelected(int rating) {
     } else if (!m_current_articles.empty()) {
         targets.push_back(m_current_articles[static_cast<size_t>(m_article_index)].link);
     }
+    if (m_daemon) {
+        SendRatings(targets, rating);
+        NotifyArticleUpdate();
+        return;
+    }
 
     for (const auto& link : targets) {
         m_db->SetRating(link, rating);
         spdlog::info("[AppCore]: Rated article {} with {}", link, rating);
         ++m_ratings_since_train;
     }
+    QueueOnlineUpdate(targets, rating);
 
     spdlog::debug("[AppCore]: {} new rating(s) pending (threshold: {})",
                   m_ratings_since_train,
@@ -776,6 +961,11 @@ void AppCore::RateSelected(int rating) {
 
 void AppCore::ForceRetrain() {
     spdlog::info("[AppCore]: Full retrain requested");
+    if (m_daemon) {
+        std::unique_ptr<DaemonClient> client;
+        call_daemon(client, *m_daemon, "retrain");
+        return;
+    }
     m_ratings_since_train = 0;
     SpawnTrainingThread(/*warm_start=*/false);
 }
@@ -786,49 +976,353 @@ void AppCore::SpawnTrainingThread(bool warm_start) {
         m_train_thread.join();
     }
 
-    // Snapshot training data on the main thread.
-    auto all_articles = m_db->GetRecent(-1);
+    // Snapshot the ratings on the main thread; the vocabulary comes from the
+    // document-frequency table, so the corpus itself is never loaded.
     auto rated = m_db->GetRatedArticles();
 
     // For warm-start, copy the current ranker (vocab + weights) to the thread.
-    // For cold-start, a default-constructed Ranker will be used.
+    // For cold-start, a fresh Ranker with the configured vectoriser is used.
     Ranker seed_ranker;
-    if (warm_start) {
-        std::lock_guard<std::mutex> lock(m_ranker_mutex);
-        seed_ranker = m_ranker;
+    {
+        std::lock_guard<std::mutex> lock(m_publish_mutex);
+        if (warm_start)
+            seed_ranker = *Model();
+        // Online updates from here on miss the snapshot; they are recorded
+        // and re-applied to the retrained model.
+        m_online_since_snapshot.clear();
+        m_training = true;
     }
-
-    m_training = true;
     m_train_thread = std::thread([this,
                                   warm_start,
-                                  all_articles = std::move(all_articles),
                                   rated = std::move(rated),
                                   seed_ranker = std::move(seed_ranker)]() mutable {
+        // Only rated articles never seen before are tokenised here. The
+        // lists are fetched first: they may grow the dictionary the ranker
+        // maps them through.
+        auto rated_terms = m_term_cache.Get(rated);
         if (!warm_start) {
             // Cold start: build fresh vocabulary then train from scratch.
-            seed_ranker = Ranker{};
-            seed_ranker.FitVocabulary(all_articles);
+            seed_ranker = Ranker{m_ranker_hash_bits};
+            if (m_ranker_search) {
+                // Model selection on the spare cores; the winner is trained
+                // on every rating below and saved with its hyperparameters.
+                const auto trials = RankerSearch(seed_ranker).Run(
+                    rated_terms,
+                    [this](Ranker& r) { FitVocabulary(r); },
+                    [this](const Ranker& r) { return m_term_cache.Columns(r); },
+                    &m_cancel);
+                if (m_cancel.IsCancelled()) {
+                    m_training = false;
+                    return;
+                }
+                if (!trials.empty())
+                    seed_ranker.SetHyperparameters(trials.front().params);
+            }
+            FitVocabulary(seed_ranker);
         }
         // warm_start=true keeps the existing vocab; only SGD continues.
-        seed_ranker.Train(rated, warm_start);
-        seed_ranker.Save(m_ranker_path);
+        const bool trained = seed_ranker.Train(
+            rated_terms, m_term_cache.Columns(seed_ranker), warm_start, &m_cancel);
+        if (!trained && m_cancel.IsCancelled()) {
+            // Shutting down: keep the saved model, not a half-trained one.
+            m_training = false;
+            return;
+        }
+        // Too few ratings: publish the fitted vectoriser for the Related
+        // view, but refit it next launch rather than save it untrained.
+        if (trained) {
+            // Saved quantised, so the next startup maps the int8 weights.
+            if (m_ranker_quantise)
+                seed_ranker.Quantise();
+            seed_ranker.Save(m_ranker_path);
+        }
 
         {
-            std::lock_guard<std::mutex> lock(m_ranker_mutex);
-            m_ranker = std::move(seed_ranker);
+            std::lock_guard<std::mutex> lock(m_publish_mutex);
+            m_online_unsaved = !m_online_since_snapshot.empty();
+            if (m_online_unsaved) {
+                seed_ranker.Update(m_online_since_snapshot, m_term_cache.Columns(seed_ranker));
+                m_online_since_snapshot.clear();
+            }
+            Publish(std::make_shared<Ranker>(std::move(seed_ranker)));
+            m_training = false;
         }
-        m_training = false;
+        RebuildRelated(*Model());
         m_needs_refetch = true;
         NotifyArticleUpdate();
     });
 }
 
-bool AppCore::IsRankerTrained() const {
-    std::lock_guard<std::mutex> lock(m_ranker_mutex);
-    return m_ranker.IsTrained();
+void AppCore::FitVocabulary(Ranker& ranker) {
+    if (ranker.IsHashed())
+        return;
+    // Articles stored before the term cache existed (or while it could not
+    // persist) are counted first.
+    m_term_cache.Backfill();
+    const auto features = static_cast<size_t>(ranker.GetHyperparameters().max_features);
+    ranker.FitVocabulary(m_db->GetTopTerms(features), m_db->CountTermLists());
+}
+
+void AppCore::IndexRelated(const std::vector<Article>& articles) {
+    if (articles.empty())
+        return;
+    std::lock_guard<std::mutex> lock(m_related_build_mutex);
+    const auto model = Model();
+    // Published but not yet re-indexed: the rebuild reads these from the
+    // term cache.
+    if (model->VocabularyHash() != m_related.Vocabulary())
+        return;
+    const auto docs = m_term_cache.Get(articles);
+    const auto columns = m_term_cache.Columns(*model);
+    Ranker::SparseVector features;
+    bool added = false;
+    for (size_t i = 0; i < articles.size(); ++i) {
+        model->Features(docs[i], columns, features);
+        if (features.empty())
+            continue;
+        m_related.Add(articles[i].link, RelatedIndex::Sign(features));
+        added = true;
+    }
+    if (added)
+        m_related.Save(m_related_path);
+}
+
+void AppCore::IndexFetched(const std::vector<Article>& articles) {
+    if (m_daemon) {
+        if (m_daemon->LastFetchedCount() > 0)
+            ReloadRelated();
+        return;
+    }
+    m_term_cache.Add(articles);
+    IndexRelated(articles);
+}
+
+void AppCore::ReloadRelated() {
+    std::lock_guard<std::mutex> lock(m_related_build_mutex);
+    RelatedIndex saved;
+    if (!saved.Load(m_related_path))
+        return;
+    // Signatures from another vectoriser do not compare with this model's.
+    if (saved.Vocabulary() != Model()->VocabularyHash()) {
+        spdlog::info("[AppCore]: Saved related-papers index is for another model; keeping ours");
+        return;
+    }
+    m_related = std::move(saved);
+}
+
+void AppCore::ReloadModels() {
+    const auto ranker_saved = modified(m_ranker_path);
+    if (ranker_saved != m_ranker_saved) {
+        m_ranker_saved = ranker_saved;
+        auto ranker = std::make_shared<Ranker>();
+        if (ranker->Load(m_ranker_path) && ranker->IsHashed() == (m_ranker_hash_bits > 0)) {
+            spdlog::info("[AppCore]: Loaded the model the daemon saved");
+            {
+                std::lock_guard<std::mutex> lock(m_publish_mutex);
+                Publish(std::move(ranker));
+            }
+            // Its index may have been saved first, and skipped as another
+            // model's.
+            m_related_saved = {};
+            m_needs_refetch = true;
+        }
+    }
+    const auto related_saved = modified(m_related_path);
+    if (related_saved != m_related_saved) {
+        m_related_saved = related_saved;
+        ReloadRelated();
+        m_needs_refetch = true;
+    }
+}
+
+void AppCore::SendRatings(const std::vector<std::string>& links, int rating) {
+    std::unique_ptr<DaemonClient> client;
+    for (const auto& link : links) {
+        if (!call_daemon(client, *m_daemon, "rate", {{"link", link}, {"rating", rating}}))
+            m_db->SetRating(link, rating);
+        spdlog::info("[AppCore]: Rated article {} with {}", link, rating);
+    }
+}
+
+void AppCore::RebuildRelated(const Ranker& model) {
+    std::lock_guard<std::mutex> lock(m_related_build_mutex);
+    const uint64_t vocabulary = model.VocabularyHash();
+    if (vocabulary == m_related.Vocabulary())
+        return;
+    spdlog::info("[AppCore]: Rebuilding the related-papers index");
+    RelatedIndex fresh(vocabulary);
+    const auto columns = m_term_cache.Columns(model);
+    Ranker::SparseVector features;
+    m_term_cache.ForEach([&](const std::string& link, const TermList& terms) {
+        model.Features(terms, columns, features);
+        // Articles with no known terms would all look alike.
+        if (!features.empty())
+            fresh.Add(link, RelatedIndex::Sign(features));
+    });
+    m_related = std::move(fresh);
+    // An empty index is rebuilt just as fast as it loads.
+    if (m_related.Size() > 0)
+        m_related.Save(m_related_path);
+}
+
+void AppCore::ForgetArticles(const std::vector<std::string>& links) {
+    m_term_cache.Remove(links);
+    bool removed = false;
+    for (const auto& link : links) {
+        if (!m_related.Contains(link))
+            continue;
+        m_related.Remove(link);
+        removed = true;
+    }
+    // The daemon's copy is its own to save.
+    if (removed && !m_daemon)
+        m_related.Save(m_related_path);
+}
+
+bool AppCore::IsRelatedBuilding() const {
+    return Model()->VocabularyHash() != m_related.Vocabulary();
 }
 
+void AppCore::ShowRelated(const std::string& article_link) {
+    m_related_link = article_link;
+    // Switching views fetches; re-showing the current one has to.
+    if (GetFilterView() == FilterView::Related)
+        FetchArticles();
+    else
+        SetFilterIndex(FilterView::Related);
+}
+
+void AppCore::QueueOnlineUpdate(const std::vector<std::string>& links, int rating) {
+    // Until the first training run there is no model to nudge; the ratings
+    // reach it through that run.
+    if (!IsRankerTrained())
+        return;
+
+    // Links outside the current view are read from the database.
+    std::vector<std::pair<Article, int>> rated;
+    std::vector<std::string> missing;
+    for (const auto& link : links) {
+        auto it = std::find_if(m_current_articles.begin(),
+                               m_current_articles.end(),
+                               [&link](const Article& a) { return a.link == link; });
+        if (it != m_current_articles.end())
+            rated.emplace_back(*it, rating);
+        else
+            missing.push_back(link);
+    }
+    if (!missing.empty())
+        for (auto& article : m_db->GetArticles(missing))
+            rated.emplace_back(std::move(article), rating);
+    if (rated.empty())
+        return;
+
+    if (!m_online_thread.joinable()) {
+        // Seed the replay buffer with the earlier ratings, read here like
+        // every other snapshot of the database.
+        auto history = m_db->GetRatedArticles();
+        history.erase(std::remove_if(history.begin(),
+                                     history.end(),
+                                     [&links](const auto& entry) {
+                                         return std::find(links.begin(),
+                                                          links.end(),
+                                                          entry.first.link) != links.end();
+                                     }),
+                      history.end());
+        if (history.size() > REPLAY_CAPACITY)
+            history.erase(history.begin(),
+                          history.end() - static_cast<std::ptrdiff_t>(REPLAY_CAPACITY));
+        m_online_thread = std::thread([this, history = std::move(history)]() {
+            RunOnlineUpdates(m_term_cache.Get(history));
+        });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_online_mutex);
+        m_online_queue.insert(m_online_queue.end(), rated.begin(), rated.end());
+    }
+    // Also wakes WaitForOnlineUpdates callers, which share the condition.
+    m_online_cv.notify_all();
+}
+
+void AppCore::RunOnlineUpdates(std::vector<std::pair<TermList, int>> replay) {
+    std::mt19937 rng(42);
+    std::size_t replay_next = 0; // oldest entry, once the buffer is full
+    std::vector<std::pair<Article, int>> fresh;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_online_mutex);
+            m_online_busy = false;
+            m_online_cv.notify_all();
+            m_online_cv.wait(lock, [this] { return m_online_stop || !m_online_queue.empty(); });
+            if (m_online_stop)
+                return;
+            fresh.clear();
+            fresh.swap(m_online_queue);
+            m_online_busy = true;
+        }
+
+        // The new ratings, then a replay sample so the step does not pull
+        // the model towards them alone.
+        auto batch = m_term_cache.Get(fresh);
+        const std::size_t n_fresh = batch.size();
+        for (std::size_t i = 0; i < REPLAY_SAMPLE && !replay.empty(); ++i) {
+            std::uniform_int_distribution<std::size_t> pick(0, replay.size() - 1);
+            batch.push_back(replay[pick(rng)]);
+        }
+
+        bool updated = false;
+        {
+            std::lock_guard<std::mutex> lock(m_publish_mutex);
+            auto next = std::make_shared<Ranker>(*Model());
+            updated = next->Update(batch, m_term_cache.Columns(*next));
+            if (updated) {
+                Publish(std::move(next));
+                m_online_unsaved = true;
+                if (m_training)
+                    m_online_since_snapshot.insert(
+                        m_online_since_snapshot.end(),
+                        batch.begin(),
+                        batch.begin() + static_cast<std::ptrdiff_t>(n_fresh));
+            }
+        }
+        spdlog::debug("[AppCore]: Online update with {} new and {} replayed rating(s)",
+                      n_fresh,
+                      batch.size() - n_fresh);
+
+        for (std::size_t i = 0; i < n_fresh; ++i) {
+            if (replay.size() < REPLAY_CAPACITY) {
+                replay.push_back(std::move(batch[i]));
+            } else {
+                replay[replay_next] = std::move(batch[i]);
+                replay_next = (replay_next + 1) % REPLAY_CAPACITY;
+            }
+        }
+
+        if (updated) {
+            m_needs_refetch = true;
+            NotifyArticleUpdate();
+        }
+    }
+}
+
+void AppCore::WaitForOnlineUpdates() {
+    std::unique_lock<std::mutex> lock(m_online_mutex);
+    m_online_cv.wait(lock, [this] { return m_online_queue.empty() && !m_online_busy; });
+}
+
+std::shared_ptr<const Ranker> AppCore::Model() const { return std::atomic_load(&m_ranker); }
+
+void AppCore::Publish(std::shared_ptr<Ranker> model) {
+    if (m_ranker_quantise && model->IsTrained())
+        model->Quantise();
+    std::atomic_store(&m_ranker, std::shared_ptr<const Ranker>(std::move(model)));
+}
+
+bool AppCore::IsRankerTrained() const { return Model()->IsTrained(); }
+
 void AppCore::TryRefetchIfNeeded() {
+    if (m_daemon)
+        ReloadModels();
     // Don't query the DB while the background fetch is still writing —
     // SQLite would serialise the read against every pending insert and the
     // UI thread would block for the duration of the bulk insert.
@@ -852,8 +1346,17 @@ int AppCore::GetArticleRating(const std::string& article_link) const {
 }
 
 float AppCore::GetPredictedScore(const Article& article) const {
-    std::lock_guard<std::mutex> lock(m_ranker_mutex);
-    return m_ranker.Predict(article);
+    return Model()->Predict(article);
+}
+
+std::vector<float> AppCore::GetPredictedScores(const std::vector<Article>& articles) const {
+    // One snapshot for the whole batch, so a model published meanwhile
+    // cannot mix two models' scores in one view.
+    const auto model = Model();
+    if (!model->IsTrained())
+        return {};
+    const auto docs = m_term_cache.GetShared(articles);
+    return model->PredictBatch(docs, m_term_cache.Columns(*model));
 }
 
 void AppCore::SetRecommendThreshold(float threshold) {
@@ -1140,11 +1643,33 @@ static std::string get_bibtex(const Arxiv::Article& article, Arxiv::Fetcher* fet
 
 bool AppCore::ExportArticlesBibTeX(const std::vector<Article>& articles,
                                    const std::string& output_path) const {
+    // A single article keeps the per-paper lookup; anything larger resolves
+    // every id through one batched InspireHEP pass so a 200-paper project
+    // costs a handful of requests instead of two per paper.
+    if (articles.size() <= 1) {
+        return write_export(output_path,
+                            std::to_string(articles.size()) + " article(s) BibTeX",
+                            [&](std::ofstream& file) {
+                                for (const auto& a : articles) {
+                                    file << get_bibtex(a, m_fetcher.get()) << "\n";
+                                }
+                            });
+    }
+
     return write_export(output_path,
                         std::to_string(articles.size()) + " article(s) BibTeX",
                         [&](std::ofstream& file) {
-                            for (const auto& a : articles) {
-                                file << get_bibtex(a, m_fetcher.get()) << "\n";
+                            std::vector<std::string> ids;
+                            ids.reserve(articles.size());
+                            for (const auto& a : articles)
+                                ids.push_back(a.id());
+                            auto resolved = m_fetcher->FetchBibTeXBatch(ids);
+                            for (size_t i = 0; i < articles.size(); ++i) {
+                                auto it = resolved.find(ids[i]);
+                                if (it != resolved.end() && !it->second.empty())
+                                    file << it->second << "\n";
+                                else
+                                    file << build_fallback_bibtex(articles[i]) << "\n";
                             }
                         });
 }
@@ -1192,15 +1717,17 @@ std::vector<Article> AppCore::GetArticlesForFollowedAuthors() const {
     if (followed.empty())
         return {};
 
+    // One pass over each author list checks every followed name.
+    std::lock_guard<std::mutex> lock(m_author_matcher_mutex);
+    if (followed != m_matched_authors) {
+        m_author_matcher = AhoCorasick(followed);
+        m_matched_authors = std::move(followed);
+    }
     auto all = m_db->GetRecent(-1);
     std::vector<Article> result;
-    for (const auto& a : all) {
-        for (const auto& author : followed) {
-            if (a.authors.find(author) != std::string::npos) {
-                result.push_back(a);
-                break;
-            }
-        }
+    for (auto& a : all) {
+        if (m_author_matcher.Matches(a.authors))
+            result.push_back(std::move(a));
     }
     return result;
 }
@@ -1337,6 +1864,7 @@ void AppCore::DeleteCurrentOrSelected() {
         spdlog::info("[AppCore]: Deleting article {}", link);
         m_db->DeleteArticle(link);
     }
+    ForgetArticles(to_delete);
     m_selected_links.clear();
     FetchArticles();
 }
@@ -1650,8 +2178,10 @@ void AppCore::ReloadKeywords() {
     }
     m_keywords = kws;
     {
-        std::lock_guard<std::mutex> lock(m_ranker_mutex);
-        m_ranker.FitKeywords(kws);
+        std::lock_guard<std::mutex> lock(m_publish_mutex);
+        auto next = std::make_shared<Ranker>(*Model());
+        next->FitKeywords(kws);
+        Publish(std::move(next));
     }
     spdlog::info("[AppCore]: Loaded {} keyword(s) from '{}'", kws.size(), path);
 }
@@ -1671,8 +2201,10 @@ bool AppCore::SaveKeywords(const std::vector<std::string>& keywords) {
 
     m_keywords = keywords;
     {
-        std::lock_guard<std::mutex> lock(m_ranker_mutex);
-        m_ranker.FitKeywords(keywords);
+        std::lock_guard<std::mutex> lock(m_publish_mutex);
+        auto next = std::make_shared<Ranker>(*Model());
+        next->FitKeywords(keywords);
+        Publish(std::move(next));
     }
     spdlog::info("[AppCore]: Saved {} keyword(s) to '{}'", keywords.size(), path);
     return true;
@@ -1687,19 +2219,34 @@ void AppCore::StartAutoRefresh() {
     m_refresh_thread = std::thread([this] {
         // Hold the mutex for the entire loop so that StopAutoRefresh() can
         // only write m_refresh_running while the mutex is free (i.e. while
-        // the thread is either inside wait_for or inside FetchArticles with
-        // the lock temporarily released).  This prevents the lost-wakeup
-        // race where notify_all() fires before wait_for() begins.
+        // the thread is either inside wait_until or fetching with the lock
+        // temporarily released).  This prevents the lost-wakeup race where
+        // notify_all() fires before wait_until() begins.
         std::unique_lock<std::mutex> lock(m_refresh_mutex);
         while (m_refresh_running.load()) {
-            int minutes = m_auto_refresh_minutes > 0 ? m_auto_refresh_minutes : 60;
-            m_refresh_cv.wait_for(
-                lock, std::chrono::minutes(minutes), [this] { return !m_refresh_running.load(); });
-            if (m_refresh_running.load()) {
-                lock.unlock();
-                FetchArticles();
-                lock.lock();
+            // Sleep until the poll is due; a fetch made elsewhere (initial,
+            // daemon client) moves the due time and wakes us to re-read it.
+            const time_point due = m_refresh_schedule.NextDue();
+            m_refresh_cv.wait_until(lock, due, [this, due] {
+                return !m_refresh_running.load() || m_refresh_schedule.NextDue() != due;
+            });
+            if (!m_refresh_running.load() || m_cancel.IsCancelled())
+                break;
+            if (std::chrono::system_clock::now() < m_refresh_schedule.NextDue())
+                continue;
+            if (m_fetching.load()) {
+                // The initial fetch is still running and records itself.
+                m_refresh_cv.wait_for(
+                    lock, std::chrono::seconds{1}, [this] { return !m_refresh_running.load(); });
+                continue;
+            }
+            lock.unlock();
+            try {
+                FetchFromNetwork();
+            } catch (const std::exception& e) {
+                spdlog::warn("[AppCore]: Scheduled refresh failed: {}", e.what());
             }
+            lock.lock();
         }
     });
 }
@@ -1762,6 +2309,10 @@ void AppCore::UndoLastDelete() {
         for (const auto& tag : snap.tags)
             m_db->LinkArticleToTag(snap.article.link, tag);
     }
+    std::vector<Article> restored;
+    for (const auto& snap : *entry)
+        restored.push_back(snap.article);
+    IndexRelated(restored);
     FetchArticles();
 }
 
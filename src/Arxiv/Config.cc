@@ -54,11 +54,27 @@ void Config::load_from_file(const std::string& config_file) {
         retrain_interval_ = config["retrain_interval"].as<int>();
     }
 
+    if (config["ranker_hash_bits"]) {
+        ranker_hash_bits_ = config["ranker_hash_bits"].as<int>();
+    }
+
+    if (config["ranker_quantise"]) {
+        ranker_quantise_ = config["ranker_quantise"].as<bool>();
+    }
+
+    if (config["ranker_search"]) {
+        ranker_search_ = config["ranker_search"].as<bool>();
+    }
+
     // Load auto-refresh interval (optional; 0 = disabled)
     if (config["auto_refresh_minutes"]) {
         auto_refresh_minutes_ = config["auto_refresh_minutes"].as<int>();
     }
 
+    if (config["announcement_holidays"] && config["announcement_holidays"].IsSequence()) {
+        announcement_holidays_ = config["announcement_holidays"].as<std::vector<std::string>>();
+    }
+
     // Load Obsidian vault path (optional; empty = feature disabled)
     if (config["obsidian_vault"]) {
         obsidian_vault_ = config["obsidian_vault"].as<std::string>();
@@ -122,7 +138,15 @@ void Config::save_to_file(const std::string& config_file) const {
 
     config["recommend_threshold"] = recommend_threshold_;
     config["retrain_interval"] = retrain_interval_;
+    if (ranker_hash_bits_ > 0)
+        config["ranker_hash_bits"] = ranker_hash_bits_;
+    if (ranker_quantise_)
+        config["ranker_quantise"] = ranker_quantise_;
+    if (ranker_search_)
+        config["ranker_search"] = ranker_search_;
     config["auto_refresh_minutes"] = auto_refresh_minutes_;
+    if (!announcement_holidays_.empty())
+        config["announcement_holidays"] = announcement_holidays_;
     config["scroll_margin"] = scroll_margin_;
     config["max_article_age_days"] = max_article_age_days_;
     config["undo_buffer_size"] = undo_buffer_size_;
@@ -0,0 +1,487 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Daemon.hh"
+#include "Arxiv/AppCore.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "spdlog/spdlog.h"
+
+using Arxiv::Daemon;
+using Arxiv::DaemonClient;
+using Arxiv::DaemonFetcher;
+using json = nlohmann::json;
+
+// ---------------------------------------------------------------------------
+// Socket helpers
+// ---------------------------------------------------------------------------
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0; // callers ignore SIGPIPE instead
+#endif
+
+// A client that sends more than this without a newline is dropped.
+constexpr std::size_t MAX_LINE_BYTES = 1 << 20;
+
+// Poll tick: bounds how long AppCore's own background work (initial fetch,
+// training) waits to be noticed.
+constexpr int POLL_TICK_MS = 1000;
+
+std::string errno_message(const std::string& what) {
+    return "[Daemon]: " + what + ": " + std::strerror(errno);
+}
+
+bool fill_address(const std::string& path, sockaddr_un& addr) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+void set_cloexec(int fd) { ::fcntl(fd, F_SETFD, FD_CLOEXEC); }
+
+bool send_all(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+json ok_reply(const json& id, json result) {
+    return {{"id", id}, {"ok", true}, {"result", std::move(result)}};
+}
+
+json error_reply(const json& id, const std::string& message) {
+    return {{"id", id}, {"ok", false}, {"error", message}};
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Daemon
+// ---------------------------------------------------------------------------
+
+Daemon::Daemon(AppCore& core, std::string socket_path)
+    : m_core(core)
+    , m_socket_path(std::move(socket_path)) {
+    sockaddr_un addr{};
+    if (!fill_address(m_socket_path, addr))
+        throw std::runtime_error("[Daemon]: Socket path too long: " + m_socket_path);
+
+    // A live daemon answers; a leftover file from a crashed one does not.
+    if (DaemonClient::Connect(m_socket_path))
+        throw std::runtime_error("[Daemon]: Another daemon is listening on " + m_socket_path);
+    ::unlink(m_socket_path.c_str());
+
+    m_listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listen_fd < 0)
+        throw std::runtime_error(errno_message("socket"));
+    set_cloexec(m_listen_fd);
+
+    // Owner-only: the socket grants full read/write access to the library.
+    const mode_t old_mask = ::umask(0077);
+    const int bound = ::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::umask(old_mask);
+    if (bound != 0 || ::listen(m_listen_fd, SOMAXCONN) != 0 || ::pipe(m_wake_pipe) != 0) {
+        const std::string message = errno_message("Cannot listen on " + m_socket_path);
+        ::close(m_listen_fd);
+        throw std::runtime_error(message);
+    }
+    for (int fd : m_wake_pipe) {
+        set_cloexec(fd);
+        ::fcntl(fd, F_SETFL, O_NONBLOCK);
+    }
+    spdlog::info("[Daemon]: Listening on {}", m_socket_path);
+}
+
+Daemon::~Daemon() {
+    if (m_fetch_thread.joinable())
+        m_fetch_thread.join();
+    for (const auto& c : m_clients)
+        ::close(c.fd);
+    for (int fd : m_wake_pipe)
+        ::close(fd);
+    ::close(m_listen_fd);
+    ::unlink(m_socket_path.c_str());
+    spdlog::info("[Daemon]: Closed {}", m_socket_path);
+}
+
+std::string Daemon::DefaultSocketPath(const std::string& fallback_dir) {
+    const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && *runtime_dir)
+        return std::string(runtime_dir) + "/arxiv-tui.sock";
+    return fallback_dir + "/daemon.sock";
+}
+
+void Daemon::Stop() {
+    m_running.store(false);
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t n = ::write(m_wake_pipe[1], &byte, 1);
+}
+
+void Daemon::Run(bool auto_refresh) {
+    m_running.store(true);
+    m_initial_fetch_pending = m_core.IsFetching();
+
+    while (m_running.load()) {
+        std::vector<pollfd> fds;
+        fds.reserve(m_clients.size() + 2);
+        fds.push_back({m_listen_fd, POLLIN, 0});
+        fds.push_back({m_wake_pipe[0], POLLIN, 0});
+        for (const auto& c : m_clients)
+            fds.push_back({c.fd, POLLIN, 0});
+
+        if (::poll(fds.data(), fds.size(), POLL_TICK_MS) < 0 && errno != EINTR) {
+            spdlog::error("{}", errno_message("poll"));
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (::read(m_wake_pipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        if (fds[0].revents & POLLIN)
+            Accept();
+
+        std::vector<int> dead;
+        for (std::size_t i = 2; i < fds.size(); ++i) {
+            if (!fds[i].revents)
+                continue;
+            auto it = std::find_if(m_clients.begin(), m_clients.end(), [&](const Client& c) {
+                return c.fd == fds[i].fd;
+            });
+            if (it != m_clients.end() && !ReadFrom(*it))
+                dead.push_back(fds[i].fd);
+        }
+        for (int fd : dead)
+            Drop(fd);
+
+        if (m_fetch_done.load())
+            FinishFetch();
+
+        // The fetch AppCore started in its constructor.
+        if (m_initial_fetch_pending && !m_core.IsFetching()) {
+            m_initial_fetch_pending = false;
+            m_core.TryRefetchIfNeeded();
+            Broadcast({{"event", "new_articles"}});
+        }
+
+        // Every fetch reschedules the next one, so this fires once per due
+        // time; the one-second tick is well inside the dense polling cadence.
+        if (auto_refresh && !m_initial_fetch_pending &&
+            std::chrono::system_clock::now() >= m_core.NextRefreshDue())
+            StartFetch("");
+    }
+}
+
+void Daemon::Accept() {
+    const int fd = ::accept(m_listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+        spdlog::warn("{}", errno_message("accept"));
+        return;
+    }
+    set_cloexec(fd);
+    m_clients.push_back(Client{fd, {}, false});
+    spdlog::debug("[Daemon]: Client {} connected ({} total)", fd, m_clients.size());
+}
+
+bool Daemon::ReadFrom(Client& client) {
+    char buf[4096];
+    const ssize_t n = ::read(client.fd, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR)
+        return true;
+    if (n <= 0)
+        return false;
+    client.inbox.append(buf, static_cast<std::size_t>(n));
+
+    std::size_t start = 0;
+    for (auto nl = client.inbox.find('\n'); nl != std::string::npos;
+         nl = client.inbox.find('\n', start)) {
+        const std::string_view line(client.inbox.data() + start, nl - start);
+        start = nl + 1;
+        if (line.empty())
+            continue;
+        json request = json::parse(line, nullptr, false);
+        if (request.is_discarded() || !request.is_object()) {
+            Send(client.fd, error_reply(nullptr, "malformed request"));
+            continue;
+        }
+        if (auto reply = Dispatch(request, &client))
+            Send(client.fd, *reply);
+    }
+    client.inbox.erase(0, start);
+    if (client.inbox.size() > MAX_LINE_BYTES) {
+        spdlog::warn("[Daemon]: Dropping client {}: request line too long", client.fd);
+        return false;
+    }
+    return true;
+}
+
+void Daemon::Send(int fd, const json& message) {
+    // A failed send means the peer is gone; poll reports the hang-up and the
+    // client is dropped there.
+    if (!send_all(fd, message.dump() + "\n"))
+        spdlog::debug("[Daemon]: Send to client {} failed", fd);
+}
+
+void Daemon::Broadcast(const json& event) {
+    for (const auto& c : m_clients) {
+        if (c.subscribed)
+            Send(c.fd, event);
+    }
+}
+
+void Daemon::Drop(int fd) {
+    ::close(fd);
+    m_clients.erase(std::remove_if(m_clients.begin(),
+                                   m_clients.end(),
+                                   [fd](const Client& c) { return c.fd == fd; }),
+                    m_clients.end());
+    m_fetch_waiters.erase(std::remove_if(m_fetch_waiters.begin(),
+                                         m_fetch_waiters.end(),
+                                         [fd](const Waiter& w) { return w.fd == fd; }),
+                          m_fetch_waiters.end());
+    spdlog::debug("[Daemon]: Client {} disconnected ({} left)", fd, m_clients.size());
+}
+
+void Daemon::StartFetch(const std::string& since) {
+    if (m_fetch_thread.joinable())
+        return; // one in flight already; its result answers every waiter
+    spdlog::info("[Daemon]: Starting network fetch");
+    m_fetch_thread = std::thread([this, since] {
+        try {
+            m_fetched = m_core.FetchFromNetwork(since);
+            m_fetch_error.clear();
+        } catch (const std::exception& e) {
+            m_fetched = 0;
+            m_fetch_error = e.what();
+        }
+        m_fetch_done.store(true);
+        const char byte = 0;
+        [[maybe_unused]] const ssize_t n = ::write(m_wake_pipe[1], &byte, 1);
+    });
+}
+
+void Daemon::FinishFetch() {
+    m_fetch_thread.join();
+    m_fetch_done.store(false);
+    m_core.TryRefetchIfNeeded();
+
+    for (const auto& w : m_fetch_waiters) {
+        Send(w.fd,
+             m_fetch_error.empty() ? ok_reply(w.id, {{"added", m_fetched}})
+                                   : error_reply(w.id, m_fetch_error));
+    }
+    m_fetch_waiters.clear();
+    if (m_fetch_error.empty() && m_fetched > 0)
+        Broadcast({{"event", "new_articles"}, {"count", m_fetched}});
+}
+
+json Daemon::Handle(const json& request) { return *Dispatch(request, nullptr); }
+
+std::optional<json> Daemon::Dispatch(const json& request, Client* client) {
+    const json id = request.value("id", json());
+    const std::string op = request.value("op", "");
+    const json params = request.value("params", json::object());
+
+    try {
+        if (op == "ping") {
+            return ok_reply(id,
+                            {{"pid", ::getpid()},
+                             {"fetching", m_core.IsFetching() || m_fetch_thread.joinable()},
+                             {"trained", m_core.IsRankerTrained()}});
+        }
+        if (op == "subscribe") {
+            if (client)
+                client->subscribed = true;
+            return ok_reply(id, true);
+        }
+        if (op == "fetch") {
+            const std::string since = params.value("since", "");
+            if (!client) {
+                const auto added = m_core.FetchFromNetwork(since);
+                m_core.TryRefetchIfNeeded();
+                return ok_reply(id, {{"added", added}});
+            }
+            m_fetch_waiters.push_back({client->fd, id});
+            StartFetch(since);
+            return std::nullopt;
+        }
+        if (op == "rate") {
+            m_core.RateArticle(params.at("link").get<std::string>(),
+                               params.at("rating").get<int>());
+            return ok_reply(id, true);
+        }
+        if (op == "retrain") {
+            m_core.ForceRetrain();
+            return ok_reply(id, true);
+        }
+        return error_reply(id, "unknown op '" + op + "'");
+    } catch (const std::exception& e) {
+        spdlog::warn("[Daemon]: {} failed: {}", op, e.what());
+        return error_reply(id, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// DaemonClient
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<DaemonClient> DaemonClient::Connect(const std::string& socket_path) {
+    sockaddr_un addr{};
+    if (!fill_address(socket_path, addr))
+        return nullptr;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return nullptr;
+    set_cloexec(fd);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<DaemonClient>(new DaemonClient(fd));
+}
+
+DaemonClient::~DaemonClient() { ::close(m_fd); }
+
+bool DaemonClient::ReadLine(std::string& line, std::chrono::milliseconds timeout) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + timeout;
+    for (;;) {
+        const auto nl = m_inbox.find('\n');
+        if (nl != std::string::npos) {
+            line.assign(m_inbox, 0, nl);
+            m_inbox.erase(0, nl + 1);
+            return true;
+        }
+        const auto left =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (left.count() <= 0)
+            return false;
+        pollfd pfd{m_fd, POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, static_cast<int>(left.count()));
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            return false;
+        char buf[4096];
+        const ssize_t n = ::read(m_fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            throw std::runtime_error("[DaemonClient]: Daemon closed the connection");
+        m_inbox.append(buf, static_cast<std::size_t>(n));
+    }
+}
+
+json DaemonClient::Call(const std::string& op,
+                        const json& params,
+                        std::chrono::milliseconds timeout) {
+    const long id = m_next_id++;
+    const json request = {{"id", id}, {"op", op}, {"params", params}};
+    if (!send_all(m_fd, request.dump() + "\n"))
+        throw std::runtime_error("[DaemonClient]: Send failed: " + std::string(std::strerror(errno)));
+
+    std::string line;
+    while (ReadLine(line, timeout)) {
+        json message = json::parse(line, nullptr, false);
+        if (message.is_discarded())
+            continue;
+        if (message.contains("event")) {
+            m_events.push_back(std::move(message));
+            continue;
+        }
+        if (message.value("id", json()) != id)
+            continue;
+        if (!message.value("ok", false))
+            throw std::runtime_error("[DaemonClient]: " + op + ": " +
+                                     message.value("error", std::string("failed")));
+        return message.value("result", json());
+    }
+    throw std::runtime_error("[DaemonClient]: " + op + ": timed out");
+}
+
+std::optional<json> DaemonClient::NextEvent(std::chrono::milliseconds timeout) {
+    if (!m_events.empty()) {
+        json event = std::move(m_events.front());
+        m_events.pop_front();
+        return event;
+    }
+    std::string line;
+    while (ReadLine(line, timeout)) {
+        json message = json::parse(line, nullptr, false);
+        if (!message.is_discarded() && message.contains("event"))
+            return message;
+    }
+    return std::nullopt;
+}
+
+// ---------------------------------------------------------------------------
+// DaemonFetcher
+// ---------------------------------------------------------------------------
+
+DaemonFetcher::DaemonFetcher(std::string socket_path,
+                             const std::vector<std::string>& topics,
+                             const std::string& download_dir)
+    : Fetcher(topics, download_dir)
+    , m_socket_path(std::move(socket_path)) {}
+
+std::vector<Arxiv::Article> DaemonFetcher::Fetch() {
+    m_last_count = Request(json::object());
+    return {};
+}
+
+std::vector<Arxiv::Article> DaemonFetcher::FetchSince(const std::string& utc_date) {
+    m_last_count = Request({{"since", utc_date}});
+    return {};
+}
+
+std::size_t DaemonFetcher::Request(const json& params) {
+    // A backfill can page through the search API for minutes.
+    constexpr std::chrono::minutes FETCH_TIMEOUT{10};
+    try {
+        auto client = DaemonClient::Connect(m_socket_path);
+        if (!client) {
+            spdlog::warn("[Fetcher]: No daemon at {}; nothing fetched", m_socket_path);
+            return 0;
+        }
+        return client->Call("fetch", params, FETCH_TIMEOUT).value("added", std::size_t{0});
+    } catch (const std::exception& e) {
+        spdlog::error("[Fetcher]: Daemon fetch failed: {}", e.what());
+        return 0;
+    }
+}
+
+std::unique_ptr<Arxiv::Fetcher> Arxiv::MakeFetcher(const Config& config) {
+    const auto& socket = config.get_daemon_socket();
+    if (!socket.empty() && DaemonClient::Connect(socket)) {
+        spdlog::info("[Fetcher]: Fetching through the daemon at {}", socket);
+        return std::make_unique<DaemonFetcher>(
+            socket, config.get_topics(), config.get_download_dir());
+    }
+    return std::make_unique<Fetcher>(config.get_topics(), config.get_download_dir());
+}
@@ -6,15 +6,19 @@
 
 #include "Arxiv/Article.hh"
 #include "Arxiv/Fetcher.hh"
+#include "Arxiv/Hash.hh"
+#include "Arxiv/Terms.hh"
 
 #include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <limits>
 #include <sqlite3.h>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
 #include "spdlog/spdlog.h"
 
@@ -27,11 +31,22 @@ namespace {
 
 // The article column list appears in nearly every SELECT — keep it in one
 // place so adding a column does not require touching seven query strings.
-constexpr const char* ARTICLE_COLUMNS =
-    "link, title, authors, abstract, date, bookmarked, category, is_replacement, read_at";
+constexpr const char* ARTICLE_COLUMNS = "link, title, authors, abstract, date, bookmarked, "
+                                        "category, is_replacement, read_at, content_hash";
 constexpr const char* ARTICLE_COLUMNS_A =
     "a.link, a.title, a.authors, a.abstract, a.date, a.bookmarked, a.category, a.is_replacement,"
-    " a.read_at";
+    " a.read_at, a.content_hash";
+// Number of columns in the lists above; extra SELECT columns start here.
+constexpr int ARTICLE_COLUMN_COUNT = 10;
+
+// Floor for the known-article Bloom filter so a fresh DB does not rebuild
+// it every few inserts.
+constexpr size_t KNOWN_FILTER_MIN_CAPACITY = 4096;
+
+// Bloom key for a stored (link, content hash) pair.
+uint64_t known_key(const std::string& link, uint64_t content_hash) {
+    return Arxiv::Hash::Mix(Arxiv::Hash::Fnv1a(link) ^ content_hash);
+}
 
 /// RAII wrapper around a prepared sqlite3_stmt. Construction prepares the
 /// statement (throws on failure); destruction always finalizes.
@@ -80,6 +95,14 @@ class Stmt {
         sqlite3_bind_double(m_stmt, idx, v);
         return *this;
     }
+    Stmt& bind_blob(int idx, const std::string& v) {
+        sqlite3_bind_blob(m_stmt, idx, v.data(), static_cast<int>(v.size()), SQLITE_TRANSIENT);
+        return *this;
+    }
+    Stmt& reset() {
+        sqlite3_reset(m_stmt);
+        return *this;
+    }
 
     int step() { return sqlite3_step(m_stmt); }
 
@@ -114,6 +137,9 @@ DatabaseManager::DatabaseManager(const std::string& path) {
                                  std::string(sqlite3_errmsg(db)));
     }
     sqlite3_trace_v2(db, SQLITE_TRACE_STMT, DatabaseManager::TraceCallback, nullptr);
+    // The daemon and the TUI share this file: wait out the other's write
+    // transaction rather than failing with SQLITE_BUSY.
+    sqlite3_busy_timeout(db, 5000);
 
     // Create articles table if it doesn't exist
     ExecuteSQL(R"(CREATE TABLE IF NOT EXISTS articles (
@@ -181,6 +207,15 @@ DatabaseManager::DatabaseManager(const std::string& path) {
         // Column already exists — ignore
     }
 
+    // Add content_hash column (migration for existing DBs). Holds
+    // Fetcher::ContentHash of the raw feed item; 0 for rows stored before the
+    // column existed, which are simply re-ingested once.
+    try {
+        ExecuteSQL("ALTER TABLE articles ADD COLUMN content_hash INTEGER DEFAULT 0");
+    } catch (const std::exception&) {
+        // Column already exists — ignore
+    }
+
     // Create followed_authors table
     ExecuteSQL(R"(CREATE TABLE IF NOT EXISTS followed_authors (
                author_name TEXT PRIMARY KEY))");
@@ -194,11 +229,48 @@ DatabaseManager::DatabaseManager(const std::string& path) {
     MigrateAddReadAt();
     MigrateAddProjectBibPath();
     CreateTagTables();
+    CreateTermTables();
     MigrateAddFTS5();
+    RebuildKnownFilter();
 
     spdlog::info("[Database]: Initialized");
 }
 
+void DatabaseManager::RebuildKnownFilter() {
+    size_t rows = 0;
+    {
+        Stmt count(db, "SELECT COUNT(*) FROM articles", "RebuildKnownFilter/count");
+        if (count.step() == SQLITE_ROW)
+            rows = static_cast<size_t>(sqlite3_column_int64(count.raw(), 0));
+    }
+
+    // Double the current size so steady-state inserts do not refill it.
+    BloomFilter filter(std::max(rows * 2, KNOWN_FILTER_MIN_CAPACITY));
+    Stmt sel(db,
+             "SELECT link, content_hash FROM articles WHERE content_hash != 0",
+             "RebuildKnownFilter/select");
+    sel.for_each([&](sqlite3_stmt* s) {
+        filter.Add(known_key(ExtractColumn(s, 0),
+                             static_cast<uint64_t>(sqlite3_column_int64(s, 1))));
+    });
+
+    std::lock_guard<std::mutex> lock(m_known_mutex);
+    m_known = std::move(filter);
+}
+
+bool DatabaseManager::IsKnownArticle(const std::string& link, uint64_t content_hash) {
+    if (content_hash == 0)
+        return false;
+    {
+        std::lock_guard<std::mutex> lock(m_known_mutex);
+        if (!m_known.MightContain(known_key(link, content_hash)))
+            return false;
+    }
+    Stmt stmt(db, "SELECT 1 FROM articles WHERE link = ? AND content_hash = ?", "IsKnownArticle");
+    stmt.bind(1, link).bind(2, static_cast<sqlite3_int64>(content_hash));
+    return stmt.step() == SQLITE_ROW;
+}
+
 void DatabaseManager::MigrateNormalizeLinks() {
     // One-time migration: normalize all article links to canonical form
     // (https scheme, no version suffix). Tracked by a metadata key so it
@@ -378,8 +450,9 @@ void DatabaseManager::AddArticle(const Article& article) {
 
     Stmt stmt(db,
               "INSERT OR REPLACE INTO articles "
-              "(link, title, authors, abstract, date, bookmarked, category, is_replacement) "
-              "VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+              "(link, title, authors, abstract, date, bookmarked, category, is_replacement, "
+              "content_hash) "
+              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
               "AddArticle");
     stmt.bind(1, article.link)
         .bind(2, article.title)
@@ -388,8 +461,23 @@ void DatabaseManager::AddArticle(const Article& article) {
         .bind(5, static_cast<sqlite3_int64>(timestamp))
         .bind(6, article.bookmarked ? 1 : 0)
         .bind(7, article.category)
-        .bind(8, article.is_replacement ? 1 : 0);
+        .bind(8, article.is_replacement ? 1 : 0)
+        .bind(9, static_cast<sqlite3_int64>(article.content_hash));
     stmt.step_done();
+
+    if (article.content_hash == 0)
+        return;
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(m_known_mutex);
+        full = m_known.Size() >= m_known.Capacity();
+        if (!full)
+            m_known.Add(known_key(article.link, article.content_hash));
+    }
+    // Past capacity the false-positive rate climbs; resize from the table,
+    // which already holds this row.
+    if (full)
+        RebuildKnownFilter();
 }
 
 std::vector<Arxiv::Article> DatabaseManager::GetRecent(int days) {
@@ -433,6 +521,16 @@ void DatabaseManager::DeleteArticle(const std::string& link) {
     pa.bind(1, link).step_done();
     Stmt ar(db, "DELETE FROM article_ratings WHERE article_link = ?", "DeleteArticle/ratings");
     ar.bind(1, link).step_done();
+    ExecuteSQL("BEGIN TRANSACTION");
+    try {
+        UpdateTermFrequencies(TermBlobs("link = ?", link), {});
+        Stmt at(db, "DELETE FROM article_terms WHERE link = ?", "DeleteArticle/terms");
+        at.bind(1, link).step_done();
+        ExecuteSQL("COMMIT");
+    } catch (...) {
+        ExecuteSQL("ROLLBACK");
+        throw;
+    }
     Stmt a(db, "DELETE FROM articles WHERE link = ?", "DeleteArticle");
     a.bind(1, link).step_done();
 }
@@ -521,6 +619,245 @@ std::vector<Arxiv::Article> DatabaseManager::GetArticlesForTag(const std::string
     return articles;
 }
 
+std::vector<Arxiv::Article> DatabaseManager::GetArticles(const std::vector<std::string>& links) {
+    std::vector<Article> articles;
+    articles.reserve(links.size());
+    const std::string sql =
+        std::string("SELECT ") + ARTICLE_COLUMNS + " FROM articles WHERE link = ?";
+    Stmt stmt(db, sql.c_str(), "GetArticles");
+    for (const auto& link : links) {
+        stmt.reset().bind(1, link);
+        if (stmt.step() == SQLITE_ROW)
+            articles.push_back(RowToArticle(stmt.raw()));
+    }
+    return articles;
+}
+
+void DatabaseManager::CreateTermTables() {
+    ExecuteSQL(R"(CREATE TABLE IF NOT EXISTS terms (
+               id   INTEGER PRIMARY KEY,
+               term TEXT NOT NULL))");
+    ExecuteSQL(R"(CREATE TABLE IF NOT EXISTS article_terms (
+               link         TEXT PRIMARY KEY,
+               content_hash INTEGER NOT NULL DEFAULT 0,
+               terms        BLOB NOT NULL))");
+    // Number of article_terms rows listing each term id.
+    ExecuteSQL(R"(CREATE TABLE IF NOT EXISTS term_df (
+               term INTEGER PRIMARY KEY,
+               df   INTEGER NOT NULL))");
+    ExecuteSQL("CREATE INDEX IF NOT EXISTS idx_term_df ON term_df(df)");
+
+    // Migration: count the lists stored before the table existed.
+    bool missing = false;
+    {
+        Stmt check(db,
+                   "SELECT NOT EXISTS (SELECT 1 FROM term_df) "
+                   "AND EXISTS (SELECT 1 FROM article_terms)",
+                   "CreateTermTables/df");
+        missing = check.step() == SQLITE_ROW && sqlite3_column_int(check.raw(), 0) != 0;
+    }
+    if (missing) {
+        spdlog::info("[Database]: Building the term document-frequency table");
+        ExecuteSQL("BEGIN TRANSACTION");
+        try {
+            UpdateTermFrequencies({}, TermBlobs("1"));
+            ExecuteSQL("COMMIT");
+        } catch (...) {
+            ExecuteSQL("ROLLBACK");
+            throw;
+        }
+    }
+}
+
+std::vector<std::string> DatabaseManager::TermBlobs(const char* where, const std::string& link) {
+    std::vector<std::string> blobs;
+    const std::string sql = std::string("SELECT terms FROM article_terms WHERE ") + where;
+    Stmt stmt(db, sql.c_str(), "TermBlobs");
+    stmt.bind(1, link);
+    stmt.for_each([&](sqlite3_stmt* s) {
+        const auto* blob = static_cast<const char*>(sqlite3_column_blob(s, 0));
+        blobs.emplace_back(blob ? blob : "", static_cast<size_t>(sqlite3_column_bytes(s, 0)));
+    });
+    return blobs;
+}
+
+void DatabaseManager::UpdateTermFrequencies(const std::vector<std::string>& removed,
+                                            const std::vector<std::string>& added) {
+    // Net change per term id, so a list replaced by a similar one touches
+    // only the terms that differ.
+    std::unordered_map<uint32_t, sqlite3_int64> delta;
+    TermList terms;
+    auto accumulate = [&](const std::vector<std::string>& blobs, sqlite3_int64 sign) {
+        for (const auto& blob : blobs) {
+            // Ids are checked against the terms table when read back.
+            if (!UnpackTerms(blob, std::numeric_limits<size_t>::max(), terms))
+                continue;
+            for (const auto& t : terms)
+                delta[t.term] += sign;
+        }
+    };
+    accumulate(removed, -1);
+    accumulate(added, 1);
+
+    Stmt upsert(db,
+                "INSERT INTO term_df (term, df) VALUES (?, ?) "
+                "ON CONFLICT(term) DO UPDATE SET df = df + excluded.df",
+                "UpdateTermFrequencies");
+    bool decremented = false;
+    for (const auto& [term, change] : delta) {
+        if (change == 0)
+            continue;
+        decremented = decremented || change < 0;
+        upsert.reset()
+            .bind(1, static_cast<sqlite3_int64>(term))
+            .bind(2, change)
+            .step_done();
+    }
+    if (decremented)
+        ExecuteSQL("DELETE FROM term_df WHERE df <= 0");
+}
+
+std::vector<std::string> DatabaseManager::GetTerms(size_t first_id) {
+    std::vector<std::string> terms;
+    Stmt stmt(db, "SELECT id, term FROM terms WHERE id >= ? ORDER BY id", "GetTerms");
+    stmt.bind(1, static_cast<sqlite3_int64>(first_id));
+    stmt.for_each([&](sqlite3_stmt* s) {
+        // Ids are dense from 0; a gap means a partial write, so stop there
+        // and let TermCache re-tokenise whatever referenced the rest.
+        if (sqlite3_column_int64(s, 0) != static_cast<sqlite3_int64>(first_id + terms.size()))
+            return;
+        terms.emplace_back(ExtractColumn(s, 1));
+    });
+    return terms;
+}
+
+size_t DatabaseManager::CountTerms() {
+    // Ids are dense, so this is one lookup at the end of the rowid b-tree
+    // rather than the scan COUNT(*) would be.
+    Stmt stmt(db, "SELECT COALESCE(MAX(id) + 1, 0) FROM terms", "CountTerms");
+    if (stmt.step() != SQLITE_ROW)
+        return 0;
+    return static_cast<size_t>(sqlite3_column_int64(stmt.raw(), 0));
+}
+
+std::vector<DatabaseManager::ArticleTerms>
+DatabaseManager::GetArticleTerms(const std::vector<std::string>& links) {
+    std::vector<ArticleTerms> rows;
+    Stmt stmt(db,
+              "SELECT link, content_hash, terms FROM article_terms WHERE link = ?",
+              "GetArticleTerms");
+    for (const auto& link : links) {
+        stmt.reset().bind(1, link);
+        if (stmt.step() == SQLITE_ROW)
+            rows.push_back(RowToArticleTerms(stmt.raw()));
+    }
+    return rows;
+}
+
+void DatabaseManager::ForEachArticleTerms(const std::function<void(ArticleTerms&)>& fn) {
+    Stmt stmt(db, "SELECT link, content_hash, terms FROM article_terms", "ForEachArticleTerms");
+    stmt.for_each([&](sqlite3_stmt* s) {
+        auto row = RowToArticleTerms(s);
+        fn(row);
+    });
+}
+
+DatabaseManager::ArticleTerms DatabaseManager::RowToArticleTerms(sqlite3_stmt* stmt) {
+    ArticleTerms row;
+    row.link = ExtractColumn(stmt, 0);
+    row.content_hash = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+    const auto* blob = static_cast<const char*>(sqlite3_column_blob(stmt, 2));
+    if (blob)
+        row.terms.assign(blob, static_cast<size_t>(sqlite3_column_bytes(stmt, 2)));
+    return row;
+}
+
+bool DatabaseManager::StoreTerms(size_t first_id,
+                                 const std::vector<std::string>& new_terms,
+                                 const std::vector<ArticleTerms>& rows) {
+    if (new_terms.empty() && rows.empty())
+        return true;
+    // IMMEDIATE takes the write lock up front, so no other connection can
+    // add terms between the check and the inserts.
+    ExecuteSQL("BEGIN IMMEDIATE");
+    try {
+        const size_t stored = CountTerms();
+        if (new_terms.empty() ? stored < first_id : stored != first_id) {
+            ExecuteSQL("ROLLBACK");
+            return false;
+        }
+        Stmt term(db, "INSERT INTO terms (id, term) VALUES (?, ?)", "StoreTerms");
+        for (size_t i = 0; i < new_terms.size(); ++i) {
+            term.reset()
+                .bind(1, static_cast<sqlite3_int64>(first_id + i))
+                .bind(2, new_terms[i])
+                .step_done();
+        }
+        Stmt row(db,
+                 "INSERT OR REPLACE INTO article_terms (link, content_hash, terms) "
+                 "VALUES (?, ?, ?)",
+                 "StoreTerms/articles");
+        // Each row's previous list is read just before it is replaced, so a
+        // link repeated within `rows` is only subtracted once per write.
+        std::vector<std::string> replaced, added;
+        added.reserve(rows.size());
+        for (const auto& r : rows) {
+            for (auto& blob : TermBlobs("link = ?", r.link))
+                replaced.push_back(std::move(blob));
+            added.push_back(r.terms);
+            row.reset()
+                .bind(1, r.link)
+                .bind(2, static_cast<sqlite3_int64>(r.content_hash))
+                .bind_blob(3, r.terms)
+                .step_done();
+        }
+        UpdateTermFrequencies(replaced, added);
+        ExecuteSQL("COMMIT");
+    } catch (...) {
+        ExecuteSQL("ROLLBACK");
+        throw;
+    }
+    return true;
+}
+
+void DatabaseManager::ClearTerms() {
+    ExecuteSQL("DELETE FROM article_terms");
+    ExecuteSQL("DELETE FROM term_df");
+    ExecuteSQL("DELETE FROM terms");
+}
+
+std::vector<std::pair<int, std::string>> DatabaseManager::GetTopTerms(size_t limit) {
+    std::vector<std::pair<int, std::string>> top;
+    // Bigrams are interned as "first second"; the vocabulary is unigrams.
+    Stmt stmt(db,
+              "SELECT d.df, t.term FROM term_df d JOIN terms t ON t.id = d.term "
+              "WHERE instr(t.term, ' ') = 0 "
+              "ORDER BY d.df DESC, t.term DESC LIMIT ?",
+              "GetTopTerms");
+    stmt.bind(1, static_cast<sqlite3_int64>(limit));
+    stmt.for_each([&](sqlite3_stmt* s) {
+        top.emplace_back(sqlite3_column_int(s, 0), ExtractColumn(s, 1));
+    });
+    return top;
+}
+
+size_t DatabaseManager::CountTermLists() {
+    Stmt stmt(db, "SELECT COUNT(*) FROM article_terms", "CountTermLists");
+    if (stmt.step() != SQLITE_ROW)
+        return 0;
+    return static_cast<size_t>(sqlite3_column_int64(stmt.raw(), 0));
+}
+
+std::vector<Arxiv::Article> DatabaseManager::GetArticlesWithoutTerms() {
+    std::vector<Article> articles;
+    const std::string sql = std::string("SELECT ") + ARTICLE_COLUMNS_A +
+                            " FROM articles a LEFT JOIN article_terms t ON t.link = a.link"
+                            " WHERE t.link IS NULL OR t.content_hash != a.content_hash";
+    Stmt stmt(db, sql.c_str(), "GetArticlesWithoutTerms");
+    stmt.for_each([&](sqlite3_stmt* s) { articles.push_back(RowToArticle(s)); });
+    return articles;
+}
+
 void DatabaseManager::MigrateAddProjectBibPath() {
     try {
         ExecuteSQL("ALTER TABLE projects ADD COLUMN bib_path TEXT DEFAULT ''");
@@ -612,18 +949,36 @@ std::vector<Arxiv::Article> DatabaseManager::GetUnreadArticles() {
     return articles;
 }
 
-void DatabaseManager::PruneArticles(int max_age_days) {
+std::vector<std::string> DatabaseManager::PruneArticles(int max_age_days) {
+    std::vector<std::string> pruned;
     if (max_age_days <= 0)
-        return;
+        return pruned;
     spdlog::info("[Database]: Pruning articles older than {} days", max_age_days);
-    Stmt stmt(db,
-              "DELETE FROM articles "
-              "WHERE date < strftime('%s', 'now') - ? * 86400 "
-              "AND bookmarked = 0 "
-              "AND link NOT IN (SELECT article_link FROM article_ratings) "
-              "AND link NOT IN (SELECT article_link FROM project_articles)",
-              "PruneArticles");
+    const std::string prunable = "WHERE date < strftime('%s', 'now') - ? * 86400 "
+                                 "AND bookmarked = 0 "
+                                 "AND link NOT IN (SELECT article_link FROM article_ratings) "
+                                 "AND link NOT IN (SELECT article_link FROM project_articles)";
+    Stmt sel(db, ("SELECT link FROM articles " + prunable).c_str(), "PruneArticles/select");
+    sel.bind(1, max_age_days);
+    sel.for_each([&](sqlite3_stmt* s) {
+        const char* v = reinterpret_cast<const char*>(sqlite3_column_text(s, 0));
+        if (v)
+            pruned.emplace_back(v);
+    });
+    Stmt stmt(db, ("DELETE FROM articles " + prunable).c_str(), "PruneArticles");
     stmt.bind(1, max_age_days).step_done();
+
+    constexpr const char* ORPHANED = "link NOT IN (SELECT link FROM articles)";
+    ExecuteSQL("BEGIN TRANSACTION");
+    try {
+        UpdateTermFrequencies(TermBlobs(ORPHANED), {});
+        ExecuteSQL(std::string("DELETE FROM article_terms WHERE ") + ORPHANED);
+        ExecuteSQL("COMMIT");
+    } catch (...) {
+        ExecuteSQL("ROLLBACK");
+        throw;
+    }
+    return pruned;
 }
 
 void DatabaseManager::AddProject(const std::string& project_name) {
@@ -711,6 +1066,7 @@ Arxiv::Article DatabaseManager::RowToArticle(sqlite3_stmt* stmt) {
     article.category = ExtractColumn(stmt, 6);
     article.is_replacement = sqlite3_column_int(stmt, 7) != 0;
     article.read = (sqlite3_column_type(stmt, 8) != SQLITE_NULL);
+    article.content_hash = static_cast<uint64_t>(sqlite3_column_int64(stmt, 9));
 
     return article;
 }
@@ -807,8 +1163,8 @@ DatabaseManager::RatedArticleList DatabaseManager::GetRatedArticles() {
     Stmt stmt(db, sql.c_str(), "GetRatedArticles");
     stmt.for_each([&](sqlite3_stmt* s) {
         Article article = RowToArticle(s);
-        // ARTICLE_COLUMNS_A has 9 columns (0-8); rating is column 9.
-        int rating = sqlite3_column_int(s, 9);
+        // Rating follows the article columns.
+        int rating = sqlite3_column_int(s, ARTICLE_COLUMN_COUNT);
         result.emplace_back(std::move(article), rating);
     });
     spdlog::debug("[Database]: Found {} rated articles", result.size());
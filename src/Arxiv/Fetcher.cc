@@ -5,23 +5,33 @@
 #include "Arxiv/Fetcher.hh"
 
 #include "Arxiv/Article.hh"
+#include "Arxiv/Calendar.hh"
+#include "Arxiv/Hash.hh"
+#include "Arxiv/LatexUtils.hh"
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
 #include <iterator>
-#include <sstream>
+#include <mutex>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
-#include "cpr/cpr.h"
 #include "fmt/ranges.h"
 #include "pugixml.hpp"
 #include "spdlog/spdlog.h"
 
 using Arxiv::Article;
+using Arxiv::CprTransport;
 using Arxiv::Fetcher;
+using Arxiv::HttpResponse;
 
 namespace {
 
@@ -33,40 +43,251 @@ constexpr std::string_view ARXIV_API_URL = "https://export.arxiv.org/api/query";
 constexpr std::string_view ARXIV_QUERY_FROM_FORMAT = "%Y%m%d0000";
 constexpr std::string_view ARXIV_QUERY_TO_FORMAT = "%Y%m%d2359";
 
-// Apply every (find, replace) entry in `table` to `text` in order, in-place.
-// Both StyleLatex and ReplaceLatexAccents do this exact loop; isolating it
-// removes the duplicate find-and-advance bookkeeping.
-void apply_replacements(std::string& text,
-                        const std::vector<std::pair<std::string, std::string>>& table) {
-    for (const auto& [needle, sub] : table) {
-        size_t pos = 0;
-        while ((pos = text.find(needle, pos)) != std::string::npos) {
-            text.replace(pos, needle.length(), sub);
-            pos += sub.length();
+// ---------------------------------------------------------------------------
+// Date parsing
+//
+// Hand-rolled scanners for the two timestamp shapes the feeds carry: RFC-822
+// in RSS <pubDate> ("Mon, 25 Mar 2024 00:00:00 -0400") and ISO-8601 in Atom
+// <published> ("2024-03-25T00:00:00Z"). They read straight out of the parsed
+// XML buffer, so there is no istringstream/get_time round trip (locale-bound
+// and allocating) per item, and offsets are applied exactly instead of going
+// through mktime's local-time interpretation.
+// ---------------------------------------------------------------------------
+
+struct CivilTime {
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    int offset_s = 0; // seconds east of UTC
+};
+
+class DateScanner {
+  public:
+    explicit DateScanner(std::string_view text) : m_text{text} {}
+
+    bool done() const { return m_pos >= m_text.size(); }
+    char peek() const { return done() ? '\0' : m_text[m_pos]; }
+
+    // Consume exactly `n` ASCII digits.
+    bool digits(size_t n, int& out) {
+        if (m_pos + n > m_text.size())
+            return false;
+        int value = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const char c = m_text[m_pos + i];
+            if (c < '0' || c > '9')
+                return false;
+            value = value * 10 + (c - '0');
         }
+        m_pos += n;
+        out = value;
+        return true;
+    }
+
+    // Consume one or two ASCII digits (RFC-822 day of month).
+    bool short_number(int& out) {
+        if (!digits(1, out))
+            return false;
+        int next = 0;
+        if (digits(1, next))
+            out = out * 10 + next;
+        return true;
+    }
+
+    bool literal(char c) {
+        if (peek() != c)
+            return false;
+        ++m_pos;
+        return true;
+    }
+
+    // Consume a run of ASCII letters.
+    std::string_view word() {
+        const size_t start = m_pos;
+        while (!done() && std::isalpha(static_cast<unsigned char>(m_text[m_pos])))
+            ++m_pos;
+        return m_text.substr(start, m_pos - start);
+    }
+
+    void skip_spaces() {
+        while (!done() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t'))
+            ++m_pos;
     }
+
+  private:
+    std::string_view m_text;
+    size_t m_pos = 0;
+};
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
 }
 
-// Parse the "YYYY-MM-DD" prefix of an ISO-8601 date string into tm fields.
-// Returns false if the input is too short or non-numeric. Used by both the
-// Atom-feed date parser and the FetchSince date-window builder.
-bool parse_ymd_prefix(const std::string& date, std::tm& out) {
-    if (date.size() < 10)
+std::string_view trim_spaces(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+        s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+        s.remove_suffix(1);
+    return s;
+}
+
+bool is_leap_year(int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+int days_in_month(int y, int m) {
+    static constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && is_leap_year(y) ? 29 : days[m - 1];
+}
+
+std::optional<Arxiv::time_point> to_time_point(const CivilTime& t) {
+    if (t.month < 1 || t.month > 12 || t.day < 1 || t.day > days_in_month(t.year, t.month) ||
+        t.hour > 23 || t.minute > 59 || t.second > 60)
+        return std::nullopt;
+    const int64_t secs = Arxiv::Calendar::DaysFromCivil(t.year, t.month, t.day) * 86400 +
+                         t.hour * 3600 + t.minute * 60 + t.second - t.offset_s;
+    return Arxiv::time_point{std::chrono::seconds{secs}};
+}
+
+// "YYYY-MM-DD"
+bool scan_ymd(DateScanner& in, CivilTime& out) {
+    return in.digits(4, out.year) && in.literal('-') && in.digits(2, out.month) &&
+           in.literal('-') && in.digits(2, out.day);
+}
+
+// "hh:mm[:ss]"
+bool scan_hms(DateScanner& in, CivilTime& out) {
+    if (!in.digits(2, out.hour) || !in.literal(':') || !in.digits(2, out.minute))
         return false;
-    try {
-        out.tm_year = std::stoi(date.substr(0, 4)) - 1900;
-        out.tm_mon = std::stoi(date.substr(5, 2)) - 1;
-        out.tm_mday = std::stoi(date.substr(8, 2));
-    } catch (...) {
+    if (in.literal(':') && !in.digits(2, out.second))
+        return false;
+    return true;
+}
+
+// Numeric zone "+hhmm" / "-hh:mm".
+bool scan_numeric_zone(DateScanner& in, CivilTime& out) {
+    const int sign = in.peek() == '-' ? -1 : 1;
+    if (!in.literal('+') && !in.literal('-'))
+        return false;
+    int hh = 0;
+    int mm = 0;
+    if (!in.digits(2, hh))
         return false;
+    in.literal(':');
+    if (!in.digits(2, mm))
+        return false;
+    out.offset_s = sign * (hh * 3600 + mm * 60);
+    return true;
+}
+
+// YYYY-MM-DD[Thh:mm[:ss[.fff]][Z|±hh[:]mm]]. A missing zone is read as UTC.
+std::optional<Arxiv::time_point> parse_iso8601(std::string_view text) {
+    DateScanner in(text);
+    CivilTime t;
+    if (!scan_ymd(in, t))
+        return std::nullopt;
+    if (in.literal('T') || in.literal('t') || in.literal(' ')) {
+        if (!scan_hms(in, t))
+            return std::nullopt;
+        if (in.literal('.')) {
+            int ignored = 0;
+            while (in.digits(1, ignored)) {
+            }
+        }
+        if (!in.literal('Z') && !in.literal('z') && !in.done() && !scan_numeric_zone(in, t))
+            return std::nullopt;
+    }
+    if (!in.done())
+        return std::nullopt;
+    return to_time_point(t);
+}
+
+// [Ddd, ]DD Mon YYYY hh:mm[:ss] [zone]. Zones are numeric offsets, UT/GMT/Z
+// or the North American abbreviations RFC-822 defines.
+std::optional<Arxiv::time_point> parse_rfc822(std::string_view text) {
+    static constexpr std::string_view months[] = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    static constexpr std::pair<std::string_view, int> zones[] = {
+        {"UT", 0},   {"UTC", 0},  {"GMT", 0},  {"Z", 0},    {"EST", -5}, {"EDT", -4},
+        {"CST", -6}, {"CDT", -5}, {"MST", -7}, {"MDT", -6}, {"PST", -8}, {"PDT", -7}};
+
+    DateScanner in(text);
+    CivilTime t;
+    if (std::isalpha(static_cast<unsigned char>(in.peek()))) {
+        in.word(); // day-of-week is redundant
+        if (!in.literal(','))
+            return std::nullopt;
+        in.skip_spaces();
+    }
+    if (!in.short_number(t.day))
+        return std::nullopt;
+    in.skip_spaces();
+    const auto month_name = in.word();
+    for (size_t i = 0; i < std::size(months); ++i) {
+        if (iequals(month_name, months[i]))
+            t.month = static_cast<int>(i) + 1;
     }
+    if (t.month == 0)
+        return std::nullopt;
+    in.skip_spaces();
+    if (!in.digits(4, t.year))
+        return std::nullopt;
+    in.skip_spaces();
+    if (!scan_hms(in, t))
+        return std::nullopt;
+    in.skip_spaces();
+    if (in.peek() == '+' || in.peek() == '-') {
+        if (!scan_numeric_zone(in, t))
+            return std::nullopt;
+    } else if (!in.done()) {
+        const auto zone = in.word();
+        const auto it = std::find_if(std::begin(zones), std::end(zones), [&](const auto& z) {
+            return iequals(zone, z.first);
+        });
+        if (it == std::end(zones))
+            return std::nullopt;
+        t.offset_s = it->second * 3600;
+    }
+    if (!in.done())
+        return std::nullopt;
+    return to_time_point(t);
+}
+
+// Parse the "YYYY-MM-DD" prefix of an ISO-8601 date string into tm fields.
+// Returns false if the input is too short or non-numeric. Used by the
+// FetchSince date-window builder.
+bool parse_ymd_prefix(std::string_view date, std::tm& out) {
+    DateScanner in(date);
+    CivilTime t;
+    if (!scan_ymd(in, t))
+        return false;
+    out.tm_year = t.year - 1900;
+    out.tm_mon = t.month - 1;
+    out.tm_mday = t.day;
     return true;
 }
 
+// Case-insensitive substring test for the replacement markers.
+bool contains_ci(std::string_view hay, std::string_view needle) {
+    auto it = std::search(hay.begin(), hay.end(), needle.begin(), needle.end(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) ==
+               std::tolower(static_cast<unsigned char>(b));
+    });
+    return it != hay.end();
+}
+
 } // namespace
 
-Fetcher::Fetcher(const std::vector<std::string>& topics, const std::string& _base_path)
-    : m_topics{topics} {
+Fetcher::Fetcher(const std::vector<std::string>& topics,
+                 const std::string& _base_path,
+                 std::unique_ptr<Transport> transport)
+    : m_topics{topics}
+    , m_transport{transport ? std::move(transport) : std::make_unique<CprTransport>()} {
     base_path = _base_path;
     if (!std::filesystem::exists(base_path)) {
         std::filesystem::create_directory(base_path);
@@ -80,7 +301,7 @@ std::vector<Article> Fetcher::Fetch() {
     std::vector<Article> all_articles;
     auto response = FetchFeeds();
     if (response) {
-        all_articles = ParseFeed(response.value());
+        all_articles = ParseFeed(std::move(*response));
     }
 
     spdlog::info("[Fetcher]: Fetched {} articles", all_articles.size());
@@ -94,15 +315,9 @@ std::vector<Article> Fetcher::FetchToday() {
 }
 
 bool Fetcher::DownloadPaper(const std::string& paper_id, const std::string& output_path) {
-    if (testing) {
-        // In testing mode, just create an empty file
-        std::ofstream file(output_path);
-        return file.good();
-    }
-
     try {
         auto url = ConstructPaperUrl(paper_id, "pdf");
-        auto response = cpr::Get(cpr::Url{url});
+        auto response = m_transport->Get(url, std::chrono::milliseconds{0}, m_cancel);
 
         if (response.status_code == 200) {
             std::ofstream file(base_path / output_path, std::ios::binary);
@@ -129,13 +344,9 @@ bool Fetcher::DownloadPaper(const std::string& paper_id, const std::string& outp
 }
 
 std::string Fetcher::GetPaperAbstract(const std::string& paper_id) {
-    if (testing) {
-        return "Sample abstract for testing purposes.";
-    }
-
     try {
         auto url = ConstructPaperUrl(paper_id, "abs");
-        auto response = cpr::Get(cpr::Url{url});
+        auto response = m_transport->Get(url, std::chrono::milliseconds{0}, m_cancel);
 
         if (response.status_code == 200) {
             pugi::xml_document doc;
@@ -156,45 +367,61 @@ std::string Fetcher::GetPaperAbstract(const std::string& paper_id) {
     }
 }
 
-std::string Fetcher::NormalizeLink(const std::string& link) {
-    std::string result = link;
-
-    // Normalize scheme to https
-    if (result.substr(0, 7) == "http://")
-        result.replace(0, 7, "https://");
+std::string Fetcher::NormalizeLink(std::string_view link) {
+    // Work on a view and build the result once: this runs for every feed item.
+    constexpr std::string_view http = "http://";
+    const bool plain_http = link.substr(0, http.size()) == http;
+    if (plain_http)
+        link.remove_prefix(http.size());
 
     // Strip trailing version suffix: "v" followed only by digits
-    auto v_pos = result.rfind('v');
-    if (v_pos != std::string::npos && v_pos + 1 < result.size()) {
-        std::string_view suffix(result.c_str() + v_pos + 1);
-        bool all_digits = !suffix.empty() && std::all_of(suffix.begin(), suffix.end(), ::isdigit);
+    auto v_pos = link.rfind('v');
+    if (v_pos != std::string_view::npos && v_pos + 1 < link.size()) {
+        auto suffix = link.substr(v_pos + 1);
+        bool all_digits = std::all_of(suffix.begin(), suffix.end(), ::isdigit);
         if (all_digits)
-            result.erase(v_pos);
+            link = link.substr(0, v_pos);
     }
 
+    // Normalize scheme to https
+    std::string result;
+    result.reserve(link.size() + 8);
+    if (plain_http)
+        result = "https://";
+    result.append(link);
     return result;
 }
 
+uint64_t Fetcher::ContentHash(std::string_view title,
+                              std::string_view abstract,
+                              std::string_view authors,
+                              std::string_view revision) {
+    // Unit separators keep ("ab", "c") and ("a", "bc") apart. 0 is reserved
+    // for "no hash" (rows stored before the column existed).
+    uint64_t h = Hash::Fnv1a(title);
+    h = Hash::Fnv1a("\x1f", h);
+    h = Hash::Fnv1a(abstract, h);
+    h = Hash::Fnv1a("\x1f", h);
+    h = Hash::Fnv1a(authors, h);
+    h = Hash::Fnv1a("\x1f", h);
+    h = Hash::Fnv1a(revision, h);
+    return h == 0 ? 1 : h;
+}
+
 std::string Fetcher::ConstructPaperUrl(const std::string& paper_id,
                                        const std::string& format) const {
     return fmt::format("https://arxiv.org/{}/{}", format, paper_id);
 }
 
 std::optional<std::string> Fetcher::FetchFeeds() {
-    if (testing) {
-        std::ifstream rss("hep-ph+hep-ex.rss");
-        std::stringstream buffer;
-        buffer << rss.rdbuf();
-        return buffer.str();
-    }
     spdlog::trace("[Fetcher]: Fetching articles for topics [{}]", fmt::join(m_topics, ", "));
     try {
         auto url = fmt::format("http://rss.arxiv.org/rss/{}", fmt::join(m_topics, "+"));
 
-        auto response = cpr::Get(cpr::Url{url});
+        auto response = m_transport->Get(url, std::chrono::milliseconds{0}, m_cancel);
 
         if (response.status_code == 200) {
-            return response.text;
+            return std::move(response.text);
         } else {
             spdlog::warn("[Fetcher]: Failed to fetch RSS");
             return std::nullopt;
@@ -206,12 +433,15 @@ std::optional<std::string> Fetcher::FetchFeeds() {
     }
 }
 
-std::vector<Article> Fetcher::ParseFeed(const std::string& xml_content) const {
+std::vector<Article> Fetcher::ParseFeed(std::string xml_content) const {
     std::vector<Article> articles;
     pugi::xml_document doc;
 
-    // Parse XML content
-    auto result = doc.load_string(xml_content.c_str());
+    // Parse in place: pugixml tokenises the buffer we own and node values
+    // point straight into it, so the feed is never copied a second time.
+    // Fetch() moves the response body in.
+    auto result = doc.load_buffer_inplace(
+        xml_content.data(), xml_content.size(), pugi::parse_default, pugi::encoding_utf8);
     if (!result) {
         spdlog::error("[Fetcher]: XML parsing error {}", result.description());
         return articles;
@@ -226,59 +456,61 @@ std::vector<Article> Fetcher::ParseFeed(const std::string& xml_content) const {
         }
 
         // Iterate through items
+        size_t skipped = 0;
         for (auto item : channel.children("item")) {
             Article article;
 
             // Extract basic fields using node values
-            article.title = LatexToMarkdown(item.child_value("title"));
             article.link = NormalizeLink(item.child_value("link"));
-            std::string abstract_text = item.child_value("description");
+            const std::string_view title = item.child_value("title");
+            std::string_view abstract_text = item.child_value("description");
+            std::string_view announce_header;
             // Find the position of "Abstract:" and remove everything up to and including it
             size_t abstract_pos = abstract_text.find("Abstract:");
-            if (abstract_pos != std::string::npos) {
-                abstract_text =
-                    abstract_text.substr(abstract_pos + 10); // 10 is length of "Abstract: "
+            if (abstract_pos != std::string_view::npos) {
+                announce_header = abstract_text.substr(0, abstract_pos);
+                // 10 is length of "Abstract: "
+                abstract_text.remove_prefix(std::min(abstract_pos + 10, abstract_text.size()));
             }
+            // Extract authors (dc.creator)
+            const std::string_view authors = item.child("dc:creator").text().get();
+
+            // Already stored unchanged: skip the conversions and the insert.
+            article.content_hash = ContentHash(title, abstract_text, authors, announce_header);
+            if (m_known_filter && m_known_filter(article.link, article.content_hash)) {
+                ++skipped;
+                continue;
+            }
+
+            article.title = LatexToMarkdown(title);
             article.abstract = LatexToMarkdown(abstract_text);
+            article.authors = LatexToMarkdown(authors);
 
             // Parse date
-            auto date_str = item.child_value("pubDate");
-            article.date = ParseDate(date_str).value_or(std::chrono::system_clock::now());
-
-            // Extract authors (dc.creator)
-            article.authors = LatexToMarkdown(item.child("dc:creator").text().get());
+            article.date =
+                ParseDate(item.child_value("pubDate")).value_or(std::chrono::system_clock::now());
 
             // Collect all categories
-            std::stringstream categories;
-            bool first = true;
             for (auto category : item.children("category")) {
-                if (!first)
-                    categories << ", ";
-                categories << category.text().get();
-                first = false;
+                if (!article.category.empty())
+                    article.category += ", ";
+                article.category += category.text().get();
             }
-            article.category = categories.str();
 
             // Replacement detection. arxiv RSS marks replacements either via
             //   <dc:type>replace</dc:type>  / "Replacement"
             //   <arxiv:announce_type>replace…</arxiv:announce_type>
             // or by suffixing the title with " (UPDATED)". Be permissive.
-            std::string dc_type = item.child_value("dc:type");
-            std::string ann_type = item.child_value("arxiv:announce_type");
-            auto contains_ci = [](const std::string& hay, const std::string& needle) {
-                auto it = std::search(
-                    hay.begin(), hay.end(), needle.begin(), needle.end(), [](char a, char b) {
-                        return std::tolower(static_cast<unsigned char>(a)) ==
-                               std::tolower(static_cast<unsigned char>(b));
-                    });
-                return it != hay.end();
-            };
+            const std::string_view dc_type = item.child_value("dc:type");
+            const std::string_view ann_type = item.child_value("arxiv:announce_type");
             article.is_replacement = contains_ci(dc_type, "replace") ||
                                      contains_ci(ann_type, "replace") ||
                                      contains_ci(article.title, "(UPDATED)");
 
-            articles.push_back(article);
+            articles.push_back(std::move(article));
         }
+        if (skipped > 0)
+            spdlog::debug("[Fetcher]: Skipped {} already-stored RSS items", skipped);
     } catch (const pugi::xpath_exception& e) {
         spdlog::error("[Fetcher] XPath error {}", e.what());
     } catch (const std::exception& e) {
@@ -288,308 +520,23 @@ std::vector<Article> Fetcher::ParseFeed(const std::string& xml_content) const {
     return articles;
 }
 
-std::optional<Arxiv::time_point> Fetcher::ParseDate(const std::string& date) const {
-    std::istringstream ss(date);
-    std::tm tm = {};
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-
-    if (ss.fail()) {
+std::optional<Arxiv::time_point> Fetcher::ParseDate(std::string_view date) const {
+    // RSS <pubDate> is RFC-822; older feeds and the fixtures use ISO-8601.
+    date = trim_spaces(date);
+    if (date.empty())
         return std::nullopt;
-    }
-
-    // Convert to time_point
-    std::time_t time = std::mktime(&tm);
-    return std::chrono::system_clock::from_time_t(time);
+    if (std::isdigit(static_cast<unsigned char>(date.front())) && date.size() >= 10 &&
+        date[4] == '-')
+        return parse_iso8601(date);
+    return parse_rfc822(date);
 }
 
-// Return the position of the closing brace that matches the '{' at open_pos,
-// respecting nested braces.  Returns std::string::npos if unmatched.
-static size_t find_closing_brace(const std::string& s, size_t open_pos) {
-    int depth = 1;
-    for (size_t i = open_pos + 1; i < s.size(); ++i) {
-        if (s[i] == '{')
-            ++depth;
-        else if (s[i] == '}' && --depth == 0)
-            return i;
-    }
-    return std::string::npos;
+std::string Fetcher::LatexToMarkdown(std::string_view text) const {
+    return Arxiv::LatexToMarkdown(text);
 }
 
-// Apply one pass of command→marker substitutions using proper brace matching.
-// Each entry is { "\\cmd", { "open_marker", "close_marker" } }.
-// An empty marker pair means "strip the command, keep the content."
-static void apply_latex_conversions(
-    std::string& result,
-    const std::vector<std::pair<std::string, std::pair<std::string, std::string>>>& table) {
-    for (const auto& [cmd, markers] : table) {
-        const auto& [open_md, close_md] = markers;
-        std::string open_tok = cmd + "{";
-        size_t pos = 0;
-        while ((pos = result.find(open_tok, pos)) != std::string::npos) {
-            size_t brace = pos + cmd.size(); // position of '{'
-            size_t close = find_closing_brace(result, brace);
-            if (close == std::string::npos) {
-                ++pos;
-                continue;
-            }
-            std::string content = result.substr(brace + 1, close - brace - 1);
-            std::string replacement = open_md + content + close_md;
-            result.replace(pos, close - pos + 1, replacement);
-            pos += replacement.size();
-        }
-    }
-}
-
-std::string Fetcher::LatexToMarkdown(const std::string& text) const {
-    std::string result = ReplaceLatexAccents(text);
-
-    // Commands with Markdown equivalents.
-    static const std::vector<std::pair<std::string, std::pair<std::string, std::string>>>
-        conversions = {
-            {"\\textbf", {"**", "**"}},
-            {"\\textit", {"*", "*"}},
-            {"\\emph", {"*", "*"}},
-            {"\\textsl", {"*", "*"}},
-            {"\\texttt", {"`", "`"}},
-            {"\\st", {"~~", "~~"}},
-            // No Markdown equivalent — strip the command, keep the content.
-            {"\\textsc", {"", ""}},
-            {"\\textnormal", {"", ""}},
-            {"\\textrm", {"", ""}},
-            {"\\textsf", {"", ""}},
-            {"\\textmd", {"", ""}},
-            {"\\textup", {"", ""}},
-            {"\\textdown", {"", ""}},
-            {"\\underline", {"", ""}},
-            {"\\overline", {"", ""}},
-        };
-
-    // Repeat until no further substitutions are made (handles nesting).
-    std::string prev;
-    do {
-        prev = result;
-        apply_latex_conversions(result, conversions);
-    } while (result != prev);
-
-    return result;
-}
-
-std::string Fetcher::StyleLatex(const std::string& text) const {
-    std::string result = text;
-
-    // For each formatting command, replace \cmd{content} with content in one
-    // pass so both the opening marker and its matching closing brace are
-    // removed together.  Processing innermost first (repeated until stable)
-    // handles nested commands correctly.
-    static const std::vector<std::string> commands = {"\\textit",
-                                                      "\\textbf",
-                                                      "\\emph",
-                                                      "\\textsl",
-                                                      "\\textsc",
-                                                      "\\texttt",
-                                                      "\\textnormal",
-                                                      "\\textrm",
-                                                      "\\textsf",
-                                                      "\\textmd",
-                                                      "\\textup",
-                                                      "\\textdown",
-                                                      "\\underline",
-                                                      "\\overline",
-                                                      "\\st"};
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        for (const auto& cmd : commands) {
-            std::string open = cmd + "{";
-            size_t pos = 0;
-            while ((pos = result.find(open, pos)) != std::string::npos) {
-                size_t content_start = pos + open.size();
-                size_t close = result.find("}", content_start);
-                if (close == std::string::npos)
-                    break;
-                result.replace(
-                    pos, close - pos + 1, result.substr(content_start, close - content_start));
-                changed = true;
-                // Re-scan from same position — the replacement may itself
-                // contain a further instance of the same command.
-            }
-        }
-    }
-
-    return result;
-}
-
-std::string Fetcher::ReplaceLatexAccents(const std::string& text) const {
-    std::string result = text;
-
-    // Accent replacements
-    const std::vector<std::pair<std::string, std::string>> replacements = {// Acute accent
-                                                                           {"\\'a", "á"},
-                                                                           {"\\'e", "é"},
-                                                                           {"\\'i", "í"},
-                                                                           {"\\'o", "ó"},
-                                                                           {"\\'u", "ú"},
-                                                                           {"\\'y", "ý"},
-                                                                           {"\\'A", "Á"},
-                                                                           {"\\'E", "É"},
-                                                                           {"\\'I", "Í"},
-                                                                           {"\\'O", "Ó"},
-                                                                           {"\\'U", "Ú"},
-                                                                           {"\\'Y", "Ý"},
-
-                                                                           // Grave accent
-                                                                           {"\\`a", "à"},
-                                                                           {"\\`e", "è"},
-                                                                           {"\\`i", "ì"},
-                                                                           {"\\`o", "ò"},
-                                                                           {"\\`u", "ù"},
-                                                                           {"\\`A", "À"},
-                                                                           {"\\`E", "È"},
-                                                                           {"\\`I", "Ì"},
-                                                                           {"\\`O", "Ò"},
-                                                                           {"\\`U", "Ù"},
-
-                                                                           // Circumflex
-                                                                           {"\\^a", "â"},
-                                                                           {"\\^e", "ê"},
-                                                                           {"\\^i", "î"},
-                                                                           {"\\^o", "ô"},
-                                                                           {"\\^u", "û"},
-                                                                           {"\\^A", "Â"},
-                                                                           {"\\^E", "Ê"},
-                                                                           {"\\^I", "Î"},
-                                                                           {"\\^O", "Ô"},
-                                                                           {"\\^U", "Û"},
-
-                                                                           // Tilde
-                                                                           {"\\~a", "ã"},
-                                                                           {"\\~n", "ñ"},
-                                                                           {"\\~o", "õ"},
-                                                                           {"\\~A", "Ã"},
-                                                                           {"\\~N", "Ñ"},
-                                                                           {"\\~O", "Õ"},
-
-                                                                           // Umlaut/diaeresis
-                                                                           {"\\\"a", "ä"},
-                                                                           {"\\\"e", "ë"},
-                                                                           {"\\\"i", "ï"},
-                                                                           {"\\\"o", "ö"},
-                                                                           {"\\\"u", "ü"},
-                                                                           {"\\\"y", "ÿ"},
-                                                                           {"\\\"A", "Ä"},
-                                                                           {"\\\"E", "Ë"},
-                                                                           {"\\\"I", "Ï"},
-                                                                           {"\\\"O", "Ö"},
-                                                                           {"\\\"U", "Ü"},
-                                                                           {"\\\"Y", "Ÿ"},
-
-                                                                           // Ring
-                                                                           {"\\r{a}", "å"},
-                                                                           {"\\r{A}", "Å"},
-
-                                                                           // Cedilla
-                                                                           {"\\c{c}", "ç"},
-                                                                           {"\\c{C}", "Ç"},
-
-                                                                           // Caron (háček)
-                                                                           {"\\v{a}", "ǎ"},
-                                                                           {"\\v{c}", "č"},
-                                                                           {"\\v{d}", "ď"},
-                                                                           {"\\v{e}", "ě"},
-                                                                           {"\\v{g}", "ğ"},
-                                                                           {"\\v{h}", "ȟ"},
-                                                                           {"\\v{i}", "ǐ"},
-                                                                           {"\\v{j}", "ǰ"},
-                                                                           {"\\v{k}", "ǩ"},
-                                                                           {"\\v{l}", "ľ"},
-                                                                           {"\\v{n}", "ň"},
-                                                                           {"\\v{o}", "ǒ"},
-                                                                           {"\\v{r}", "ř"},
-                                                                           {"\\v{s}", "š"},
-                                                                           {"\\v{t}", "ť"},
-                                                                           {"\\v{u}", "ǔ"},
-                                                                           {"\\v{z}", "ž"},
-                                                                           {"\\v{A}", "Ǎ"},
-                                                                           {"\\v{C}", "Č"},
-                                                                           {"\\v{D}", "Ď"},
-                                                                           {"\\v{E}", "Ě"},
-                                                                           {"\\v{G}", "Ğ"},
-                                                                           {"\\v{H}", "Ȟ"},
-                                                                           {"\\v{I}", "Ǐ"},
-                                                                           {"\\v{K}", "Ǩ"},
-                                                                           {"\\v{L}", "Ľ"},
-                                                                           {"\\v{N}", "Ň"},
-                                                                           {"\\v{O}", "Ǒ"},
-                                                                           {"\\v{R}", "Ř"},
-                                                                           {"\\v{S}", "Š"},
-                                                                           {"\\v{T}", "Ť"},
-                                                                           {"\\v{U}", "Ǔ"},
-                                                                           {"\\v{Z}", "Ž"},
-
-                                                                           // Dot above
-                                                                           {"\\.a", "ȧ"},
-                                                                           {"\\.b", "ḃ"},
-                                                                           {"\\.c", "ċ"},
-                                                                           {"\\.d", "ḋ"},
-                                                                           {"\\.e", "ė"},
-                                                                           {"\\.f", "ḟ"},
-                                                                           {"\\.g", "ġ"},
-                                                                           {"\\.h", "ḣ"},
-                                                                           {"\\.i", "ı"},
-                                                                           {"\\.m", "ṁ"},
-                                                                           {"\\.n", "ṅ"},
-                                                                           {"\\.o", "ȯ"},
-                                                                           {"\\.p", "ṗ"},
-                                                                           {"\\.r", "ṙ"},
-                                                                           {"\\.s", "ṡ"},
-                                                                           {"\\.t", "ṫ"},
-                                                                           {"\\.w", "ẇ"},
-                                                                           {"\\.x", "ẋ"},
-                                                                           {"\\.y", "ẏ"},
-                                                                           {"\\.z", "ż"},
-                                                                           {"\\.A", "Ȧ"},
-                                                                           {"\\.B", "Ḃ"},
-                                                                           {"\\.C", "Ċ"},
-                                                                           {"\\.D", "Ḋ"},
-                                                                           {"\\.E", "Ė"},
-                                                                           {"\\.F", "Ḟ"},
-                                                                           {"\\.G", "Ġ"},
-                                                                           {"\\.H", "Ḣ"},
-                                                                           {"\\.I", "İ"},
-                                                                           {"\\.M", "Ṁ"},
-                                                                           {"\\.N", "Ṅ"},
-                                                                           {"\\.O", "Ȯ"},
-                                                                           {"\\.P", "Ṗ"},
-                                                                           {"\\.R", "Ṙ"},
-                                                                           {"\\.S", "Ṡ"},
-                                                                           {"\\.T", "Ṫ"},
-                                                                           {"\\.W", "Ẇ"},
-                                                                           {"\\.X", "Ẋ"},
-                                                                           {"\\.Y", "Ẏ"},
-                                                                           {"\\.Z", "Ż"},
-
-                                                                           // Special characters
-                                                                           {"\\ss", "ß"},
-                                                                           {"\\SS", "ẞ"},
-                                                                           {"\\ae", "æ"},
-                                                                           {"\\AE", "Æ"},
-                                                                           {"\\oe", "œ"},
-                                                                           {"\\OE", "Œ"},
-                                                                           {"\\o", "ø"},
-                                                                           {"\\O", "Ø"},
-                                                                           {"\\l", "ł"},
-                                                                           {"\\L", "Ł"},
-                                                                           {"\\i", "ı"},
-                                                                           {"\\j", "ȷ"},
-                                                                           {"\\th", "þ"},
-                                                                           {"\\TH", "Þ"},
-                                                                           {"\\dh", "ð"},
-                                                                           {"\\DH", "Ð"},
-                                                                           {"\\ng", "ŋ"},
-                                                                           {"\\NG", "Ŋ"}};
-
-    apply_replacements(result, replacements);
-    return result;
+std::string Fetcher::ReplaceLatexAccents(std::string_view text) const {
+    return Arxiv::ReplaceLatexAccents(text);
 }
 
 std::vector<Article> Fetcher::FetchSince(const std::string& utc_date) {
@@ -647,6 +594,10 @@ std::vector<Article> Fetcher::FetchSince(const std::string& utc_date) {
     const int max_results = 200;
 
     while (true) {
+        if (CancellationToken::IsCancelled(m_cancel)) {
+            spdlog::info("[Fetcher]: FetchSince cancelled after {} articles", all_articles.size());
+            return all_articles;
+        }
         auto url = fmt::format("{}?search_query={}{}&start={}&max_results={}"
                                "&sortBy=submittedDate&sortOrder=descending",
                                ARXIV_API_URL,
@@ -656,9 +607,9 @@ std::vector<Article> Fetcher::FetchSince(const std::string& utc_date) {
                                max_results);
 
         spdlog::info("[Fetcher]: FetchSince GET {}", url);
-        cpr::Response resp;
+        HttpResponse resp;
         try {
-            resp = cpr::Get(cpr::Url{url}, cpr::Timeout{15000});
+            resp = m_transport->Get(url, std::chrono::milliseconds{15000}, m_cancel);
         } catch (const std::exception& e) {
             spdlog::error("[Fetcher]: FetchSince network error: {}", e.what());
             break;
@@ -669,11 +620,14 @@ std::vector<Article> Fetcher::FetchSince(const std::string& utc_date) {
             break;
         }
 
-        auto batch = ParseAtomFeed(resp.text);
-        if (batch.empty())
-            break;
-        all_articles.insert(all_articles.end(), batch.begin(), batch.end());
-        if (static_cast<int>(batch.size()) < max_results)
+        // Page on the number of entries arXiv returned, not the number kept:
+        // known entries are filtered out of `batch`.
+        size_t entries = 0;
+        auto batch = ParseAtomFeed(std::move(resp.text), &entries);
+        all_articles.insert(all_articles.end(),
+                            std::make_move_iterator(batch.begin()),
+                            std::make_move_iterator(batch.end()));
+        if (entries < static_cast<size_t>(max_results))
             break;
         start += max_results;
     }
@@ -684,6 +638,9 @@ std::vector<Article> Fetcher::FetchSince(const std::string& utc_date) {
     // up until a later open. Appended last so today's announcement wins on any
     // overlap when the DB de-dupes by link. This lets a single FetchSince call
     // cover both backfill and today, so callers need no separate Fetch().
+    // Skipped on cancellation; the pages already parsed are still returned.
+    if (CancellationToken::IsCancelled(m_cancel))
+        return all_articles;
     auto todays = Fetch();
     all_articles.insert(all_articles.end(),
                         std::make_move_iterator(todays.begin()),
@@ -693,11 +650,13 @@ std::vector<Article> Fetcher::FetchSince(const std::string& utc_date) {
     return all_articles;
 }
 
-std::vector<Article> Fetcher::ParseAtomFeed(const std::string& xml_content) const {
+std::vector<Article> Fetcher::ParseAtomFeed(std::string xml_content, size_t* entries) const {
     std::vector<Article> articles;
     pugi::xml_document doc;
 
-    auto result = doc.load_string(xml_content.c_str());
+    // In-place parse, as in ParseFeed; FetchSince moves each page body in.
+    auto result = doc.load_buffer_inplace(
+        xml_content.data(), xml_content.size(), pugi::parse_default, pugi::encoding_utf8);
     if (!result) {
         spdlog::error("[Fetcher]: Atom XML parse error: {}", result.description());
         return articles;
@@ -712,15 +671,18 @@ std::vector<Article> Fetcher::ParseAtomFeed(const std::string& xml_content) cons
         return articles;
     }
 
+    size_t skipped = 0;
     for (auto entry : feed.children("entry")) {
+        if (entries)
+            ++*entries;
         Article article;
 
         // <id> holds the URL e.g. http://arxiv.org/abs/2605.12345v1; normalize it.
-        std::string raw_link = entry.child_value("id");
+        std::string_view raw_link = entry.child_value("id");
         article.link = NormalizeLink(raw_link);
 
-        article.title = LatexToMarkdown(entry.child_value("title"));
-        article.abstract = LatexToMarkdown(entry.child_value("summary"));
+        const std::string_view title = entry.child_value("title");
+        const std::string_view summary = entry.child_value("summary");
 
         // Authors: one or more <author><name>…</name></author>
         std::string authors_str;
@@ -729,6 +691,16 @@ std::vector<Article> Fetcher::ParseAtomFeed(const std::string& xml_content) cons
                 authors_str += ", ";
             authors_str += author.child_value("name");
         }
+
+        // Already stored unchanged: skip the conversions and the insert.
+        article.content_hash = ContentHash(title, summary, authors_str, raw_link);
+        if (m_known_filter && m_known_filter(article.link, article.content_hash)) {
+            ++skipped;
+            continue;
+        }
+
+        article.title = LatexToMarkdown(title);
+        article.abstract = LatexToMarkdown(summary);
         article.authors = LatexToMarkdown(authors_str);
 
         // <published> = the date v1 was submitted and processed — the same
@@ -753,13 +725,13 @@ std::vector<Article> Fetcher::ParseAtomFeed(const std::string& xml_content) cons
         //   "replace-cross"). Treat the substring "replace" as the signal.
         // As a fallback the <id> is "<base>v<N>" — anything past v1 is a
         // replacement when announce_type is missing.
-        std::string ann = entry.child_value("arxiv:announce_type");
-        if (ann.find("replace") != std::string::npos) {
+        std::string_view ann = entry.child_value("arxiv:announce_type");
+        if (ann.find("replace") != std::string_view::npos) {
             article.is_replacement = true;
         } else if (ann.empty()) {
             auto v_pos = raw_link.rfind('v');
-            if (v_pos != std::string::npos && v_pos + 1 < raw_link.size()) {
-                std::string ver = raw_link.substr(v_pos + 1);
+            if (v_pos != std::string_view::npos && v_pos + 1 < raw_link.size()) {
+                std::string_view ver = raw_link.substr(v_pos + 1);
                 bool all_digits = !ver.empty() && std::all_of(ver.begin(), ver.end(), [](char c) {
                     return std::isdigit(c);
                 });
@@ -770,26 +742,31 @@ std::vector<Article> Fetcher::ParseAtomFeed(const std::string& xml_content) cons
 
         articles.push_back(std::move(article));
     }
+    if (skipped > 0)
+        spdlog::debug("[Fetcher]: Skipped {} already-stored Atom entries", skipped);
 
     return articles;
 }
 
-std::optional<Arxiv::time_point> Fetcher::ParseAtomDate(const std::string& date) const {
+std::optional<Arxiv::time_point> Fetcher::ParseAtomDate(std::string_view date) const {
     // Format: "2026-05-04T00:00:00-04:00" or "2026-05-04T00:00:00Z"
     // We only need the date portion for day-level granularity.
-    std::tm tm{};
-    if (!parse_ymd_prefix(date, tm))
+    DateScanner in(date);
+    CivilTime t;
+    if (!scan_ymd(in, t))
         return std::nullopt;
-    return std::chrono::system_clock::from_time_t(timegm(&tm));
+    return to_time_point(t);
 }
 
 std::string Fetcher::FetchBibTeX(const std::string& paper_id) {
     // --- 1. Try InspireHEP ---
     // Query the literature search API for the arXiv eprint.
     const std::string inspire_search =
-        "https://inspirehep.net/api/literature?q=eprint+" + paper_id + "&fields=texkeys&size=1";
+        m_inspire_base_url + "/literature?q=eprint+" + paper_id + "&fields=texkeys&size=1";
     try {
-        auto search_resp = cpr::Get(cpr::Url{inspire_search}, cpr::Timeout{5000});
+        auto search_resp = m_transport->Get(inspire_search,
+                                            std::chrono::milliseconds{5000},
+                                            m_cancel);
 
         if (search_resp.status_code == 200) {
             auto js = nlohmann::json::parse(search_resp.text);
@@ -798,7 +775,9 @@ std::string Fetcher::FetchBibTeX(const std::string& paper_id) {
                 // The hit object carries a links.bibtex URL
                 std::string bibtex_url = hits[0].at("links").at("bibtex").get<std::string>();
 
-                auto bib_resp = cpr::Get(cpr::Url{bibtex_url}, cpr::Timeout{5000});
+                auto bib_resp = m_transport->Get(bibtex_url,
+                                                 std::chrono::milliseconds{5000},
+                                                 m_cancel);
                 if (bib_resp.status_code == 200 && !bib_resp.text.empty()) {
                     spdlog::info("[Fetcher]: Got InspireHEP BibTeX for {}", paper_id);
                     return bib_resp.text;
@@ -814,3 +793,129 @@ std::string Fetcher::FetchBibTeX(const std::string& paper_id) {
     spdlog::debug("[Fetcher]: Returning empty BibTeX for {} (no InspireHEP hit)", paper_id);
     return {};
 }
+
+Fetcher::BibTeXMap Fetcher::FetchBibTeXBatch(const std::vector<std::string>& paper_ids) {
+    // De-duplicate and drop empty ids so each eprint is queried once.
+    std::vector<std::string> ids;
+    ids.reserve(paper_ids.size());
+    for (const auto& id : paper_ids) {
+        if (!id.empty())
+            ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    BibTeXMap resolved;
+    if (ids.empty())
+        return resolved;
+
+    // One InspireHEP request per chunk: "eprint+A+or+eprint+B+…" with
+    // format=bibtex returns every hit as a single BibTeX document, so a
+    // 200-paper export costs 8 round trips instead of 400.
+    std::vector<std::string> urls;
+    for (size_t begin = 0; begin < ids.size(); begin += INSPIRE_BATCH_SIZE) {
+        size_t end = std::min(ids.size(), begin + INSPIRE_BATCH_SIZE);
+        std::string query;
+        for (size_t i = begin; i < end; ++i) {
+            if (i > begin)
+                query += "+or+";
+            query += "eprint+" + ids[i];
+        }
+        urls.push_back(fmt::format(
+            "{}/literature?q={}&size={}&format=bibtex", m_inspire_base_url, query, end - begin));
+    }
+
+    // Bounded concurrency: a fixed pool of workers pulls chunk indices from a
+    // shared counter. InspireHEP rate-limits aggressive clients, so the pool
+    // never exceeds INSPIRE_MAX_IN_FLIGHT regardless of the export size.
+    std::atomic<size_t> next{0};
+    std::mutex resolved_mutex;
+    auto worker = [&]() {
+        for (size_t idx = next++; idx < urls.size(); idx = next++) {
+            try {
+                auto resp = m_transport->Get(urls[idx],
+                                             std::chrono::milliseconds{10000},
+                                             m_cancel);
+                if (resp.status_code != 200) {
+                    spdlog::warn("[Fetcher]: InspireHEP batch lookup HTTP {}", resp.status_code);
+                    continue;
+                }
+                auto entries = ParseInspireBibTeX(resp.text);
+                std::lock_guard<std::mutex> lock(resolved_mutex);
+                resolved.merge(entries);
+            } catch (const std::exception& e) {
+                spdlog::warn("[Fetcher]: InspireHEP batch lookup failed: {}", e.what());
+            }
+        }
+    };
+
+    const size_t n_workers = std::min(urls.size(), INSPIRE_MAX_IN_FLIGHT);
+    std::vector<std::thread> pool;
+    pool.reserve(n_workers);
+    for (size_t i = 0; i < n_workers; ++i)
+        pool.emplace_back(worker);
+    for (auto& t : pool)
+        t.join();
+
+    // InspireHEP may return records for ids we did not ask about (e.g. a
+    // cross-listed eprint matching a substring); keep only requested ids.
+    for (auto it = resolved.begin(); it != resolved.end();) {
+        if (std::binary_search(ids.begin(), ids.end(), it->first))
+            ++it;
+        else
+            it = resolved.erase(it);
+    }
+
+    spdlog::info("[Fetcher]: InspireHEP resolved {}/{} BibTeX entries in {} request(s)",
+                 resolved.size(),
+                 ids.size(),
+                 urls.size());
+    return resolved;
+}
+
+Fetcher::BibTeXMap Fetcher::ParseInspireBibTeX(const std::string& text) {
+    BibTeXMap entries;
+
+    // Entries start with '@' at the beginning of a line.
+    std::vector<size_t> starts;
+    for (size_t pos = 0; pos < text.size(); ++pos) {
+        if (text[pos] == '@' && (pos == 0 || text[pos - 1] == '\n'))
+            starts.push_back(pos);
+    }
+
+    for (size_t i = 0; i < starts.size(); ++i) {
+        size_t end = (i + 1 < starts.size()) ? starts[i + 1] : text.size();
+        std::string_view entry(text.data() + starts[i], end - starts[i]);
+
+        // Locate `eprint = "…"` (or `eprint = {…}`) as a field name, not as
+        // part of e.g. `archivePrefix` or a title word.
+        size_t field = std::string_view::npos;
+        for (size_t pos = entry.find("eprint"); pos != std::string_view::npos;
+             pos = entry.find("eprint", pos + 1)) {
+            bool at_field_start =
+                pos > 0 && (entry[pos - 1] == ' ' || entry[pos - 1] == '\t' ||
+                            entry[pos - 1] == '\n' || entry[pos - 1] == ',');
+            size_t eq = entry.find_first_not_of(" \t", pos + 6);
+            if (at_field_start && eq != std::string_view::npos && entry[eq] == '=') {
+                field = eq;
+                break;
+            }
+        }
+        if (field == std::string_view::npos)
+            continue;
+
+        size_t open = entry.find_first_not_of(" \t", field + 1);
+        if (open == std::string_view::npos || (entry[open] != '"' && entry[open] != '{'))
+            continue;
+        char close_ch = entry[open] == '"' ? '"' : '}';
+        size_t close = entry.find(close_ch, open + 1);
+        if (close == std::string_view::npos)
+            continue;
+
+        std::string eprint(entry.substr(open + 1, close - open - 1));
+        // Trim trailing blank lines between entries.
+        size_t last = entry.find_last_not_of(" \t\r\n");
+        entries.emplace(std::move(eprint), std::string(entry.substr(0, last + 1)) + "\n");
+    }
+    return entries;
+}
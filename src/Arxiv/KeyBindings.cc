@@ -26,7 +26,7 @@ struct ActionInfo {
 
 using Action = KeyBindings::Action;
 
-constexpr std::array<ActionInfo, 32> kActionTable = {{
+constexpr std::array<ActionInfo, 33> kActionTable = {{
     {Action::Next, "next", "j", "Next"},
     {Action::Previous, "previous", "k", "Previous"},
     {Action::Quit, "quit", "q", "Quit"},
@@ -59,6 +59,7 @@ constexpr std::array<ActionInfo, 32> kActionTable = {{
     {Action::ExportDigestArchive, "export_digest_archive", "G", "Export Digest Archive"},
     {Action::OpenInBrowser, "open_in_browser", "O", "Open in Browser"},
     {Action::RateSelection, "rate_selection", "W", "Rate Selection"},
+    {Action::ShowRelated, "show_related", "m", "Related Papers"},
 }};
 
 const ActionInfo* find_by_config_name(std::string_view name) {
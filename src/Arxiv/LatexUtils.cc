@@ -4,92 +4,470 @@
 
 #include "Arxiv/LatexUtils.hh"
 
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
 #include <string>
+#include <string_view>
 
 namespace Arxiv {
 
-std::string StripLatex(const std::string& text) {
-    std::string out;
-    out.reserve(text.size());
+namespace {
 
-    const std::size_t n = text.size();
-    std::size_t i = 0;
-
-    while (i < n) {
-        char c = text[i];
-
-        // ---------------------------------------------------------------
-        // Rule 1 & 2: Strip $...$ and $$...$$ math regions
-        // ---------------------------------------------------------------
-        if (c == '$') {
-            bool display = (i + 1 < n && text[i + 1] == '$');
-            const std::string_view close = display ? "$$" : "$";
-            std::size_t start = i + (display ? 2 : 1);
-            std::size_t end = text.find(close, start);
-            if (end == std::string::npos) {
-                // Unmatched — consume the dollar sign and continue
-                out += ' ';
-                ++i;
-            } else {
-                out += ' ';
-                i = end + close.size();
-            }
-            continue;
+// ---------------------------------------------------------------------------
+// Tables
+//
+// All three are sorted by key and searched with lower_bound, so the
+// transcoder does one lookup per command instead of one find() per entry.
+// ---------------------------------------------------------------------------
+
+// Accent macros: \'e, \"o, \c{c}, \v{s}, ... The letter may also be braced
+// (\'{e}), so both spellings hit the same entry.
+struct AccentEntry {
+    char accent;
+    char letter;
+    std::string_view glyph;
+};
+
+constexpr AccentEntry ACCENTS[] = {
+    {'"', 'A', "Ä"},
+    {'"', 'E', "Ë"},
+    {'"', 'I', "Ï"},
+    {'"', 'O', "Ö"},
+    {'"', 'U', "Ü"},
+    {'"', 'Y', "Ÿ"},
+    {'"', 'a', "ä"},
+    {'"', 'e', "ë"},
+    {'"', 'i', "ï"},
+    {'"', 'o', "ö"},
+    {'"', 'u', "ü"},
+    {'"', 'y', "ÿ"},
+    {'\'', 'A', "Á"},
+    {'\'', 'E', "É"},
+    {'\'', 'I', "Í"},
+    {'\'', 'O', "Ó"},
+    {'\'', 'U', "Ú"},
+    {'\'', 'Y', "Ý"},
+    {'\'', 'a', "á"},
+    {'\'', 'e', "é"},
+    {'\'', 'i', "í"},
+    {'\'', 'o', "ó"},
+    {'\'', 'u', "ú"},
+    {'\'', 'y', "ý"},
+    {'.', 'A', "Ȧ"},
+    {'.', 'B', "Ḃ"},
+    {'.', 'C', "Ċ"},
+    {'.', 'D', "Ḋ"},
+    {'.', 'E', "Ė"},
+    {'.', 'F', "Ḟ"},
+    {'.', 'G', "Ġ"},
+    {'.', 'H', "Ḣ"},
+    {'.', 'I', "İ"},
+    {'.', 'M', "Ṁ"},
+    {'.', 'N', "Ṅ"},
+    {'.', 'O', "Ȯ"},
+    {'.', 'P', "Ṗ"},
+    {'.', 'R', "Ṙ"},
+    {'.', 'S', "Ṡ"},
+    {'.', 'T', "Ṫ"},
+    {'.', 'W', "Ẇ"},
+    {'.', 'X', "Ẋ"},
+    {'.', 'Y', "Ẏ"},
+    {'.', 'Z', "Ż"},
+    {'.', 'a', "ȧ"},
+    {'.', 'b', "ḃ"},
+    {'.', 'c', "ċ"},
+    {'.', 'd', "ḋ"},
+    {'.', 'e', "ė"},
+    {'.', 'f', "ḟ"},
+    {'.', 'g', "ġ"},
+    {'.', 'h', "ḣ"},
+    {'.', 'i', "ı"},
+    {'.', 'm', "ṁ"},
+    {'.', 'n', "ṅ"},
+    {'.', 'o', "ȯ"},
+    {'.', 'p', "ṗ"},
+    {'.', 'r', "ṙ"},
+    {'.', 's', "ṡ"},
+    {'.', 't', "ṫ"},
+    {'.', 'w', "ẇ"},
+    {'.', 'x', "ẋ"},
+    {'.', 'y', "ẏ"},
+    {'.', 'z', "ż"},
+    {'^', 'A', "Â"},
+    {'^', 'E', "Ê"},
+    {'^', 'I', "Î"},
+    {'^', 'O', "Ô"},
+    {'^', 'U', "Û"},
+    {'^', 'a', "â"},
+    {'^', 'e', "ê"},
+    {'^', 'i', "î"},
+    {'^', 'o', "ô"},
+    {'^', 'u', "û"},
+    {'`', 'A', "À"},
+    {'`', 'E', "È"},
+    {'`', 'I', "Ì"},
+    {'`', 'O', "Ò"},
+    {'`', 'U', "Ù"},
+    {'`', 'a', "à"},
+    {'`', 'e', "è"},
+    {'`', 'i', "ì"},
+    {'`', 'o', "ò"},
+    {'`', 'u', "ù"},
+    {'c', 'C', "Ç"},
+    {'c', 'c', "ç"},
+    {'r', 'A', "Å"},
+    {'r', 'a', "å"},
+    {'v', 'A', "Ǎ"},
+    {'v', 'C', "Č"},
+    {'v', 'D', "Ď"},
+    {'v', 'E', "Ě"},
+    {'v', 'G', "Ğ"},
+    {'v', 'H', "Ȟ"},
+    {'v', 'I', "Ǐ"},
+    {'v', 'K', "Ǩ"},
+    {'v', 'L', "Ľ"},
+    {'v', 'N', "Ň"},
+    {'v', 'O', "Ǒ"},
+    {'v', 'R', "Ř"},
+    {'v', 'S', "Š"},
+    {'v', 'T', "Ť"},
+    {'v', 'U', "Ǔ"},
+    {'v', 'Z', "Ž"},
+    {'v', 'a', "ǎ"},
+    {'v', 'c', "č"},
+    {'v', 'd', "ď"},
+    {'v', 'e', "ě"},
+    {'v', 'g', "ğ"},
+    {'v', 'h', "ȟ"},
+    {'v', 'i', "ǐ"},
+    {'v', 'j', "ǰ"},
+    {'v', 'k', "ǩ"},
+    {'v', 'l', "ľ"},
+    {'v', 'n', "ň"},
+    {'v', 'o', "ǒ"},
+    {'v', 'r', "ř"},
+    {'v', 's', "š"},
+    {'v', 't', "ť"},
+    {'v', 'u', "ǔ"},
+    {'v', 'z', "ž"},
+    {'~', 'A', "Ã"},
+    {'~', 'N', "Ñ"},
+    {'~', 'O', "Õ"},
+    {'~', 'a', "ã"},
+    {'~', 'n', "ñ"},
+    {'~', 'o', "õ"},
+};
+
+// Letter macros: \ss, \o, \ae, ...
+struct LetterEntry {
+    std::string_view name;
+    std::string_view glyph;
+};
+
+constexpr LetterEntry LETTERS[] = {
+    {"AE", "Æ"},
+    {"DH", "Ð"},
+    {"L", "Ł"},
+    {"NG", "Ŋ"},
+    {"O", "Ø"},
+    {"OE", "Œ"},
+    {"SS", "ẞ"},
+    {"TH", "Þ"},
+    {"ae", "æ"},
+    {"dh", "ð"},
+    {"i", "ı"},
+    {"j", "ȷ"},
+    {"l", "ł"},
+    {"ng", "ŋ"},
+    {"o", "ø"},
+    {"oe", "œ"},
+    {"ss", "ß"},
+    {"th", "þ"},
+};
+
+// Text-style commands and their Markdown markers. Empty markers strip the
+// command and keep the content (no Markdown equivalent).
+struct StyleEntry {
+    std::string_view name;
+    std::string_view open;
+    std::string_view close;
+};
+
+constexpr StyleEntry STYLES[] = {
+    {"emph", "*", "*"},
+    {"overline", "", ""},
+    {"st", "~~", "~~"},
+    {"textbf", "**", "**"},
+    {"textdown", "", ""},
+    {"textit", "*", "*"},
+    {"textmd", "", ""},
+    {"textnormal", "", ""},
+    {"textrm", "", ""},
+    {"textsc", "", ""},
+    {"textsf", "", ""},
+    {"textsl", "*", "*"},
+    {"texttt", "`", "`"},
+    {"textup", "", ""},
+    {"underline", "", ""},
+};
+
+constexpr std::string_view ACCENT_SYMBOLS = "'`^~\".";
+constexpr std::string_view ACCENT_WORDS = "crv";
+
+// Brace nesting beyond this is copied through verbatim rather than recursed
+// into, so hostile input cannot exhaust the stack.
+constexpr int MAX_DEPTH = 64;
+
+const AccentEntry* find_accent(char accent, char letter) {
+    const auto* it = std::lower_bound(
+        std::begin(ACCENTS), std::end(ACCENTS), accent, [&](const AccentEntry& e, char a) {
+            return e.accent < a || (e.accent == a && e.letter < letter);
+        });
+    return it != std::end(ACCENTS) && it->accent == accent && it->letter == letter ? it : nullptr;
+}
+
+template <typename Entry, size_t N>
+const Entry* find_named(const Entry (&table)[N], std::string_view name) {
+    const auto* it = std::lower_bound(
+        std::begin(table), std::end(table), name, [](const Entry& e, std::string_view n) {
+            return e.name < n;
+        });
+    return it != std::end(table) && it->name == name ? it : nullptr;
+}
+
+bool is_alpha(char c) { return std::isalpha(static_cast<unsigned char>(c)) != 0; }
+
+// Position of the '}' matching the '{' at `open`, or npos.
+size_t matching_brace(std::string_view s, size_t open) {
+    int depth = 0;
+    for (size_t i = open; i < s.size(); ++i) {
+        if (s[i] == '{') {
+            ++depth;
+        } else if (s[i] == '}' && --depth == 0) {
+            return i;
+        } else if (s[i] == '\\' && i + 1 < s.size()) {
+            ++i; // \{ and \} are literal braces
         }
+    }
+    return std::string_view::npos;
+}
+
+// ---------------------------------------------------------------------------
+// Transcoder
+//
+// One left-to-right scan that writes the plain and/or Markdown rendering.
+// Runs of ordinary text between metacharacters are located with memchr and
+// appended in one go; only '\' and '$' enter the per-token logic.
+// ---------------------------------------------------------------------------
 
-        // ---------------------------------------------------------------
-        // Rule 3 & 4: Handle \cmd and \cmd{content}
-        // ---------------------------------------------------------------
-        if (c == '\\' && i + 1 < n && std::isalpha(static_cast<unsigned char>(text[i + 1]))) {
-            // Consume the command name
-            std::size_t j = i + 1;
-            while (j < n && std::isalpha(static_cast<unsigned char>(text[j])))
-                ++j;
-            // Check if followed by an optional star (e.g. \textbf*)
-            if (j < n && text[j] == '*')
-                ++j;
-
-            // Skip optional whitespace before '{'
-            std::size_t k = j;
-            while (k < n && text[k] == ' ')
-                ++k;
-
-            if (k < n && text[k] == '{') {
-                // Rule 3: \cmd{content} — replace with ' ' + content (brace-aware)
-                out += ' ';
-                ++k; // skip opening '{'
-                int depth = 1;
-                while (k < n && depth > 0) {
-                    if (text[k] == '{') {
-                        ++depth;
-                        if (depth > 1)
-                            out += text[k]; // keep inner { for nested
-                    } else if (text[k] == '}') {
-                        --depth;
-                        if (depth > 0)
-                            out += text[k];
-                    } else {
-                        out += text[k];
-                    }
-                    ++k;
-                }
-                i = k;
-            } else {
-                // Rule 4: bare \cmd — replace with space
-                out += ' ';
-                i = j;
+class Transcoder {
+  public:
+    // Either sink may be null. `styles` turns text-style commands into
+    // Markdown markers; when false they are copied through (accents only).
+    Transcoder(std::string* plain, std::string* markdown, bool styles)
+        : m_plain{plain}
+        , m_markdown{markdown}
+        , m_styles{styles} {}
+
+    void Run(std::string_view s, int depth = 0) {
+        const size_t n = s.size();
+        size_t next_slash = Find(s, '\\', 0);
+        size_t next_dollar = Find(s, '$', 0);
+        size_t i = 0;
+        while (i < n) {
+            if (next_slash < i)
+                next_slash = Find(s, '\\', i);
+            if (next_dollar < i)
+                next_dollar = Find(s, '$', i);
+            const size_t meta = std::min(next_slash, next_dollar);
+            if (meta == std::string_view::npos) {
+                Both(s.substr(i));
+                break;
             }
-            continue;
+            if (meta > i)
+                Both(s.substr(i, meta - i));
+            i = s[meta] == '$' ? Math(s, meta) : Command(s, meta, depth);
+        }
+    }
+
+  private:
+    std::string* m_plain;
+    std::string* m_markdown;
+    bool m_styles;
+
+    static size_t Find(std::string_view s, char c, size_t from) {
+        if (from >= s.size())
+            return std::string_view::npos;
+        const void* hit = std::memchr(s.data() + from, c, s.size() - from);
+        return hit ? static_cast<size_t>(static_cast<const char*>(hit) - s.data())
+                   : std::string_view::npos;
+    }
+
+    void Plain(std::string_view t) {
+        if (m_plain)
+            m_plain->append(t);
+    }
+    void Markdown(std::string_view t) {
+        if (m_markdown)
+            m_markdown->append(t);
+    }
+    void Both(std::string_view t) {
+        Plain(t);
+        Markdown(t);
+    }
+
+    // $...$ / $$...$$: dropped from plain text, kept verbatim in Markdown.
+    size_t Math(std::string_view s, size_t i) {
+        const bool display = i + 1 < s.size() && s[i + 1] == '$';
+        const std::string_view close = display ? "$$" : "$";
+        const size_t end = s.find(close, i + close.size());
+        Plain(" ");
+        if (end == std::string_view::npos) {
+            // Unmatched — consume the dollar sign and continue
+            Markdown("$");
+            return i + 1;
         }
+        Markdown(s.substr(i, end + close.size() - i));
+        return end + close.size();
+    }
 
-        // ---------------------------------------------------------------
-        // Ordinary character — pass through
-        // ---------------------------------------------------------------
-        out += c;
-        ++i;
+    // Accent on the letter at `j` (bare or braced). Returns the position past
+    // the macro, or npos if it is not a known accent.
+    size_t Accent(std::string_view s, char accent, size_t j) {
+        char letter = '\0';
+        size_t end = std::string_view::npos;
+        if (j + 2 < s.size() && s[j] == '{' && s[j + 2] == '}') {
+            letter = s[j + 1];
+            end = j + 3;
+        } else if (j < s.size() && s[j] != '{') {
+            letter = s[j];
+            end = j + 1;
+        }
+        const auto* hit = end == std::string_view::npos ? nullptr : find_accent(accent, letter);
+        if (!hit)
+            return std::string_view::npos;
+        Both(hit->glyph);
+        return end;
     }
 
+    size_t Command(std::string_view s, size_t i, int depth) {
+        const size_t n = s.size();
+        if (i + 1 >= n) {
+            Both("\\");
+            return n;
+        }
+        const char c = s[i + 1];
+
+        if (ACCENT_SYMBOLS.find(c) != std::string_view::npos) {
+            if (size_t end = Accent(s, c, i + 2); end != std::string_view::npos)
+                return end;
+        }
+
+        if (!is_alpha(c)) {
+            // Escaped character (\%, \&, \$, \\ ...): Markdown keeps the
+            // escape, plain text keeps the character.
+            Markdown(s.substr(i, 2));
+            Plain(c == '\\' ? std::string_view(" ") : s.substr(i + 1, 1));
+            return i + 2;
+        }
+
+        size_t j = i + 1;
+        while (j < n && is_alpha(s[j]))
+            ++j;
+        const std::string_view name = s.substr(i + 1, j - i - 1);
+
+        if (name.size() == 1 && ACCENT_WORDS.find(name[0]) != std::string_view::npos) {
+            if (size_t end = Accent(s, name[0], j); end != std::string_view::npos)
+                return end;
+        }
+
+        if (const auto* letter = find_named(LETTERS, name)) {
+            Both(letter->glyph);
+            // \ss{} — swallow the empty group that terminates the macro
+            return j + 1 < n && s[j] == '{' && s[j + 1] == '}' ? j + 2 : j;
+        }
+
+        // Optional star, then optional spaces before the argument.
+        const size_t after_name = j < n && s[j] == '*' ? j + 1 : j;
+        size_t k = after_name;
+        while (k < n && s[k] == ' ')
+            ++k;
+        const size_t close = k < n && s[k] == '{' ? matching_brace(s, k) : std::string_view::npos;
+
+        if (close == std::string_view::npos) {
+            // Bare \cmd: dropped from plain text, kept in Markdown.
+            Plain(" ");
+            Markdown(s.substr(i, after_name - i));
+            return after_name;
+        }
+
+        const std::string_view content = s.substr(k + 1, close - k - 1);
+        const auto* style = m_styles ? find_named(STYLES, name) : nullptr;
+        Plain(" ");
+        Markdown(style ? style->open : s.substr(i, k + 1 - i));
+        if (depth < MAX_DEPTH) {
+            Run(content, depth + 1);
+        } else {
+            Both(content);
+        }
+        Markdown(style ? style->close : std::string_view("}"));
+        return close + 1;
+    }
+};
+
+} // namespace
+
+bool HasLatexMarkup(std::string_view text) {
+    return std::memchr(text.data(), '\\', text.size()) != nullptr ||
+           std::memchr(text.data(), '$', text.size()) != nullptr;
+}
+
+LatexForms TranscodeLatex(std::string_view text) {
+    LatexForms forms;
+    if (!HasLatexMarkup(text)) {
+        forms.plain.assign(text);
+        forms.markdown.assign(text);
+        return forms;
+    }
+    forms.plain.reserve(text.size());
+    forms.markdown.reserve(text.size());
+    Transcoder(&forms.plain, &forms.markdown, true).Run(text);
+    return forms;
+}
+
+std::string StripLatex(std::string_view text) {
+    std::string out;
+    StripLatex(text, out);
+    return out;
+}
+
+void StripLatex(std::string_view text, std::string& out) {
+    out.clear();
+    if (!HasLatexMarkup(text)) {
+        out.assign(text);
+        return;
+    }
+    out.reserve(text.size());
+    Transcoder(&out, nullptr, true).Run(text);
+}
+
+std::string LatexToMarkdown(std::string_view text) {
+    if (!HasLatexMarkup(text))
+        return std::string(text);
+    std::string out;
+    out.reserve(text.size());
+    Transcoder(nullptr, &out, true).Run(text);
+    return out;
+}
+
+std::string ReplaceLatexAccents(std::string_view text) {
+    if (!HasLatexMarkup(text))
+        return std::string(text);
+    std::string out;
+    out.reserve(text.size());
+    Transcoder(nullptr, &out, false).Run(text);
     return out;
 }
 
@@ -4,56 +4,245 @@
 
 #include "Arxiv/Ranker.hh"
 
+#include "Arxiv/Hash.hh"
 #include "Arxiv/LatexUtils.hh"
+#include "Arxiv/Simd.hh"
+#include "Arxiv/Tokeniser.hh"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <random>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "spdlog/spdlog.h"
 
 namespace Arxiv {
 
+// Fewest articles worth handing a PredictBatch worker of its own; below
+// this the thread start-up costs more than it saves.
+static constexpr size_t PREDICT_CHUNK = 128;
+
+// Fewest samples of a training mini-batch worth handing a worker; caps the
+// pool at BATCH_SIZE / TRAIN_SLICE threads.
+static constexpr size_t TRAIN_SLICE = 8;
+
 // ---------------------------------------------------------------------------
-// Stop-word list (common English words unlikely to be informative)
+// Training workers
 // ---------------------------------------------------------------------------
-static const std::unordered_set<std::string> STOP_WORDS = {
-    "a",       "an",     "the",   "and",    "or",   "of",    "in",    "on",     "to",
-    "is",      "are",    "was",   "were",   "be",   "been",  "being", "have",   "has",
-    "had",     "do",     "does",  "did",    "will", "would", "could", "should", "may",
-    "might",   "shall",  "can",   "for",    "from", "with",  "this",  "that",   "these",
-    "those",   "it",     "its",   "as",     "at",   "by",    "if",    "so",     "we",
-    "our",     "us",     "not",   "no",     "but",  "than",  "then",  "when",   "where",
-    "which",   "who",    "how",   "all",    "also", "more",  "into",  "about",  "such",
-    "their",   "they",   "them",  "what",   "each", "other", "some",  "any",    "both",
-    "through", "during", "up",    "down",   "out",  "over",  "under", "again",  "further",
-    "between", "while",  "after", "before", "only", "own",   "same",  "too",    "very",
-    "s",       "t",      "just",  "don",    "now",  "i",     "you",   "he",     "she"};
+
+namespace {
+
+// Threads that run one job at a time on every worker, the calling thread
+// acting as worker 0. Lives for one Train call, so each mini-batch costs a
+// wake-up and a wait rather than thread start-ups.
+class WorkerPool {
+  public:
+    using Job = std::function<void(size_t worker)>;
+
+    explicit WorkerPool(size_t workers) {
+        m_threads.reserve(workers - 1);
+        for (size_t w = 1; w < workers; ++w)
+            m_threads.emplace_back([this, w] { Loop(w); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& t : m_threads)
+            t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Run `job(w)` for every worker w and wait for all of them.
+    void Run(const Job& job) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            m_pending = m_threads.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+        job(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0; });
+    }
+
+  private:
+    void Loop(size_t worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            const Job* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop)
+                    return;
+                seen = m_generation;
+                job = m_job;
+            }
+            (*job)(worker);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0)
+                m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const Job* m_job = nullptr;
+    uint64_t m_generation = 0;
+    size_t m_pending = 0;
+    bool m_stop = false;
+};
+
+} // namespace
+
+// Per-thread buffers, kept across calls so that once they have grown to fit,
+// vectorising and scoring an article does not allocate.
+struct Ranker::Scratch {
+    Tokeniser tokenise;
+    std::string key; // m_vocab / TermDictionary lookups
+    SparseVector x;
+    std::vector<float> hidden;
+    // PredictKeyword
+    std::string text, stripped;
+    std::vector<uint8_t> keyword_seen;
+};
+
+Ranker::Scratch& Ranker::ThreadScratch() {
+    thread_local Scratch scratch;
+    return scratch;
+}
+
+// Gradient accumulators and activation buffers for one training worker.
+// First-layer gradients are kept only for the W1 rows a batch touches, so a
+// shard stays small even when hashing makes W1 large. Everything keeps its
+// capacity between batches.
+struct Ranker::Gradients {
+    Gradients(size_t features, size_t hidden)
+        : units(hidden)
+        , slot(features, -1)
+        , db1(hidden, 0.0f)
+        , dW2(hidden, 0.0f)
+        , h(hidden, 0.0f)
+        , d_h(hidden, 0.0f) {}
+
+    // Accumulator for W1 row `k`, zeroed on first use.
+    float* Row(int k) {
+        int& s = slot[static_cast<size_t>(k)];
+        if (s < 0) {
+            s = static_cast<int>(rows.size());
+            rows.push_back(k);
+            dW1.resize(dW1.size() + units, 0.0f);
+        }
+        return &dW1[static_cast<size_t>(s) * units];
+    }
+
+    // Add `other`'s gradients to these and clear it.
+    void Absorb(Gradients& other) {
+        for (size_t r = 0; r < other.rows.size(); ++r)
+            Simd::Axpy(units, 1.0f, &other.dW1[r * units], Row(other.rows[r]));
+        Simd::Axpy(units, 1.0f, other.db1.data(), db1.data());
+        Simd::Axpy(units, 1.0f, other.dW2.data(), dW2.data());
+        db2 += other.db2;
+        other.Clear();
+    }
+
+    void Clear() {
+        for (int k : rows)
+            slot[static_cast<size_t>(k)] = -1;
+        rows.clear();
+        dW1.clear();
+        std::fill(db1.begin(), db1.end(), 0.0f);
+        std::fill(dW2.begin(), dW2.end(), 0.0f);
+        db2 = 0.0f;
+    }
+
+    size_t units;           // hidden units
+    std::vector<int> slot;  // W1 row → its block of dW1, or -1
+    std::vector<int> rows;  // W1 rows touched, in first-touch order
+    std::vector<float> dW1; // rows.size() × units
+    std::vector<float> db1;
+    std::vector<float> dW2;
+    float db2 = 0.0f;
+    float loss = 0.0f; // summed squared error, reset by the caller
+    std::vector<float> h;
+    std::vector<float> d_h;
+};
 
 // ---------------------------------------------------------------------------
 // Ranker constructor
 // ---------------------------------------------------------------------------
 Ranker::Ranker() { InitWeights(); }
 
+Ranker::Ranker(int hash_bits) {
+    if (hash_bits > 0) {
+        m_hash_bits = std::clamp(hash_bits, MIN_HASH_BITS, MAX_HASH_BITS);
+        m_features = size_t{1} << m_hash_bits;
+    }
+    InitWeights();
+}
+
+void Ranker::SetHyperparameters(const Hyperparameters& params) {
+    m_params.hidden = std::clamp(params.hidden, MIN_HIDDEN, MAX_HIDDEN);
+    m_params.learning_rate = std::clamp(params.learning_rate, 1e-5f, 1.0f);
+    m_params.epochs = std::max(params.epochs, 1);
+    m_params.max_features = std::clamp(params.max_features, MIN_VOCABULARY, MAX_VOCABULARY);
+    if (!IsHashed() && m_features != static_cast<size_t>(m_params.max_features)) {
+        m_features = static_cast<size_t>(m_params.max_features);
+        m_vocab.clear();
+        m_idf.clear();
+    }
+    m_trained = false;
+    InitWeights();
+}
+
 void Ranker::InitWeights() {
     std::mt19937 rng(42);
     // Xavier initialisation
-    float scale_1 = std::sqrt(2.0f / MAX_FEATURES);
-    float scale_2 = std::sqrt(2.0f / HIDDEN_SIZE);
+    float scale_1 = std::sqrt(2.0f / static_cast<float>(m_features));
+    float scale_2 = std::sqrt(2.0f / static_cast<float>(m_params.hidden));
     std::normal_distribution<float> dist1(0.0f, scale_1);
     std::normal_distribution<float> dist2(0.0f, scale_2);
 
-    m_W1.resize(static_cast<size_t>(HIDDEN_SIZE * MAX_FEATURES));
-    m_b1.assign(static_cast<size_t>(HIDDEN_SIZE), 0.0f);
-    m_W2.resize(static_cast<size_t>(HIDDEN_SIZE));
+    const size_t units = Units();
+    m_mapping.reset();
+    m_W1q.clear();
+    m_W1q_scale.clear();
+    m_W1.resize(m_features * units);
+    m_b1.assign(units, 0.0f);
+    m_W2.resize(units);
     m_b2 = 0.0f;
 
-    for (auto& w : m_W1)
-        w = dist1(rng);
+    // Draw in hidden-major order so a given seed yields the same network
+    // regardless of the in-memory layout.
+    for (size_t j = 0; j < units; ++j)
+        for (size_t k = 0; k < m_features; ++k)
+            m_W1[k * units + j] = dist1(rng);
     for (auto& w : m_W2)
         w = dist2(rng);
 }
@@ -61,124 +250,314 @@ void Ranker::InitWeights() {
 // ---------------------------------------------------------------------------
 // Text helpers
 // ---------------------------------------------------------------------------
-std::vector<std::string> Ranker::Tokenise(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::string tok;
-    const std::string clean = StripLatex(text);
-    for (char c : clean) {
-        if (std::isalnum(static_cast<unsigned char>(c))) {
-            tok += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-        } else {
-            if (!tok.empty()) {
-                if (tok.size() > 2 && !IsStopWord(tok)) {
-                    tokens.push_back(tok);
-                }
-                tok.clear();
+// Bigrams are interned as "first second"; tokens never contain a space.
+static bool is_bigram(const std::string& term) { return term.find(' ') != std::string::npos; }
+
+TermList Ranker::Terms(const Article& article, TermDictionary& dict, bool bigrams) {
+    Scratch& s = ThreadScratch();
+    std::vector<TermCount> hits;
+    auto add_field = [&](const std::string& text, uint32_t weight) {
+        const auto& tokens = s.tokenise(text);
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            s.key.assign(tokens[i]);
+            hits.push_back({dict.Intern(s.key), weight});
+            if (bigrams && i > 0) {
+                s.key.assign(tokens[i - 1]).append(" ").append(tokens[i]);
+                hits.push_back({dict.Intern(s.key), weight});
             }
         }
+    };
+    add_field(article.title, TITLE_WEIGHT);
+    add_field(article.abstract, 1);
+
+    std::sort(hits.begin(), hits.end(), [](const TermCount& a, const TermCount& b) {
+        return a.term < b.term;
+    });
+    TermList terms;
+    for (const auto& h : hits) {
+        if (!terms.empty() && terms.back().term == h.term)
+            terms.back().count += h.count;
+        else
+            terms.push_back(h);
     }
-    if (!tok.empty() && tok.size() > 2 && !IsStopWord(tok)) {
-        tokens.push_back(tok);
+    return terms;
+}
+
+uint64_t Ranker::TokeniserHash(bool bigrams) {
+    // Bump the tag whenever Terms() changes what it emits.
+    static const uint64_t with_bigrams =
+        Hash::Fnv1a("terms/1 bigrams title_weight=" + std::to_string(TITLE_WEIGHT),
+                    Tokeniser::Fingerprint());
+    static const uint64_t without_bigrams =
+        Hash::Fnv1a("terms/1 title_weight=" + std::to_string(TITLE_WEIGHT),
+                    Tokeniser::Fingerprint());
+    return bigrams ? with_bigrams : without_bigrams;
+}
+
+uint64_t Ranker::VocabularyHash() const {
+    if (IsHashed())
+        return Hash::Fnv1a("hashed/" + std::to_string(m_hash_bits));
+
+    std::vector<const std::string*> by_column(m_vocab.size());
+    for (const auto& [term, idx] : m_vocab)
+        by_column[static_cast<size_t>(idx)] = &term;
+    uint64_t h = Hash::FNV_OFFSET;
+    for (size_t i = 0; i < by_column.size(); ++i) {
+        uint32_t idf_bits = 0;
+        std::memcpy(&idf_bits, &m_idf[i], sizeof(idf_bits));
+        h = Hash::Fnv1a(*by_column[i] + ' ', Hash::Mix(h ^ idf_bits));
     }
-    return tokens;
+    return h;
 }
 
-bool Ranker::IsStopWord(const std::string& word) { return STOP_WORDS.count(word) > 0; }
+Ranker::Column Ranker::HashedColumn(uint64_t term_hash) const {
+    // FNV-1a's low bits are weak; the finaliser spreads them before the
+    // column is masked off, and the top bit picks the sign.
+    const uint64_t h = Hash::Mix(term_hash);
+    return {static_cast<int>(h & (m_features - 1)), (h >> 63) != 0 ? -1.0f : 1.0f};
+}
+
+void Ranker::MapColumns(const TermDictionary& dict, ColumnMap& columns) const {
+    columns.reserve(dict.Size());
+    for (size_t id = columns.size(); id < dict.Size(); ++id) {
+        const std::string& term = dict.Term(static_cast<uint32_t>(id));
+        if (IsHashed()) {
+            columns.push_back(HashedColumn(Hash::Fnv1a(term)));
+            continue;
+        }
+        auto it = m_vocab.find(term);
+        if (it == m_vocab.end())
+            columns.push_back({});
+        else
+            columns.push_back({it->second, m_idf[static_cast<size_t>(it->second)]});
+    }
+}
 
 // ---------------------------------------------------------------------------
 // FitVocabulary — build vocab and IDF from corpus
 // ---------------------------------------------------------------------------
 void Ranker::FitVocabulary(const std::vector<Article>& articles) {
-    if (articles.empty())
+    if (articles.empty() || IsHashed())
         return;
 
     // Count document frequency per term
+    Tokeniser tokenise;
     std::unordered_map<std::string, int> df;
+    std::unordered_set<std::string> seen;
     for (const auto& a : articles) {
-        auto tokens = Tokenise(a.title + " " + a.abstract);
-        std::unordered_set<std::string> seen(tokens.begin(), tokens.end());
+        seen.clear();
+        for (auto t : tokenise(a.title))
+            seen.emplace(t);
+        for (auto t : tokenise(a.abstract))
+            seen.emplace(t);
         for (const auto& t : seen) {
             df[t]++;
         }
     }
 
-    // Sort terms by document frequency (descending) and keep top MAX_FEATURES
     std::vector<std::pair<int, std::string>> sorted_df;
     sorted_df.reserve(df.size());
     for (const auto& [term, count] : df) {
         sorted_df.emplace_back(count, term);
     }
-    std::sort(sorted_df.rbegin(), sorted_df.rend());
+    BuildVocabulary(std::move(sorted_df), articles.size());
+}
+
+void Ranker::FitVocabulary(const std::vector<TermList>& docs, const TermDictionary& dict) {
+    if (docs.empty() || IsHashed())
+        return;
+
+    // Each TermList holds a term at most once, so counting entries counts
+    // documents.
+    std::vector<int> df(dict.Size(), 0);
+    for (const auto& doc : docs)
+        for (const auto& t : doc)
+            df[t.term]++;
+
+    // The vocabulary is unigrams only, as in the Article overload.
+    std::vector<std::pair<int, std::string>> sorted_df;
+    for (uint32_t id = 0; id < df.size(); ++id) {
+        if (df[id] > 0 && !is_bigram(dict.Term(id)))
+            sorted_df.emplace_back(df[id], dict.Term(id));
+    }
+    BuildVocabulary(std::move(sorted_df), docs.size());
+}
+
+void Ranker::FitVocabulary(std::vector<std::pair<int, std::string>> df, size_t n_docs) {
+    if (n_docs == 0 || IsHashed())
+        return;
+    BuildVocabulary(std::move(df), n_docs);
+}
+
+void Ranker::BuildVocabulary(std::vector<std::pair<int, std::string>> df, size_t n_docs) {
+    // Sort terms by document frequency (descending) and keep the top
+    // m_features
+    std::sort(df.rbegin(), df.rend());
 
-    int vocab_size = std::min(static_cast<int>(sorted_df.size()), MAX_FEATURES);
+    int vocab_size = std::min(static_cast<int>(df.size()), m_params.max_features);
     m_vocab.clear();
-    m_idf.assign(static_cast<size_t>(MAX_FEATURES), 0.0f);
+    m_idf.assign(m_features, 0.0f);
 
-    float N = static_cast<float>(articles.size());
+    float N = static_cast<float>(n_docs);
     for (int i = 0; i < vocab_size; ++i) {
-        const auto& [count, term] = sorted_df[static_cast<size_t>(i)];
+        const auto& [count, term] = df[static_cast<size_t>(i)];
         m_vocab[term] = i;
         m_idf[static_cast<size_t>(i)] =
             std::log((N + 1.0f) / (static_cast<float>(count) + 1.0f)) + 1.0f;
     }
 
-    spdlog::info(
-        "[Ranker]: Vocabulary fitted with {} terms from {} articles", vocab_size, articles.size());
+    spdlog::info("[Ranker]: Vocabulary fitted with {} terms from {} articles", vocab_size, n_docs);
 }
 
 // ---------------------------------------------------------------------------
-// Vectorise — produce a normalised TF-IDF feature vector
+// Vectorise — produce a normalised sparse TF-IDF feature vector
 // ---------------------------------------------------------------------------
-std::vector<float> Ranker::Vectorise(const Article& article) const {
-    std::vector<float> vec(static_cast<size_t>(MAX_FEATURES), 0.0f);
+void Ranker::Vectorise(const Article& article, SparseVector& vec) const {
+    vec.clear();
+    Scratch& s = ThreadScratch();
+    if (IsHashed()) {
+        // Hashing a bigram continues the first token's FNV stream through
+        // " " and the second token, which equals hashing "first second" as
+        // Terms() interns it — without building the string.
+        auto add_field = [&](const std::string& text, float weight) {
+            uint64_t prev = 0;
+            const auto& tokens = s.tokenise(text);
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                const uint64_t h = Hash::Fnv1a(tokens[i]);
+                const Column unigram = HashedColumn(h);
+                vec.push_back({unigram.index, unigram.weight * weight});
+                if (i > 0) {
+                    const Column bigram =
+                        HashedColumn(Hash::Fnv1a(tokens[i], Hash::Fnv1a(" ", prev)));
+                    vec.push_back({bigram.index, bigram.weight * weight});
+                }
+                prev = h;
+            }
+        };
+        add_field(article.title, static_cast<float>(TITLE_WEIGHT));
+        add_field(article.abstract, 1.0f);
+        Compact(vec);
+        Normalise(vec);
+        return;
+    }
     if (m_vocab.empty())
-        return vec;
+        return;
 
-    auto tokens = Tokenise(article.title + " " + article.title + " " + article.abstract);
-    // title repeated to give it more weight
-    std::unordered_map<std::string, int> tf;
-    for (const auto& t : tokens)
-        tf[t]++;
+    // Term counts first, title terms weighted to give the title more
+    // influence; IDF is applied once per distinct term after merging.
+    auto add_field = [&](const std::string& text, float weight) {
+        for (auto t : s.tokenise(text)) {
+            s.key.assign(t);
+            auto it = m_vocab.find(s.key);
+            if (it != m_vocab.end())
+                vec.push_back({it->second, weight});
+        }
+    };
+    add_field(article.title, static_cast<float>(TITLE_WEIGHT));
+    add_field(article.abstract, 1.0f);
+    Compact(vec);
+    for (auto& f : vec)
+        f.value *= m_idf[static_cast<size_t>(f.index)];
+    Normalise(vec);
+}
 
-    float norm = 0.0f;
-    for (const auto& [term, count] : tf) {
-        auto it = m_vocab.find(term);
-        if (it == m_vocab.end())
+void Ranker::Vectorise(const TermList& terms, const ColumnMap& columns, SparseVector& vec) const {
+    vec.clear();
+    for (const auto& t : terms) {
+        if (t.term >= columns.size())
             continue;
-        int idx = it->second;
-        float val = static_cast<float>(count) * m_idf[static_cast<size_t>(idx)];
-        vec[static_cast<size_t>(idx)] = val;
-        norm += val * val;
+        const Column& col = columns[t.term];
+        if (col.index >= 0)
+            vec.push_back({col.index, static_cast<float>(t.count) * col.weight});
+    }
+    Compact(vec);
+    Normalise(vec);
+}
+
+void Ranker::Compact(SparseVector& vec) {
+    // Index order keeps the weight rows visited in memory order, and the
+    // norm is summed in that order so every input path gives the same bits.
+    std::sort(vec.begin(), vec.end(), [](const Feature& a, const Feature& b) {
+        return a.index < b.index;
+    });
+    // Entries sharing a column are signed integer counts at this point (or
+    // IDF-weighted terms, which never repeat), so the sums are exact
+    // whatever order they arrive in.
+    size_t out = 0;
+    for (size_t i = 0; i < vec.size(); ++i) {
+        if (out > 0 && vec[out - 1].index == vec[i].index)
+            vec[out - 1].value += vec[i].value;
+        else
+            vec[out++] = vec[i];
+        if (vec[out - 1].value == 0.0f)
+            --out;
     }
+    vec.resize(out);
+}
+
+void Ranker::Normalise(SparseVector& vec) {
+    float norm = 0.0f;
+    for (const auto& f : vec)
+        norm += f.value * f.value;
     if (norm > 0.0f) {
         norm = std::sqrt(norm);
-        for (auto& v : vec)
-            v /= norm;
+        for (auto& f : vec)
+            f.value /= norm;
     }
-    return vec;
 }
 
 // ---------------------------------------------------------------------------
 // Forward pass
 // ---------------------------------------------------------------------------
-float Ranker::Forward(const std::vector<float>& x, std::vector<float>& hidden_out) const {
-    hidden_out.assign(static_cast<size_t>(HIDDEN_SIZE), 0.0f);
-
-    // Hidden layer: h = ReLU(W1 * x + b1)
-    for (int j = 0; j < HIDDEN_SIZE; ++j) {
-        float sum = m_b1[static_cast<size_t>(j)];
-        for (int k = 0; k < MAX_FEATURES; ++k) {
-            sum += m_W1[static_cast<size_t>(j * MAX_FEATURES + k)] * x[static_cast<size_t>(k)];
-        }
-        hidden_out[static_cast<size_t>(j)] = ReLU(sum);
-    }
+float Ranker::Forward(const SparseVector& x, std::vector<float>& hidden_out) const {
+    hidden_out.resize(Units());
+    Hidden(x, hidden_out.data());
 
     // Output layer: y = W2 · h + b2
-    float out = m_b2;
-    for (int j = 0; j < HIDDEN_SIZE; ++j) {
-        out += m_W2[static_cast<size_t>(j)] * hidden_out[static_cast<size_t>(j)];
+    return m_b2 + Simd::Dot(Units(), m_W2.data(), hidden_out.data());
+}
+
+// Round half away from zero, inline rather than a libm call: it runs once
+// per non-zero input when scoring quantised.
+static int round_to_int(float v) { return static_cast<int>(v + (v < 0.0f ? -0.5f : 0.5f)); }
+
+void Ranker::Hidden(const SparseVector& x, float* h) const {
+    const Simd::Kernels& simd = Simd::Active();
+    const size_t units = Units();
+    std::copy(m_b1.begin(), m_b1.end(), h);
+
+    if (IsQuantised()) {
+        // The inputs are quantised against the largest of them, so the
+        // whole sum runs in int32 and each hidden unit is rescaled once.
+        // The pass finding the largest also requests every row this article
+        // reads (one cache line each), so with a large feature space the
+        // misses overlap instead of arriving one at a time.
+        const int8_t* W1q = W1qData();
+        const float* scale = W1qScale();
+        float peak = 0.0f;
+        for (const auto& [k, v] : x) {
+            __builtin_prefetch(W1q + static_cast<size_t>(k) * units);
+            peak = std::max(peak, std::abs(v));
+        }
+        if (peak > 0.0f) {
+            const float step = peak / 127.0f, inv_step = 127.0f / peak;
+            std::array<int32_t, MAX_HIDDEN> acc{};
+            for (const auto& [k, v] : x) {
+                const auto a = static_cast<int8_t>(round_to_int(v * inv_step));
+                if (a != 0)
+                    simd.axpy_i8(units, a, W1q + static_cast<size_t>(k) * units, acc.data());
+            }
+            for (size_t j = 0; j < units; ++j)
+                h[j] += step * scale[j] * static_cast<float>(acc[j]);
+        }
+    } else {
+        // Accumulated one non-zero input (one W1 row) at a time.
+        const float* W1 = W1Data();
+        for (const auto& [k, v] : x)
+            simd.axpy(units, v, W1 + static_cast<size_t>(k) * units, h);
     }
-    return out;
+    for (size_t j = 0; j < units; ++j)
+        h[j] = ReLU(h[j]);
 }
 
 // ---------------------------------------------------------------------------
@@ -200,13 +579,49 @@ float Ranker::NormaliseTarget(float rating) {
 }
 
 // ---------------------------------------------------------------------------
-// Train — SGD on the rated articles
+// Train — mini-batch SGD on the rated articles
 // ---------------------------------------------------------------------------
-void Ranker::Train(const std::vector<std::pair<Article, int>>& rated, bool warm_start) {
-    if (static_cast<int>(rated.size()) < MIN_TRAIN) {
+bool Ranker::Train(const std::vector<std::pair<Article, int>>& rated,
+                   bool warm_start,
+                   const CancellationToken* cancel,
+                   unsigned max_threads) {
+    // Pre-vectorise all training samples
+    std::vector<SparseVector> X;
+    std::vector<float> y_target;
+    X.reserve(rated.size());
+    y_target.reserve(rated.size());
+    for (const auto& [article, rating] : rated) {
+        Vectorise(article, X.emplace_back());
+        y_target.push_back(NormaliseTarget(static_cast<float>(rating)));
+    }
+    return TrainVectors(X, y_target, warm_start, cancel, max_threads);
+}
+
+bool Ranker::Train(const std::vector<std::pair<TermList, int>>& rated,
+                   const ColumnMap& columns,
+                   bool warm_start,
+                   const CancellationToken* cancel,
+                   unsigned max_threads) {
+    std::vector<SparseVector> X;
+    std::vector<float> y_target;
+    X.reserve(rated.size());
+    y_target.reserve(rated.size());
+    for (const auto& [terms, rating] : rated) {
+        Vectorise(terms, columns, X.emplace_back());
+        y_target.push_back(NormaliseTarget(static_cast<float>(rating)));
+    }
+    return TrainVectors(X, y_target, warm_start, cancel, max_threads);
+}
+
+bool Ranker::TrainVectors(const std::vector<SparseVector>& X,
+                          const std::vector<float>& y_target,
+                          bool warm_start,
+                          const CancellationToken* cancel,
+                          unsigned max_threads) {
+    if (static_cast<int>(X.size()) < MIN_TRAIN) {
         spdlog::info(
-            "[Ranker]: Not enough rated articles to train ({} < {})", rated.size(), MIN_TRAIN);
-        return;
+            "[Ranker]: Not enough rated articles to train ({} < {})", X.size(), MIN_TRAIN);
+        return false;
     }
 
     if (!warm_start) {
@@ -214,86 +629,222 @@ void Ranker::Train(const std::vector<std::pair<Article, int>>& rated, bool warm_
         InitWeights();
     } else {
         spdlog::info("[Ranker]: Warm-start — continuing from existing weights");
+        OwnWeights();
     }
 
-    // Pre-vectorise all training samples
-    std::vector<std::vector<float>> X;
-    std::vector<float> y_target;
-    X.reserve(rated.size());
-    y_target.reserve(rated.size());
-    for (const auto& [article, rating] : rated) {
-        X.push_back(Vectorise(article));
-        y_target.push_back(NormaliseTarget(static_cast<float>(rating)));
-    }
+    const size_t n = X.size();
 
-    const int n = static_cast<int>(X.size());
+    // One shuffle picks the validation split; the training part is
+    // reshuffled every epoch.
+    std::mt19937 rng(42);
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::shuffle(order.begin(), order.end(), rng);
+    const size_t n_val =
+        n >= static_cast<size_t>(MIN_VALIDATION)
+            ? std::max<size_t>(1, static_cast<size_t>(static_cast<float>(n) * VALIDATION_FRACTION))
+            : 0;
+    const std::vector<size_t> validation(order.begin(), order.begin() + std::ptrdiff_t(n_val));
+    std::vector<size_t> train(order.begin() + std::ptrdiff_t(n_val), order.end());
+
+    size_t workers = max_threads > 0 ? max_threads : std::thread::hardware_concurrency();
+    workers = std::min({workers,
+                        static_cast<size_t>(BATCH_SIZE) / TRAIN_SLICE,
+                        (n + TRAIN_SLICE - 1) / TRAIN_SLICE});
+    workers = std::max<size_t>(1, workers);
+    WorkerPool pool(workers);
+    std::vector<Gradients> shards(workers, Gradients(m_features, Units()));
+
+    // The mini-batch in flight: sample indices, split evenly over workers.
+    const size_t* batch = nullptr;
+    size_t batch_len = 0;
+    const WorkerPool::Job backprop = [&](size_t w) {
+        Gradients& g = shards[w];
+        const float scale = 2.0f / static_cast<float>(batch_len);
+        for (size_t b = batch_len * w / workers; b < batch_len * (w + 1) / workers; ++b)
+            g.loss += Backprop(X[batch[b]], y_target[batch[b]], scale, g);
+    };
+    const WorkerPool::Job validate = [&](size_t w) {
+        Gradients& g = shards[w];
+        for (size_t b = n_val * w / workers; b < n_val * (w + 1) / workers; ++b) {
+            const size_t i = validation[b];
+            float err = Forward(X[i], g.h) - y_target[i];
+            g.loss += err * err;
+        }
+    };
+    // Sum of every shard's loss, in worker order; resets them.
+    auto take_loss = [&shards] {
+        float total = 0.0f;
+        for (auto& g : shards) {
+            total += g.loss;
+            g.loss = 0.0f;
+        }
+        return total;
+    };
+
+    // One epoch of SGD over `samples`, reshuffled first; returns the mean
+    // training loss.
+    auto run_epoch = [&](std::vector<size_t>& samples) {
+        std::shuffle(samples.begin(), samples.end(), rng);
+        for (size_t start = 0; start < samples.size(); start += static_cast<size_t>(BATCH_SIZE)) {
+            batch = &samples[start];
+            batch_len = std::min(static_cast<size_t>(BATCH_SIZE), samples.size() - start);
+            pool.Run(backprop);
+
+            // Reduce into shard 0 in worker order, so the sums do not depend
+            // on which worker finished first.
+            for (size_t w = 1; w < workers; ++w)
+                shards[0].Absorb(shards[w]);
+            Step(shards[0]);
+        }
+        return take_loss() / static_cast<float>(samples.size());
+    };
+
+    int epochs = m_params.epochs;
+    if (n_val > 0) {
+        // Early stopping only picks the epoch count: the weights are then
+        // refitted from the same start on every rating, held-out ones
+        // included, rather than copied at each improvement.
+        std::vector<float> start_W1, start_b1, start_W2;
+        const float start_b2 = m_b2;
+        if (warm_start) {
+            start_W1 = m_W1;
+            start_b1 = m_b1;
+            start_W2 = m_W2;
+        }
 
-    // Gradient buffers
-    std::vector<float> dW1(m_W1.size(), 0.0f);
-    std::vector<float> db1(m_b1.size(), 0.0f);
-    std::vector<float> dW2(m_W2.size(), 0.0f);
-    float db2 = 0.0f;
+        float best_loss = std::numeric_limits<float>::infinity();
+        int best_epochs = 0;
+        int stale = 0;
+        for (int epoch = 0; epoch < m_params.epochs; ++epoch) {
+            if (CancellationToken::IsCancelled(cancel)) {
+                spdlog::info("[Ranker]: Training cancelled at epoch {}", epoch);
+                return false;
+            }
+            const float train_loss = run_epoch(train);
+            if (epoch % 50 == 0)
+                spdlog::debug("[Ranker]: Epoch {} — MSE loss = {:.4f}", epoch, train_loss);
+
+            pool.Run(validate);
+            const float val_loss = take_loss() / static_cast<float>(n_val);
+            if (val_loss < best_loss) {
+                best_loss = val_loss;
+                best_epochs = epoch + 1;
+                stale = 0;
+            } else if (++stale >= PATIENCE) {
+                break;
+            }
+        }
+        spdlog::info("[Ranker]: Validation MSE {:.4f} on {} held-out ratings after {} epochs; "
+                     "refitting on all {}",
+                     best_loss,
+                     n_val,
+                     best_epochs,
+                     n);
+
+        epochs = best_epochs;
+        if (warm_start) {
+            m_W1 = std::move(start_W1);
+            m_b1 = std::move(start_b1);
+            m_W2 = std::move(start_W2);
+            m_b2 = start_b2;
+        } else {
+            InitWeights();
+        }
+        train = order;
+    }
 
-    for (int epoch = 0; epoch < EPOCHS; ++epoch) {
-        float total_loss = 0.0f;
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        if (CancellationToken::IsCancelled(cancel)) {
+            spdlog::info("[Ranker]: Training cancelled at epoch {}", epoch);
+            return false;
+        }
+        const float train_loss = run_epoch(train);
+        if (epoch % 50 == 0)
+            spdlog::debug("[Ranker]: Epoch {} — MSE loss = {:.4f}", epoch, train_loss);
+    }
 
-        // Zero gradients
-        std::fill(dW1.begin(), dW1.end(), 0.0f);
-        std::fill(db1.begin(), db1.end(), 0.0f);
-        std::fill(dW2.begin(), dW2.end(), 0.0f);
-        db2 = 0.0f;
+    m_trained = true;
+    spdlog::info("[Ranker]: Training complete on {} samples ({} workers)", train.size(), workers);
+    return true;
+}
 
-        for (int i = 0; i < n; ++i) {
-            const auto& x = X[static_cast<size_t>(i)];
-            float t = y_target[static_cast<size_t>(i)];
+float Ranker::Backprop(const SparseVector& x, float target, float scale, Gradients& g) const {
+    const Simd::Kernels& simd = Simd::Active();
 
-            // Forward
-            std::vector<float> h;
-            float out = Forward(x, h);
+    // Forward, MSE loss
+    float err = Forward(x, g.h) - target;
 
-            // MSE loss
-            float err = out - t;
-            total_loss += err * err;
+    // Backprop output layer
+    float d_out = scale * err;
+    g.db2 += d_out;
+    simd.axpy(g.units, d_out, g.h.data(), g.dW2.data());
 
-            // Backprop output layer
-            float d_out = 2.0f * err / static_cast<float>(n);
-            db2 += d_out;
-            for (int j = 0; j < HIDDEN_SIZE; ++j) {
-                dW2[static_cast<size_t>(j)] += d_out * h[static_cast<size_t>(j)];
-            }
+    // Backprop hidden layer (ReLU derivative)
+    for (size_t j = 0; j < g.units; ++j) {
+        g.d_h[j] = g.h[j] > 0.0f ? d_out * m_W2[j] : 0.0f;
+        g.db1[j] += g.d_h[j];
+    }
+    // Sparse outer product: only the rows of the sample's non-zeros.
+    for (const auto& [k, v] : x)
+        simd.axpy(g.units, v, g.d_h.data(), g.Row(k));
+    return err * err;
+}
 
-            // Backprop hidden layer
-            for (int j = 0; j < HIDDEN_SIZE; ++j) {
-                float d_h = d_out * m_W2[static_cast<size_t>(j)];
-                // ReLU derivative
-                if (h[static_cast<size_t>(j)] <= 0.0f)
-                    continue;
-                db1[static_cast<size_t>(j)] += d_h;
-                for (int k = 0; k < MAX_FEATURES; ++k) {
-                    dW1[static_cast<size_t>(j * MAX_FEATURES + k)] +=
-                        d_h * x[static_cast<size_t>(k)];
-                }
-            }
-        }
+void Ranker::Step(Gradients& g) {
+    const Simd::Kernels& simd = Simd::Active();
+    const size_t units = g.units;
+    const float lr = m_params.learning_rate;
+    for (size_t r = 0; r < g.rows.size(); ++r)
+        simd.axpy(units, -lr, &g.dW1[r * units], &m_W1[static_cast<size_t>(g.rows[r]) * units]);
+    simd.axpy(units, -lr, g.db1.data(), m_b1.data());
+    simd.axpy(units, -lr, g.dW2.data(), m_W2.data());
+    m_b2 -= lr * g.db2;
+    g.Clear();
+}
 
-        // SGD update
-        for (size_t idx = 0; idx < m_W1.size(); ++idx)
-            m_W1[idx] -= LR * dW1[idx];
-        for (size_t idx = 0; idx < m_b1.size(); ++idx)
-            m_b1[idx] -= LR * db1[idx];
-        for (size_t idx = 0; idx < m_W2.size(); ++idx)
-            m_W2[idx] -= LR * dW2[idx];
-        m_b2 -= LR * db2;
-
-        if (epoch % 50 == 0) {
-            spdlog::debug("[Ranker]: Epoch {} — MSE loss = {:.4f}",
-                          epoch,
-                          total_loss / static_cast<float>(n));
-        }
+// ---------------------------------------------------------------------------
+// Update — a few online SGD steps
+// ---------------------------------------------------------------------------
+bool Ranker::Update(const std::vector<std::pair<Article, int>>& rated) {
+    std::vector<SparseVector> X;
+    std::vector<float> y_target;
+    X.reserve(rated.size());
+    y_target.reserve(rated.size());
+    for (const auto& [article, rating] : rated) {
+        Vectorise(article, X.emplace_back());
+        y_target.push_back(NormaliseTarget(static_cast<float>(rating)));
     }
+    return UpdateVectors(X, y_target);
+}
 
-    m_trained = true;
-    spdlog::info("[Ranker]: Training complete on {} samples", n);
+bool Ranker::Update(const std::vector<std::pair<TermList, int>>& rated,
+                    const ColumnMap& columns) {
+    std::vector<SparseVector> X;
+    std::vector<float> y_target;
+    X.reserve(rated.size());
+    y_target.reserve(rated.size());
+    for (const auto& [terms, rating] : rated) {
+        Vectorise(terms, columns, X.emplace_back());
+        y_target.push_back(NormaliseTarget(static_cast<float>(rating)));
+    }
+    return UpdateVectors(X, y_target);
+}
+
+bool Ranker::UpdateVectors(const std::vector<SparseVector>& X, const std::vector<float>& y_target) {
+    if (!m_trained || X.empty())
+        return false;
+
+    // The whole set is one mini-batch, stepped ONLINE_STEPS times.
+    OwnWeights();
+    Gradients g(m_features, Units());
+    const float scale = 2.0f / static_cast<float>(X.size());
+    for (int step = 0; step < ONLINE_STEPS; ++step) {
+        for (size_t i = 0; i < X.size(); ++i)
+            Backprop(X[i], y_target[i], scale, g);
+        Step(g);
+    }
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -302,83 +853,526 @@ void Ranker::Train(const std::vector<std::pair<Article, int>>& rated, bool warm_
 float Ranker::Predict(const Article& article) const {
     if (!m_trained)
         return 0.0f;
-    auto x = Vectorise(article);
-    std::vector<float> h;
-    float raw = Forward(x, h);
+    Scratch& s = ThreadScratch();
+    Vectorise(article, s.x);
+    float raw = Forward(s.x, s.hidden);
     return ScaleOutput(raw);
 }
 
+template <typename VectoriseFn>
+std::vector<float>
+Ranker::PredictEach(size_t n, VectoriseFn vectorise, unsigned max_threads) const {
+    std::vector<float> scores(n, 0.0f);
+    if (!m_trained || n == 0)
+        return scores;
+
+    // Hidden activations for the whole batch, row i belonging to article i.
+    // Same operations in the same order as Forward(), so the scores are
+    // bit-identical to Predict().
+    const size_t units = Units();
+    std::vector<float> H(n * units);
+    auto hidden_rows = [&](size_t begin, size_t end) {
+        SparseVector& x = ThreadScratch().x;
+        for (size_t i = begin; i < end; ++i) {
+            vectorise(i, x);
+            Hidden(x, &H[i * units]);
+        }
+    };
+
+    // Vectorising dominates, so the first layer is split into contiguous
+    // chunks, one per worker; each worker writes only its own rows of H.
+    size_t workers = max_threads > 0 ? max_threads : std::thread::hardware_concurrency();
+    workers = std::max<size_t>(1, std::min(workers, n / PREDICT_CHUNK));
+    const size_t chunk = (n + workers - 1) / workers;
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t begin = chunk; begin < n; begin += chunk)
+        pool.emplace_back(hidden_rows, begin, std::min(n, begin + chunk));
+    hidden_rows(0, std::min(n, chunk));
+    for (auto& t : pool)
+        t.join();
+
+    // Output layer over the batch: scores = H · W2 + b2.
+    const Simd::Kernels& simd = Simd::Active();
+    for (size_t i = 0; i < n; ++i)
+        scores[i] = ScaleOutput(m_b2 + simd.dot(units, m_W2.data(), &H[i * units]));
+    return scores;
+}
+
+std::vector<float> Ranker::PredictBatch(const std::vector<Article>& articles,
+                                        unsigned max_threads) const {
+    return PredictEach(
+        articles.size(),
+        [&](size_t i, SparseVector& x) { Vectorise(articles[i], x); },
+        max_threads);
+}
+
+std::vector<float> Ranker::PredictBatch(const std::vector<TermList>& docs,
+                                        const ColumnMap& columns,
+                                        unsigned max_threads) const {
+    return PredictEach(
+        docs.size(),
+        [&](size_t i, SparseVector& x) { Vectorise(docs[i], columns, x); },
+        max_threads);
+}
+
+std::vector<float> Ranker::PredictBatch(const std::vector<SharedTermList>& docs,
+                                        const ColumnMap& columns,
+                                        unsigned max_threads) const {
+    return PredictEach(
+        docs.size(),
+        [&](size_t i, SparseVector& x) { Vectorise(*docs[i], columns, x); },
+        max_threads);
+}
+
+std::vector<size_t> Ranker::TopK(const std::vector<float>& scores, size_t k) {
+    std::vector<size_t> order(scores.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    k = std::min(k, order.size());
+    auto better = [&scores](size_t a, size_t b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    };
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+                      better);
+    order.resize(k);
+    return order;
+}
+
+// ---------------------------------------------------------------------------
+// Quantisation
+// ---------------------------------------------------------------------------
+void Ranker::Quantise() {
+    if (IsQuantised())
+        return;
+    // Symmetric, per hidden unit: the largest |weight| feeding unit j maps
+    // to ±127, so -128 never occurs and the int8 kernels cannot overflow
+    // int16. The scales stay in cache, leaving one 32-byte row per input.
+    const float* W1 = W1Data();
+    const size_t units = Units();
+    std::vector<float> peak(units, 0.0f);
+    for (size_t k = 0; k < m_features; ++k)
+        for (size_t j = 0; j < units; ++j)
+            peak[j] = std::max(peak[j], std::abs(W1[k * units + j]));
+    m_W1q_scale.resize(units);
+    for (size_t j = 0; j < units; ++j)
+        m_W1q_scale[j] = peak[j] / 127.0f;
+    m_W1q.resize(m_features * units);
+    for (size_t k = 0; k < m_features; ++k) {
+        for (size_t j = 0; j < units; ++j) {
+            const float w = W1[k * units + j], scale = m_W1q_scale[j];
+            m_W1q[k * units + j] =
+                scale > 0.0f ? static_cast<int8_t>(std::lround(w / scale)) : int8_t{0};
+        }
+    }
+}
+
 // ---------------------------------------------------------------------------
-// Persistence helpers
+// Persistence
 // ---------------------------------------------------------------------------
-// Binary format:
+// Version 3 (written by Save) is laid out so that Load can map the file and
+// use the weights in place:
+//   FileHeader (64 bytes)
+//   section_count × FileSection
+//   sections, each starting at a multiple of 64 bytes:
+//     VOCAB  count × VocabEntry sorted by term, then the term bytes they
+//            point into (vocabulary vectoriser only)
+//     IDF    features floats (vocabulary vectoriser only)
+//     W1     features × hidden floats, feature-major as in memory
+//     B1, W2 hidden floats each
+//     W1Q    features × hidden int8, laid out as W1 (quantised only)
+//     W1Q_SCALE  hidden floats, one per hidden unit (quantised only)
+//     HYPERPARAMETERS  one FileHyperparameters (absent from older files,
+//                      which used the defaults)
+// Fields are host-endian. The checksum covers every byte after itself, the
+// rest of the header included. Readers skip section ids they do not know.
+//
+// Versions 1 and 2 (read only):
 //   [4 bytes] magic "RANK"
-//   [4 bytes] int32 version (currently 1)
-//   [4 bytes] int32 vocab_size
-//   for each vocab entry:
-//     [4 bytes] int32 term_len
-//     [term_len bytes] term chars
-//     [4 bytes] int32 column_index
-//   [MAX_FEATURES * 4 bytes] IDF weights
-//   [HIDDEN_SIZE * MAX_FEATURES * 4 bytes] W1
+//   [4 bytes] int32 version: 1 = vocabulary vectoriser, 2 = hashed
+//   version 1:
+//     [4 bytes] int32 vocab_size
+//     for each vocab entry:
+//       [4 bytes] int32 term_len
+//       [term_len bytes] term chars
+//       [4 bytes] int32 column_index
+//     [MAX_FEATURES * 4 bytes] IDF weights
+//   version 2:
+//     [4 bytes] int32 hash_bits
+//   [HIDDEN_SIZE * features * 4 bytes] W1 (hidden-major), features being
+//     MAX_FEATURES or 2^hash_bits
 //   [HIDDEN_SIZE * 4 bytes] b1
 //   [HIDDEN_SIZE * 4 bytes] W2
 //   [4 bytes] b2
 //   [4 bytes] int32 trained flag (0 or 1)
 
-static void write_i32(std::ofstream& f, int32_t v) {
-    f.write(reinterpret_cast<const char*>(&v), sizeof(v));
-}
-static void write_f32(std::ofstream& f, float v) {
-    f.write(reinterpret_cast<const char*>(&v), sizeof(v));
+namespace {
+
+constexpr uint32_t FORMAT_VERSION = 3;
+constexpr size_t SECTION_ALIGN = 64;
+constexpr uint32_t FLAG_TRAINED = 1;
+
+enum SectionId : uint32_t {
+    SECTION_VOCAB = 1,
+    SECTION_IDF = 2,
+    SECTION_W1 = 3,
+    SECTION_B1 = 4,
+    SECTION_W2 = 5,
+    SECTION_W1Q = 6,
+    SECTION_W1Q_SCALE = 7,
+    SECTION_HYPERPARAMETERS = 8,
+};
+
+struct FileHeader {
+    char magic[4];     // "RANK"
+    uint32_t version;  // FORMAT_VERSION
+    uint64_t checksum; // Hash::Xxh64 of bytes [CHECKSUM_START, file_size)
+    uint64_t file_size;
+    uint32_t flags; // FLAG_TRAINED
+    int32_t hash_bits;
+    uint32_t hidden; // hidden units the weights were saved with
+    uint32_t section_count;
+    uint64_t features; // rows of W1
+    float b2;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(FileHeader) == 64, "the header is one aligned block");
+constexpr size_t CHECKSUM_START = offsetof(FileHeader, checksum) + sizeof(uint64_t);
+
+struct FileSection {
+    uint32_t id;    // SectionId
+    uint32_t count; // entries (VOCAB) or floats
+    uint64_t offset;
+    uint64_t size; // bytes
+};
+
+struct FileHyperparameters {
+    int32_t hidden; // as in the header
+    int32_t epochs;
+    int32_t max_features;
+    float learning_rate;
+    uint32_t reserved[4];
+};
+
+struct VocabEntry {
+    uint32_t offset; // into the term bytes after the entries
+    uint32_t length;
+    int32_t column;
+    uint32_t reserved;
+};
+
+constexpr size_t align_section(size_t n) { return (n + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1); }
+
+} // namespace
+
+// A model file mapped read-only. Copies of a Ranker share it, and W1 is read
+// from it in place until OwnWeights copies it out.
+struct Ranker::Mapping {
+    Mapping() = default;
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+    ~Mapping() {
+        if (base)
+            ::munmap(base, size);
+    }
+
+    const unsigned char* Bytes() const { return static_cast<const unsigned char*>(base); }
+
+    void* base = nullptr;
+    size_t size = 0;
+    const float* w1 = nullptr;
+    const int8_t* w1q = nullptr; // null unless saved quantised
+    const float* w1q_scale = nullptr;
+};
+
+const float* Ranker::W1Data() const { return m_mapping ? m_mapping->w1 : m_W1.data(); }
+
+const int8_t* Ranker::W1qData() const {
+    return m_W1q.empty() && m_mapping ? m_mapping->w1q : m_W1q.data();
 }
-static bool read_i32(std::ifstream& f, int32_t& v) {
-    return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(v)));
+
+const float* Ranker::W1qScale() const {
+    return m_W1q.empty() && m_mapping ? m_mapping->w1q_scale : m_W1q_scale.data();
 }
-static bool read_f32(std::ifstream& f, float& v) {
-    return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(v)));
+
+bool Ranker::IsQuantised() const { return !m_W1q.empty() || (m_mapping && m_mapping->w1q); }
+
+void Ranker::OwnWeights() {
+    m_W1q.clear();
+    m_W1q_scale.clear();
+    if (!m_mapping)
+        return;
+    m_W1.assign(m_mapping->w1, m_mapping->w1 + m_features * Units());
+    m_mapping.reset();
 }
 
 bool Ranker::Save(const std::string& path) const {
-    std::ofstream f(path, std::ios::binary | std::ios::trunc);
-    if (!f) {
-        spdlog::error("[Ranker]: Cannot open '{}' for writing", path);
-        return false;
+    // Vocabulary table, sorted by term.
+    std::vector<std::pair<std::string_view, int>> terms(m_vocab.begin(), m_vocab.end());
+    std::sort(terms.begin(), terms.end());
+    std::vector<VocabEntry> entries;
+    std::string term_bytes;
+    entries.reserve(terms.size());
+    for (const auto& [term, column] : terms) {
+        entries.push_back({static_cast<uint32_t>(term_bytes.size()),
+                           static_cast<uint32_t>(term.size()),
+                           column,
+                           0});
+        term_bytes += term;
+    }
+    std::string vocab(entries.size() * sizeof(VocabEntry), '\0');
+    if (!entries.empty())
+        std::memcpy(vocab.data(), entries.data(), vocab.size());
+    vocab += term_bytes;
+
+    struct Pending {
+        FileSection section;
+        const void* data;
+    };
+    std::vector<Pending> pending;
+    auto add = [&pending](uint32_t id, size_t count, const void* data, size_t bytes) {
+        pending.push_back({{id, static_cast<uint32_t>(count), 0, bytes}, data});
+    };
+    if (!IsHashed()) {
+        add(SECTION_VOCAB, entries.size(), vocab.data(), vocab.size());
+        add(SECTION_IDF, m_idf.size(), m_idf.data(), m_idf.size() * sizeof(float));
+    }
+    const size_t units = Units();
+    add(SECTION_W1, m_features * units, W1Data(), m_features * units * sizeof(float));
+    add(SECTION_B1, m_b1.size(), m_b1.data(), m_b1.size() * sizeof(float));
+    add(SECTION_W2, m_W2.size(), m_W2.data(), m_W2.size() * sizeof(float));
+    if (IsQuantised()) {
+        add(SECTION_W1Q, m_features * units, W1qData(), m_features * units);
+        add(SECTION_W1Q_SCALE, units, W1qScale(), units * sizeof(float));
+    }
+    const FileHyperparameters params{
+        m_params.hidden, m_params.epochs, m_params.max_features, m_params.learning_rate, {}};
+    add(SECTION_HYPERPARAMETERS, 1, &params, sizeof(params));
+
+    size_t file_size = sizeof(FileHeader) + pending.size() * sizeof(FileSection);
+    for (auto& p : pending) {
+        p.section.offset = align_section(file_size);
+        file_size = p.section.offset + p.section.size;
     }
 
-    // Magic + version
-    f.write("RANK", 4);
-    write_i32(f, 1);
+    std::vector<unsigned char> buf(file_size, 0);
+    FileHeader header{};
+    std::memcpy(header.magic, "RANK", 4);
+    header.version = FORMAT_VERSION;
+    header.file_size = file_size;
+    header.flags = m_trained ? FLAG_TRAINED : 0;
+    header.hash_bits = m_hash_bits;
+    header.hidden = static_cast<uint32_t>(m_params.hidden);
+    header.section_count = static_cast<uint32_t>(pending.size());
+    header.features = m_features;
+    header.b2 = m_b2;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const auto& p = pending[i];
+        std::memcpy(&buf[sizeof(FileHeader) + i * sizeof(FileSection)],
+                    &p.section,
+                    sizeof(FileSection));
+        if (p.section.size > 0)
+            std::memcpy(&buf[p.section.offset], p.data, p.section.size);
+    }
+    std::memcpy(buf.data(), &header, sizeof(header));
+    header.checksum = Hash::Xxh64(&buf[CHECKSUM_START], file_size - CHECKSUM_START);
+    std::memcpy(buf.data(), &header, sizeof(header));
+
+    // Write beside the target and rename over it, so a reader never sees a
+    // half-written file and a model mapped from the old one stays intact.
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) {
+            spdlog::error("[Ranker]: Cannot open '{}' for writing", path);
+            return false;
+        }
+        f.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(file_size));
+        if (!f.flush()) {
+            spdlog::error("[Ranker]: Write error while saving to '{}'", path);
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        spdlog::error("[Ranker]: Cannot replace '{}'", path);
+        std::remove(tmp.c_str());
+        return false;
+    }
+    spdlog::info("[Ranker]: Model saved to '{}'", path);
+    return true;
+}
 
-    // Vocabulary
-    write_i32(f, static_cast<int32_t>(m_vocab.size()));
-    for (const auto& [term, idx] : m_vocab) {
-        write_i32(f, static_cast<int32_t>(term.size()));
-        f.write(term.data(), static_cast<std::streamsize>(term.size()));
-        write_i32(f, static_cast<int32_t>(idx));
+bool Ranker::Load(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        spdlog::debug("[Ranker]: No saved model at '{}'", path);
+        return false;
+    }
+    auto map = std::make_shared<Mapping>();
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* base =
+            ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+            map->base = base;
+            map->size = static_cast<size_t>(st.st_size);
+        }
     }
+    ::close(fd);
 
-    // IDF, weights, biases
-    for (float v : m_idf)
-        write_f32(f, v);
-    for (float v : m_W1)
-        write_f32(f, v);
-    for (float v : m_b1)
-        write_f32(f, v);
-    for (float v : m_W2)
-        write_f32(f, v);
-    write_f32(f, m_b2);
-    write_i32(f, m_trained ? 1 : 0);
+    const unsigned char* data = map->Bytes();
+    if (map->size < 8 || std::memcmp(data, "RANK", 4) != 0) {
+        spdlog::error("[Ranker]: Invalid magic in '{}'", path);
+        return false;
+    }
+    uint32_t version = 0;
+    std::memcpy(&version, data + 4, sizeof(version));
+    if (version == 1 || version == 2)
+        return LoadStream(path);
+    if (version != FORMAT_VERSION) {
+        spdlog::error("[Ranker]: Unsupported model version {} in '{}'", version, path);
+        return false;
+    }
+    return LoadMapped(std::move(map), path);
+}
 
-    if (!f) {
-        spdlog::error("[Ranker]: Write error while saving to '{}'", path);
+bool Ranker::LoadMapped(std::shared_ptr<Mapping> map, const std::string& path) {
+    auto corrupt = [&path](const char* what) {
+        spdlog::error("[Ranker]: Corrupt model file '{}': {}", path, what);
         return false;
+    };
+    const unsigned char* data = map->Bytes();
+    const size_t size = map->size;
+
+    FileHeader header{};
+    if (size < sizeof(FileHeader))
+        return corrupt("truncated header");
+    std::memcpy(&header, data, sizeof(header));
+    if (header.file_size != size)
+        return corrupt("size mismatch");
+    if (Hash::Xxh64(data + CHECKSUM_START, size - CHECKSUM_START) != header.checksum)
+        return corrupt("checksum mismatch");
+    if (header.hidden < static_cast<uint32_t>(MIN_HIDDEN) ||
+        header.hidden > static_cast<uint32_t>(MAX_HIDDEN))
+        return corrupt("hidden layer size");
+    const size_t units = header.hidden;
+    const bool hashed = header.hash_bits != 0;
+    if (hashed && (header.hash_bits < MIN_HASH_BITS || header.hash_bits > MAX_HASH_BITS))
+        return corrupt("hash bits");
+    if (hashed ? header.features != size_t{1} << header.hash_bits
+               : header.features < static_cast<uint64_t>(MIN_VOCABULARY) ||
+                     header.features > static_cast<uint64_t>(MAX_VOCABULARY))
+        return corrupt("feature count");
+    const size_t features = header.features;
+
+    // Known sections, each in bounds, aligned and of the expected size
+    // (`floats` of them; 0 to skip the size check).
+    if (header.section_count > (size - sizeof(FileHeader)) / sizeof(FileSection))
+        return corrupt("section table");
+    const auto* table = reinterpret_cast<const FileSection*>(data + sizeof(FileHeader));
+    auto section = [&](uint32_t id, size_t floats) -> const FileSection* {
+        for (uint32_t i = 0; i < header.section_count; ++i) {
+            const FileSection& sec = table[i];
+            if (sec.id != id)
+                continue;
+            if (sec.offset % SECTION_ALIGN != 0 || sec.size > size || sec.offset > size - sec.size)
+                return nullptr;
+            if (floats > 0 && (sec.count != floats || sec.size != floats * sizeof(float)))
+                return nullptr;
+            return &sec;
+        }
+        return nullptr;
+    };
+    auto floats_at = [data](const FileSection* sec) {
+        return reinterpret_cast<const float*>(data + sec->offset);
+    };
+
+    const FileSection* w1 = section(SECTION_W1, features * units);
+    const FileSection* b1 = section(SECTION_B1, units);
+    const FileSection* w2 = section(SECTION_W2, units);
+    if (!w1 || !b1 || !w2)
+        return corrupt("missing weights");
+    // Optional, but only as a pair.
+    const FileSection* w1q = section(SECTION_W1Q, 0);
+    const FileSection* w1q_scale = section(SECTION_W1Q_SCALE, units);
+    if ((w1q || w1q_scale) &&
+        (!w1q || !w1q_scale || w1q->count != features * units || w1q->size != w1q->count))
+        return corrupt("quantised weights");
+
+    // Optional: files from before the section was added used the defaults.
+    Hyperparameters params;
+    params.hidden = static_cast<int>(units);
+    if (const FileSection* hs = section(SECTION_HYPERPARAMETERS, 0)) {
+        FileHyperparameters saved{};
+        if (hs->size != sizeof(saved))
+            return corrupt("hyperparameters");
+        std::memcpy(&saved, data + hs->offset, sizeof(saved));
+        if (saved.hidden != params.hidden || saved.epochs < 1 ||
+            !(saved.learning_rate > 0.0f && saved.learning_rate <= 1.0f))
+            return corrupt("hyperparameters");
+        params.epochs = saved.epochs;
+        params.learning_rate = saved.learning_rate;
+        params.max_features = std::clamp(saved.max_features, MIN_VOCABULARY, MAX_VOCABULARY);
     }
-    spdlog::info("[Ranker]: Model saved to '{}'", path);
+    if (!hashed)
+        params.max_features = static_cast<int>(features);
+
+    std::unordered_map<std::string, int> vocab;
+    std::vector<float> idf;
+    if (!hashed) {
+        const FileSection* vs = section(SECTION_VOCAB, 0);
+        const FileSection* is = section(SECTION_IDF, features);
+        if (!vs || !is || vs->count > features ||
+            vs->size < vs->count * sizeof(VocabEntry))
+            return corrupt("missing vocabulary");
+        const unsigned char* entries = data + vs->offset;
+        const char* text = reinterpret_cast<const char*>(entries + vs->count * sizeof(VocabEntry));
+        const size_t text_size = vs->size - vs->count * sizeof(VocabEntry);
+        vocab.reserve(vs->count);
+        for (uint32_t i = 0; i < vs->count; ++i) {
+            VocabEntry e{};
+            std::memcpy(&e, entries + i * sizeof(VocabEntry), sizeof(e));
+            if (e.offset > text_size || e.length > text_size - e.offset || e.column < 0 ||
+                static_cast<size_t>(e.column) >= features)
+                return corrupt("vocabulary entry");
+            vocab.emplace(std::string(text + e.offset, e.length), e.column);
+        }
+        idf.assign(floats_at(is), floats_at(is) + features);
+    }
+
+    // Commit loaded state only after every check passed. W1 stays mapped.
+    map->w1 = floats_at(w1);
+    if (w1q) {
+        map->w1q = reinterpret_cast<const int8_t*>(data + w1q->offset);
+        map->w1q_scale = floats_at(w1q_scale);
+    }
+    m_params = params;
+    m_hash_bits = header.hash_bits;
+    m_features = features;
+    m_vocab = std::move(vocab);
+    m_idf = std::move(idf);
+    m_W1.clear();
+    m_W1.shrink_to_fit();
+    m_W1q.clear();
+    m_W1q_scale.clear();
+    m_mapping = std::move(map);
+    m_b1.assign(floats_at(b1), floats_at(b1) + units);
+    m_W2.assign(floats_at(w2), floats_at(w2) + units);
+    m_b2 = header.b2;
+    m_trained = (header.flags & FLAG_TRAINED) != 0;
+
+    spdlog::info("[Ranker]: Model loaded from '{}'", path);
     return true;
 }
 
-bool Ranker::Load(const std::string& path) {
+static bool read_i32(std::ifstream& f, int32_t& v) {
+    return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(v)));
+}
+static bool read_f32(std::ifstream& f, float& v) {
+    return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(v)));
+}
+
+bool Ranker::LoadStream(const std::string& path) {
     std::ifstream f(path, std::ios::binary);
     if (!f) {
         spdlog::debug("[Ranker]: No saved model at '{}'", path);
@@ -394,44 +1388,55 @@ bool Ranker::Load(const std::string& path) {
 
     // Version
     int32_t version = 0;
-    if (!read_i32(f, version) || version != 1) {
+    if (!read_i32(f, version) || (version != 1 && version != 2)) {
         spdlog::error("[Ranker]: Unsupported model version {} in '{}'", version, path);
         return false;
     }
 
-    // Vocabulary
-    int32_t vocab_size = 0;
-    if (!read_i32(f, vocab_size))
-        return false;
+    int32_t hash_bits = 0;
+    size_t features = static_cast<size_t>(MAX_FEATURES);
     std::unordered_map<std::string, int> vocab;
-    vocab.reserve(static_cast<size_t>(vocab_size));
-    for (int32_t i = 0; i < vocab_size; ++i) {
-        int32_t term_len = 0;
-        if (!read_i32(f, term_len) || term_len <= 0 || term_len > 256)
+    std::vector<float> idf;
+    if (version == 2) {
+        if (!read_i32(f, hash_bits) || hash_bits < MIN_HASH_BITS || hash_bits > MAX_HASH_BITS)
             return false;
-        std::string term(static_cast<size_t>(term_len), '\0');
-        if (!f.read(term.data(), term_len))
-            return false;
-        int32_t idx = 0;
-        if (!read_i32(f, idx))
+        features = size_t{1} << hash_bits;
+    } else {
+        // Vocabulary
+        int32_t vocab_size = 0;
+        if (!read_i32(f, vocab_size))
             return false;
-        vocab[term] = static_cast<int>(idx);
-    }
+        vocab.reserve(static_cast<size_t>(vocab_size));
+        for (int32_t i = 0; i < vocab_size; ++i) {
+            int32_t term_len = 0;
+            if (!read_i32(f, term_len) || term_len <= 0 || term_len > 256)
+                return false;
+            std::string term(static_cast<size_t>(term_len), '\0');
+            if (!f.read(term.data(), term_len))
+                return false;
+            int32_t idx = 0;
+            if (!read_i32(f, idx))
+                return false;
+            vocab[term] = static_cast<int>(idx);
+        }
 
-    // IDF
-    std::vector<float> idf(static_cast<size_t>(MAX_FEATURES));
-    for (auto& v : idf)
-        if (!read_f32(f, v))
-            return false;
+        // IDF
+        idf.resize(static_cast<size_t>(MAX_FEATURES));
+        for (auto& v : idf)
+            if (!read_f32(f, v))
+                return false;
+    }
 
-    // Weights
-    std::vector<float> W1(static_cast<size_t>(HIDDEN_SIZE * MAX_FEATURES));
-    std::vector<float> b1(static_cast<size_t>(HIDDEN_SIZE));
-    std::vector<float> W2(static_cast<size_t>(HIDDEN_SIZE));
+    // Weights, always of the default size
+    const auto units = static_cast<size_t>(HIDDEN_SIZE);
+    std::vector<float> W1(features * units);
+    std::vector<float> b1(units);
+    std::vector<float> W2(units);
     float b2 = 0.0f;
-    for (auto& v : W1)
-        if (!read_f32(f, v))
-            return false;
+    for (size_t j = 0; j < units; ++j)
+        for (size_t k = 0; k < features; ++k)
+            if (!read_f32(f, W1[k * units + j]))
+                return false;
     for (auto& v : b1)
         if (!read_f32(f, v))
             return false;
@@ -446,8 +1451,14 @@ bool Ranker::Load(const std::string& path) {
         return false;
 
     // Commit loaded state only after all reads succeeded
+    m_params = Hyperparameters{};
+    m_hash_bits = hash_bits;
+    m_features = features;
     m_vocab = std::move(vocab);
     m_idf = std::move(idf);
+    m_mapping.reset();
+    m_W1q.clear();
+    m_W1q_scale.clear();
     m_W1 = std::move(W1);
     m_b1 = std::move(b1);
     m_W2 = std::move(W2);
@@ -472,6 +1483,7 @@ void Ranker::FitKeywords(const std::vector<std::string>& keywords) {
         if (!lower.empty())
             m_keywords.push_back(std::move(lower));
     }
+    m_keyword_matcher = AhoCorasick(m_keywords);
     m_fit_keywords = !m_keywords.empty();
     spdlog::info("[Ranker]: Fitted {} keywords for cold-start scoring", m_keywords.size());
 }
@@ -480,18 +1492,14 @@ float Ranker::PredictKeyword(const Article& article) const {
     if (!m_fit_keywords)
         return 1.0f;
 
-    const std::string text = StripLatex(article.title + " " + article.abstract);
-    // Lower-case the article text for case-insensitive matching
-    std::string lower_text;
-    lower_text.reserve(text.size());
-    for (char c : text)
-        lower_text += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    // One case-insensitive pass over the text finds every keyword.
+    Scratch& scratch = ThreadScratch();
+    scratch.text.assign(article.title);
+    scratch.text += ' ';
+    scratch.text += article.abstract;
+    StripLatex(scratch.text, scratch.stripped);
+    const size_t hits = m_keyword_matcher.CountDistinct(scratch.stripped, scratch.keyword_seen);
 
-    int hits = 0;
-    for (const auto& kw : m_keywords) {
-        if (lower_text.find(kw) != std::string::npos)
-            ++hits;
-    }
     // Fraction of keywords found, mapped linearly to [1.0, 5.0]
     float frac = static_cast<float>(hits) / static_cast<float>(m_keywords.size());
     return 1.0f + frac * 4.0f;
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/RankerSearch.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "spdlog/spdlog.h"
+
+namespace Arxiv {
+
+namespace {
+
+// The grid the candidates are drawn from, spanning about a factor of four
+// either side of each default.
+constexpr int GRID_HIDDEN[] = {16, 32, 64};
+constexpr float GRID_LEARNING_RATE[] = {0.003f, 0.01f, 0.03f};
+constexpr int GRID_EPOCHS[] = {100, 200, 400};
+constexpr int GRID_FEATURES[] = {256, 512, 1024};
+
+} // namespace
+
+RankerSearch::RankerSearch(const Ranker& prototype, int trials, uint32_t seed)
+    : m_hash_bits(prototype.HashBits())
+    , m_seed(seed) {
+    const Ranker::Hyperparameters defaults;
+    std::vector<int> features{defaults.max_features};
+    if (!prototype.IsHashed())
+        features.assign(std::begin(GRID_FEATURES), std::end(GRID_FEATURES));
+
+    std::vector<Ranker::Hyperparameters> grid;
+    for (int hidden : GRID_HIDDEN)
+        for (float lr : GRID_LEARNING_RATE)
+            for (int epochs : GRID_EPOCHS)
+                for (int max_features : features) {
+                    const Ranker::Hyperparameters p{hidden, lr, epochs, max_features};
+                    if (p != defaults)
+                        grid.push_back(p);
+                }
+    std::mt19937 rng(seed);
+    std::shuffle(grid.begin(), grid.end(), rng);
+
+    m_candidates.push_back(defaults);
+    const size_t extra = std::min(grid.size(), static_cast<size_t>(std::max(trials, 1) - 1));
+    m_candidates.insert(m_candidates.end(), grid.begin(), grid.begin() + std::ptrdiff_t(extra));
+}
+
+std::vector<RankerSearch::Trial>
+RankerSearch::Run(const std::vector<std::pair<TermList, int>>& rated,
+                  const FitFn& fit,
+                  const ColumnsFn& columns,
+                  const CancellationToken* cancel,
+                  unsigned max_threads) const {
+    const size_t n = rated.size();
+    if (n < static_cast<size_t>(MIN_RATINGS)) {
+        spdlog::info("[RankerSearch]: Not enough ratings to search ({} < {})", n, MIN_RATINGS);
+        return {};
+    }
+
+    // Folds: a shuffled round robin, so their sizes differ by at most one.
+    const auto folds = static_cast<size_t>(FOLDS);
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::mt19937 rng(m_seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<std::vector<std::pair<TermList, int>>> train(folds);
+    std::vector<std::vector<TermList>> held_out(folds);
+    std::vector<std::vector<int>> held_out_rating(folds);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t fold = i % folds;
+        const auto& sample = rated[order[i]];
+        held_out[fold].push_back(sample.first);
+        held_out_rating[fold].push_back(sample.second);
+        for (size_t k = 0; k < folds; ++k)
+            if (k != fold)
+                train[k].push_back(sample);
+    }
+
+    // One fitted vectoriser per distinct max_features; the hashed one has
+    // nothing to fit, so its candidates all share the first.
+    struct Vectoriser {
+        int max_features;
+        Ranker base;
+        Ranker::ColumnMap columns;
+    };
+    std::vector<Vectoriser> vectorisers;
+    std::vector<size_t> vectoriser_of;
+    for (const auto& params : m_candidates) {
+        const int key = m_hash_bits > 0 ? 0 : params.max_features;
+        auto it = std::find_if(vectorisers.begin(), vectorisers.end(), [key](const Vectoriser& v) {
+            return v.max_features == key;
+        });
+        if (it == vectorisers.end()) {
+            Ranker base{m_hash_bits};
+            base.SetHyperparameters(params);
+            fit(base);
+            auto map = columns(base);
+            vectorisers.push_back({key, std::move(base), std::move(map)});
+            it = vectorisers.end() - 1;
+        }
+        vectoriser_of.push_back(static_cast<size_t>(it - vectorisers.begin()));
+        if (CancellationToken::IsCancelled(cancel))
+            return {};
+    }
+
+    // Every (candidate, fold) pair is one job; workers take the next job
+    // until none are left. Each records its summed squared error.
+    const size_t jobs = m_candidates.size() * folds;
+    std::vector<double> squared_error(jobs, 0.0);
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t job = next++; job < jobs; job = next++) {
+            if (CancellationToken::IsCancelled(cancel))
+                return;
+            const size_t c = job / folds, k = job % folds;
+            const Vectoriser& v = vectorisers[vectoriser_of[c]];
+            Ranker ranker = v.base;
+            ranker.SetHyperparameters(m_candidates[c]);
+            if (!ranker.Train(train[k], v.columns, /*warm_start=*/false, cancel, 1)) {
+                squared_error[job] = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            const auto scores = ranker.PredictBatch(held_out[k], v.columns, 1);
+            for (size_t i = 0; i < scores.size(); ++i) {
+                const double d = static_cast<double>(scores[i]) - held_out_rating[k][i];
+                squared_error[job] += d * d;
+            }
+        }
+    };
+
+    // Leave a core for the UI and the rest of the app.
+    size_t workers =
+        max_threads > 0 ? max_threads : std::max(1u, std::thread::hardware_concurrency()) - 1;
+    workers = std::clamp<size_t>(workers, 1, jobs);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w)
+        pool.emplace_back(work);
+    work();
+    for (auto& t : pool)
+        t.join();
+    if (CancellationToken::IsCancelled(cancel))
+        return {};
+
+    std::vector<Trial> trials;
+    trials.reserve(m_candidates.size());
+    for (size_t c = 0; c < m_candidates.size(); ++c) {
+        double sum = 0.0;
+        for (size_t k = 0; k < folds; ++k)
+            sum += squared_error[c * folds + k];
+        trials.push_back({m_candidates[c], static_cast<float>(sum / static_cast<double>(n))});
+    }
+    const float default_mse = trials.front().mse;
+    std::stable_sort(trials.begin(), trials.end(), [](const Trial& a, const Trial& b) {
+        return a.mse < b.mse;
+    });
+
+    const auto& best = trials.front();
+    spdlog::info("[RankerSearch]: Best of {} trials over {} ratings: hidden={} lr={} epochs={} "
+                 "max_features={} (CV MSE {:.3f}, defaults {:.3f})",
+                 trials.size(),
+                 n,
+                 best.params.hidden,
+                 best.params.learning_rate,
+                 best.params.epochs,
+                 best.params.max_features,
+                 best.mse,
+                 default_mse);
+    return trials;
+}
+
+} // namespace Arxiv
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/RefreshScheduler.hh"
+
+#include "Arxiv/Calendar.hh"
+
+#include <algorithm>
+#include <sstream>
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+constexpr int64_t SECONDS_PER_DAY = 86400;
+
+using Arxiv::Calendar::DaysFromCivil;
+
+// Inverse of DaysFromCivil, year only (H. Hinnant's civil_from_days).
+int year_from_days(int64_t days) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    return static_cast<int>(yoe + era * 400 + (mp >= 10 ? 1 : 0));
+}
+
+// 0 = Sunday. 1970-01-01 was a Thursday.
+int64_t weekday(int64_t days) { return ((days % 7) + 11) % 7; }
+
+// The n-th (1-based) Sunday of month m in year y, as days since the epoch.
+int64_t nth_sunday(int y, int m, int n) {
+    const int64_t first = DaysFromCivil(y, m, 1);
+    return first + (7 - weekday(first)) % 7 + 7 * (n - 1);
+}
+
+int64_t floor_div(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+int64_t to_seconds(Arxiv::time_point t) {
+    return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+}
+
+Arxiv::time_point from_seconds(int64_t s) { return Arxiv::time_point{std::chrono::seconds{s}}; }
+
+bool parse_ymd(const std::string& text, int& y, int& m, int& d) {
+    std::istringstream in(text);
+    char dash1 = 0;
+    char dash2 = 0;
+    return (in >> y >> dash1 >> m >> dash2 >> d) && in.peek() == std::char_traits<char>::eof() &&
+           dash1 == '-' && dash2 == '-' && m >= 1 && m <= 12 && d >= 1 && d <= 31;
+}
+
+// Bounds the calendar search; arXiv has never gone a month without a mailing.
+constexpr int64_t MAX_GAP_DAYS = 31;
+
+// The instant `minute_of_day` minutes after midnight Eastern on an Eastern
+// day. Guesses with the standard-time offset, then corrects; only the
+// 01:00-02:00 hours around a transition are ambiguous.
+Arxiv::time_point from_eastern(int64_t eastern_day, int minute_of_day) {
+    const int64_t local = eastern_day * SECONDS_PER_DAY + minute_of_day * int64_t{60};
+    const auto offset = Arxiv::RefreshScheduler::EasternOffset(from_seconds(local + 5 * 3600));
+    return from_seconds(local - offset.count());
+}
+
+int64_t eastern_day_of(Arxiv::time_point t) {
+    return floor_div(to_seconds(t) + Arxiv::RefreshScheduler::EasternOffset(t).count(),
+                     SECONDS_PER_DAY);
+}
+
+} // namespace
+
+namespace Arxiv {
+
+RefreshScheduler::RefreshScheduler(RefreshPolicy policy, const std::vector<std::string>& holidays)
+    : m_policy(policy) {
+    m_policy.dense_interval = std::max(m_policy.dense_interval, std::chrono::minutes{1});
+    m_policy.max_interval = std::max(m_policy.max_interval, m_policy.dense_interval);
+    for (const auto& date : holidays) {
+        int y = 0, m = 0, d = 0;
+        if (parse_ymd(date, y, m, d))
+            m_holidays.insert(DaysFromCivil(y, m, d));
+        else
+            spdlog::warn("[RefreshScheduler]: Ignoring malformed holiday '{}'", date);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Calendar
+// ---------------------------------------------------------------------------
+
+std::chrono::seconds RefreshScheduler::EasternOffset(time_point t) {
+    const int64_t secs = to_seconds(t);
+    const int year = year_from_days(floor_div(secs, SECONDS_PER_DAY));
+    // 02:00 EST = 07:00 UTC; 02:00 EDT = 06:00 UTC.
+    const int64_t dst_start = nth_sunday(year, 3, 2) * SECONDS_PER_DAY + 7 * 3600;
+    const int64_t dst_end = nth_sunday(year, 11, 1) * SECONDS_PER_DAY + 6 * 3600;
+    return std::chrono::hours{secs >= dst_start && secs < dst_end ? -4 : -5};
+}
+
+time_point RefreshScheduler::FromEastern(int y, int m, int d, int minute_of_day) {
+    return from_eastern(DaysFromCivil(y, m, d), minute_of_day);
+}
+
+bool RefreshScheduler::IsMailingDay(int y, int m, int d) const {
+    return IsMailingDay(DaysFromCivil(y, m, d));
+}
+
+bool RefreshScheduler::IsMailingDay(int64_t eastern_day) const {
+    // Sunday through Thursday evenings.
+    return weekday(eastern_day) <= 4 && m_holidays.count(eastern_day) == 0;
+}
+
+time_point RefreshScheduler::LastMailing(time_point t) const {
+    const int64_t today = eastern_day_of(t);
+    for (int64_t day = today; day > today - MAX_GAP_DAYS; --day) {
+        if (IsMailingDay(day) && from_eastern(day, ANNOUNCE_MINUTE_ET) <= t)
+            return from_eastern(day, ANNOUNCE_MINUTE_ET);
+    }
+    return t;
+}
+
+time_point RefreshScheduler::NextMailing(time_point t) const {
+    const int64_t today = eastern_day_of(t);
+    for (int64_t day = today; day < today + MAX_GAP_DAYS; ++day) {
+        if (IsMailingDay(day) && from_eastern(day, ANNOUNCE_MINUTE_ET) > t)
+            return from_eastern(day, ANNOUNCE_MINUTE_ET);
+    }
+    return t + m_policy.max_interval;
+}
+
+// ---------------------------------------------------------------------------
+// Polling
+// ---------------------------------------------------------------------------
+
+void RefreshScheduler::RecordPoll(time_point now, std::size_t added) {
+    const time_point mailing = LastMailing(now);
+    const time_point next_mailing = NextMailing(now);
+
+    // Anything new means the feed has caught up with the latest mailing. The
+    // very first poll has nothing to compare against, so it counts as caught
+    // up too — otherwise a fresh install would back off until the next one.
+    if (added > 0 || m_last_seen == time_point{})
+        m_last_seen = std::max(m_last_seen, mailing);
+
+    if (m_last_seen >= mailing) {
+        m_misses = 0;
+        m_next_due = next_mailing;
+        return;
+    }
+
+    // The mailing is due but has not shown up yet.
+    std::chrono::minutes wait = m_policy.dense_interval;
+    if (now - mailing >= m_policy.dense_window) {
+        const int shift = std::min(m_misses, 16);
+        wait = std::min(m_policy.dense_interval * (int64_t{1} << shift), m_policy.max_interval);
+        ++m_misses;
+    }
+    m_next_due = std::min(now + wait, next_mailing);
+    spdlog::debug("[RefreshScheduler]: Mailing overdue; next poll in {} min",
+                  std::chrono::duration_cast<std::chrono::minutes>(m_next_due - now).count());
+}
+
+std::string RefreshScheduler::Serialise() const {
+    return "1 " + std::to_string(to_seconds(m_last_seen)) + " " + std::to_string(m_misses) + " " +
+           std::to_string(to_seconds(m_next_due));
+}
+
+void RefreshScheduler::Restore(const std::string& state) {
+    std::istringstream in(state);
+    int version = 0;
+    int64_t last_seen = 0;
+    int misses = 0;
+    int64_t next_due = 0;
+    if (!(in >> version >> last_seen >> misses >> next_due) || version != 1 || misses < 0)
+        return;
+    m_last_seen = from_seconds(last_seen);
+    m_misses = misses;
+    m_next_due = from_seconds(next_due);
+}
+
+} // namespace Arxiv
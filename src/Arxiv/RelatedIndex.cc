@@ -0,0 +1,272 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/RelatedIndex.hh"
+
+#include "Arxiv/Hash.hh"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <queue>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+namespace Arxiv {
+
+namespace {
+
+// Hyperplane bits for a column are Hash::Mix of (column, word, SEED), so
+// every process draws the same planes and saved signatures stay valid.
+constexpr uint64_t SEED = 0x52454c4154454400; // "RELATED\0"
+
+// File layout: FileHeader, `count` signatures, then `count` links, each a
+// uint32 length and its bytes. Native byte order, like ranker.bin.
+constexpr uint32_t FORMAT_VERSION = 1;
+
+struct FileHeader {
+    char magic[4];     // "RELI"
+    uint32_t version;  // FORMAT_VERSION
+    uint64_t checksum; // Hash::Xxh64 of everything after this field
+    uint64_t vocabulary;
+    uint64_t count;
+};
+constexpr size_t CHECKSUM_START = offsetof(FileHeader, checksum) + sizeof(uint64_t);
+
+} // namespace
+
+RelatedIndex::Signature RelatedIndex::Sign(const Ranker::SparseVector& features) {
+    // Projection onto each hyperplane, whose coefficient for a column is ±1.
+    std::array<float, BITS> projection{};
+    for (const auto& f : features) {
+        for (int w = 0; w < WORDS; ++w) {
+            const uint64_t plane =
+                Hash::Mix((static_cast<uint64_t>(f.index) * WORDS + static_cast<uint64_t>(w)) ^
+                          SEED);
+            float* p = &projection[static_cast<size_t>(w) * 64];
+            for (int b = 0; b < 64; ++b)
+                p[b] += ((plane >> b) & 1u) != 0 ? f.value : -f.value;
+        }
+    }
+    Signature sig{};
+    for (int i = 0; i < BITS; ++i) {
+        if (projection[static_cast<size_t>(i)] > 0.0f)
+            sig[static_cast<size_t>(i / 64)] |= uint64_t{1} << (i % 64);
+    }
+    return sig;
+}
+
+int RelatedIndex::Distance(const Signature& a, const Signature& b) {
+    int d = 0;
+    for (size_t w = 0; w < a.size(); ++w)
+        d += __builtin_popcountll(a[w] ^ b[w]);
+    return d;
+}
+
+RelatedIndex::RelatedIndex(uint64_t vocabulary)
+    : m_vocabulary(vocabulary) {}
+
+RelatedIndex& RelatedIndex::operator=(RelatedIndex&& other) {
+    if (this == &other)
+        return *this;
+    std::scoped_lock lock(m_mutex, other.m_mutex);
+    m_vocabulary = other.m_vocabulary;
+    m_signatures = std::move(other.m_signatures);
+    m_links = std::move(other.m_links);
+    m_ids = std::move(other.m_ids);
+    other.m_signatures.clear();
+    other.m_links.clear();
+    other.m_ids.clear();
+    return *this;
+}
+
+uint64_t RelatedIndex::Vocabulary() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_vocabulary;
+}
+
+size_t RelatedIndex::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_links.size();
+}
+
+bool RelatedIndex::Contains(const std::string& link) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ids.count(link) > 0;
+}
+
+void RelatedIndex::Add(const std::string& link, const Signature& signature) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_ids.emplace(link, static_cast<uint32_t>(m_links.size()));
+    if (!inserted) {
+        m_signatures[it->second] = signature;
+        return;
+    }
+    m_signatures.push_back(signature);
+    m_links.push_back(link);
+}
+
+void RelatedIndex::Remove(const std::string& link) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_ids.find(link);
+    if (it == m_ids.end())
+        return;
+    // Move the last entry into the hole.
+    const uint32_t id = it->second;
+    m_ids.erase(it);
+    const size_t last = m_links.size() - 1;
+    if (id != last) {
+        m_signatures[id] = m_signatures[last];
+        m_links[id] = std::move(m_links[last]);
+        m_ids[m_links[id]] = id;
+    }
+    m_signatures.pop_back();
+    m_links.pop_back();
+}
+
+std::vector<std::string> RelatedIndex::Related(const std::string& link, size_t k) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_ids.find(link);
+    if (it == m_ids.end() || k == 0)
+        return {};
+    const uint32_t self = it->second;
+    const Signature query = m_signatures[self];
+
+    // Max-heap of the k nearest so far; most entries are rejected by one
+    // comparison against its top.
+    using Hit = std::pair<int, uint32_t>;
+    auto nearer = [this](const Hit& a, const Hit& b) {
+        return a.first != b.first ? a.first < b.first : m_links[a.second] < m_links[b.second];
+    };
+    std::priority_queue<Hit, std::vector<Hit>, decltype(nearer)> best(nearer);
+    for (uint32_t i = 0; i < m_signatures.size(); ++i) {
+        if (i == self)
+            continue;
+        const Hit hit{Distance(query, m_signatures[i]), i};
+        if (best.size() < k) {
+            best.push(hit);
+        } else if (nearer(hit, best.top())) {
+            best.pop();
+            best.push(hit);
+        }
+    }
+
+    std::vector<std::string> links(best.size());
+    for (size_t i = links.size(); i-- > 0; best.pop())
+        links[i] = m_links[best.top().second];
+    return links;
+}
+
+bool RelatedIndex::Save(const std::string& path) const {
+    std::string buf;
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        count = m_links.size();
+        FileHeader header{};
+        std::memcpy(header.magic, "RELI", 4);
+        header.version = FORMAT_VERSION;
+        header.vocabulary = m_vocabulary;
+        header.count = count;
+        buf.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+        buf.append(reinterpret_cast<const char*>(m_signatures.data()),
+                   m_signatures.size() * sizeof(Signature));
+        for (const auto& link : m_links) {
+            const auto length = static_cast<uint32_t>(link.size());
+            buf.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            buf += link;
+        }
+    }
+    const uint64_t checksum = Hash::Xxh64(buf.data() + CHECKSUM_START, buf.size() - CHECKSUM_START);
+    std::memcpy(&buf[offsetof(FileHeader, checksum)], &checksum, sizeof(checksum));
+
+    // Write beside the target and rename over it, as Ranker::Save does.
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) {
+            spdlog::error("[RelatedIndex]: Cannot open '{}' for writing", path);
+            return false;
+        }
+        f.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!f.flush()) {
+            spdlog::error("[RelatedIndex]: Write error while saving to '{}'", path);
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        spdlog::error("[RelatedIndex]: Cannot replace '{}'", path);
+        std::remove(tmp.c_str());
+        return false;
+    }
+    spdlog::info("[RelatedIndex]: Saved {} articles to '{}'", count, path);
+    return true;
+}
+
+bool RelatedIndex::Load(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        spdlog::debug("[RelatedIndex]: No saved index at '{}'", path);
+        return false;
+    }
+    const std::string buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    auto corrupt = [&path](const char* what) {
+        spdlog::error("[RelatedIndex]: Corrupt index file '{}': {}", path, what);
+        return false;
+    };
+
+    FileHeader header{};
+    if (buf.size() < sizeof(header))
+        return corrupt("truncated header");
+    std::memcpy(&header, buf.data(), sizeof(header));
+    if (std::memcmp(header.magic, "RELI", 4) != 0)
+        return corrupt("bad magic");
+    if (header.version != FORMAT_VERSION) {
+        spdlog::error(
+            "[RelatedIndex]: Unsupported index version {} in '{}'", header.version, path);
+        return false;
+    }
+    if (Hash::Xxh64(buf.data() + CHECKSUM_START, buf.size() - CHECKSUM_START) != header.checksum)
+        return corrupt("checksum mismatch");
+    if (header.count > (buf.size() - sizeof(header)) / sizeof(Signature))
+        return corrupt("truncated signatures");
+
+    const size_t count = header.count;
+    std::vector<Signature> signatures(count);
+    std::memcpy(signatures.data(), buf.data() + sizeof(header), count * sizeof(Signature));
+    std::vector<std::string> links;
+    std::unordered_map<std::string, uint32_t> ids;
+    links.reserve(count);
+    ids.reserve(count);
+    size_t pos = sizeof(header) + count * sizeof(Signature);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t length = 0;
+        if (buf.size() - pos < sizeof(length))
+            return corrupt("truncated links");
+        std::memcpy(&length, buf.data() + pos, sizeof(length));
+        pos += sizeof(length);
+        if (buf.size() - pos < length)
+            return corrupt("truncated links");
+        links.emplace_back(buf, pos, length);
+        pos += length;
+        if (!ids.emplace(links.back(), static_cast<uint32_t>(i)).second)
+            return corrupt("duplicate link");
+    }
+    if (pos != buf.size())
+        return corrupt("trailing bytes");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_vocabulary = header.vocabulary;
+    m_signatures = std::move(signatures);
+    m_links = std::move(links);
+    m_ids = std::move(ids);
+    spdlog::info("[RelatedIndex]: Loaded {} articles from '{}'", count, path);
+    return true;
+}
+
+} // namespace Arxiv
@@ -0,0 +1,266 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Simd.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <string_view>
+
+#include "spdlog/spdlog.h"
+
+// The vector variants are compiled with per-function target attributes, so
+// the rest of the build keeps its generic baseline and no -m flags are needed.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ARXIV_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Arxiv {
+namespace Simd {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference
+// ---------------------------------------------------------------------------
+
+void axpy_scalar(std::size_t n, float a, const float* x, float* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+float dot_scalar(std::size_t n, const float* x, const float* y) {
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < n; ++i)
+        sum += x[i] * y[i];
+    return sum;
+}
+
+void axpy_i8_scalar(std::size_t n, int8_t a, const int8_t* x, int32_t* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+#ifdef ARXIV_SIMD_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 (4 lanes)
+// ---------------------------------------------------------------------------
+
+__attribute__((target("sse2"))) inline float hsum128(__m128 v) {
+    __m128 sums = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 0x55));
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("sse2"))) void axpy_sse2(std::size_t n, float a, const float* x, float* y) {
+    const __m128 va = _mm_set1_ps(a);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 vy = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+        _mm_storeu_ps(y + i, vy);
+    }
+    for (; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+__attribute__((target("sse2"))) float dot_sse2(std::size_t n, const float* x, const float* y) {
+    __m128 acc = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    float sum = hsum128(acc);
+    for (; i < n; ++i)
+        sum += x[i] * y[i];
+    return sum;
+}
+
+// Sign-extends 16 int8 to int16 and multiplies there (|a * x| < 2^15), then
+// sign-extends the products to int32.
+__attribute__((target("sse2"))) void
+axpy_i8_sse2(std::size_t n, int8_t a, const int8_t* x, int32_t* y) {
+    const __m128i va = _mm_set1_epi16(a);
+    const __m128i zero = _mm_setzero_si128();
+    auto add = [](int32_t* out, __m128i products) {
+        const __m128i sign = _mm_cmpgt_epi16(_mm_setzero_si128(), products);
+        auto* lo = reinterpret_cast<__m128i*>(out);
+        auto* hi = reinterpret_cast<__m128i*>(out + 4);
+        _mm_storeu_si128(lo,
+                         _mm_add_epi32(_mm_loadu_si128(lo), _mm_unpacklo_epi16(products, sign)));
+        _mm_storeu_si128(hi,
+                         _mm_add_epi32(_mm_loadu_si128(hi), _mm_unpackhi_epi16(products, sign)));
+    };
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+        const __m128i sign = _mm_cmpgt_epi8(zero, v);
+        add(y + i, _mm_mullo_epi16(_mm_unpacklo_epi8(v, sign), va));
+        add(y + i + 8, _mm_mullo_epi16(_mm_unpackhi_epi8(v, sign), va));
+    }
+    for (; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA (8 lanes)
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma"))) void
+axpy_avx2(std::size_t n, float a, const float* x, float* y) {
+    const __m256 va = _mm256_set1_ps(a);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 vy = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+        _mm256_storeu_ps(y + i, vy);
+    }
+    for (; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+__attribute__((target("avx2,fma"))) float dot_avx2(std::size_t n, const float* x, const float* y) {
+    __m256 acc = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc);
+    float sum = hsum128(_mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+    for (; i < n; ++i)
+        sum += x[i] * y[i];
+    return sum;
+}
+
+__attribute__((target("avx2"))) void
+axpy_i8_avx2(std::size_t n, int8_t a, const int8_t* x, int32_t* y) {
+    const __m256i va = _mm256_set1_epi16(a);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v =
+            _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        const __m256i products = _mm256_mullo_epi16(v, va);
+        auto* lo = reinterpret_cast<__m256i*>(y + i);
+        auto* hi = reinterpret_cast<__m256i*>(y + i + 8);
+        _mm256_storeu_si256(
+            lo,
+            _mm256_add_epi32(_mm256_loadu_si256(lo),
+                             _mm256_cvtepi16_epi32(_mm256_castsi256_si128(products))));
+        _mm256_storeu_si256(
+            hi,
+            _mm256_add_epi32(_mm256_loadu_si256(hi),
+                             _mm256_cvtepi16_epi32(_mm256_extracti128_si256(products, 1))));
+    }
+    for (; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512F (16 lanes, masked tail)
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx512f"))) void
+axpy_avx512(std::size_t n, float a, const float* x, float* y) {
+    const __m512 va = _mm512_set1_ps(a);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512 vy = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i));
+        _mm512_storeu_ps(y + i, vy);
+    }
+    if (i < n) {
+        const auto mask = static_cast<__mmask16>((1u << (n - i)) - 1u);
+        const __m512 vy = _mm512_fmadd_ps(
+            va, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+        _mm512_mask_storeu_ps(y + i, mask, vy);
+    }
+}
+
+__attribute__((target("avx512f"))) float
+dot_avx512(std::size_t n, const float* x, const float* y) {
+    __m512 acc = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc);
+    if (i < n) {
+        const auto mask = static_cast<__mmask16>((1u << (n - i)) - 1u);
+        acc = _mm512_fmadd_ps(
+            _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), acc);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+__attribute__((target("avx512f"))) void
+axpy_i8_avx512(std::size_t n, int8_t a, const int8_t* x, int32_t* y) {
+    const __m512i va = _mm512_set1_epi32(a);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i v =
+            _mm512_cvtepi8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        _mm512_storeu_si512(y + i,
+                            _mm512_add_epi32(_mm512_loadu_si512(y + i), _mm512_mullo_epi32(v, va)));
+    }
+    for (; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+#endif // ARXIV_SIMD_X86
+
+// Ordered by level.
+const Kernels KERNELS[] = {
+    {Level::Scalar, "scalar", axpy_scalar, dot_scalar, axpy_i8_scalar},
+#ifdef ARXIV_SIMD_X86
+    {Level::SSE2, "sse2", axpy_sse2, dot_sse2, axpy_i8_sse2},
+    {Level::AVX2, "avx2", axpy_avx2, dot_avx2, axpy_i8_avx2},
+    {Level::AVX512, "avx512", axpy_avx512, dot_avx512, axpy_i8_avx512},
+#endif
+};
+
+Level detect_cpu() {
+#ifdef ARXIV_SIMD_X86
+    // __builtin_cpu_supports reads cpuid and, for AVX/AVX-512, also checks
+    // that the OS saves the wider registers.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return Level::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return Level::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return Level::SSE2;
+#endif
+    return Level::Scalar;
+}
+
+const Kernels& select_active() {
+    Level level = Detect();
+    if (const char* cap = std::getenv("ARXIV_TUI_SIMD")) {
+        for (const auto& k : KERNELS) {
+            if (std::string_view(cap) == k.name)
+                level = std::min(level, k.level);
+        }
+    }
+    const Kernels& kernels = For(level);
+    spdlog::info("[Simd]: Using {} kernels", kernels.name);
+    return kernels;
+}
+
+} // namespace
+
+Level Detect() {
+    static const Level level = detect_cpu();
+    return level;
+}
+
+const Kernels& For(Level level) {
+    level = std::min(level, Detect());
+    for (auto it = std::rbegin(KERNELS); it != std::rend(KERNELS); ++it) {
+        if (it->level <= level)
+            return *it;
+    }
+    return KERNELS[0];
+}
+
+const Kernels& Active() {
+    static const Kernels& active = select_active();
+    return active;
+}
+
+} // namespace Simd
+} // namespace Arxiv
@@ -0,0 +1,346 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/TermCache.hh"
+
+#include "Arxiv/DatabaseManager.hh"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <memory>
+
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+namespace Arxiv {
+
+TermCache::TermCache(DatabaseManager* db, bool bigrams, size_t capacity)
+    : m_db(db)
+    , m_bigrams(bigrams)
+    , m_capacity(db ? std::max<size_t>(capacity, 1) : std::numeric_limits<size_t>::max()) {
+    if (!m_db)
+        return;
+
+    try {
+        const std::string tokeniser = fmt::format("{:016x}", Ranker::TokeniserHash(m_bigrams));
+        if (m_db->GetMetadata(TOKENISER_KEY) != tokeniser) {
+            // Built by another tokeniser (or never built): start over.
+            m_db->ClearTerms();
+            m_db->SetMetadata(TOKENISER_KEY, tokeniser);
+            m_dict_loaded = true;
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("[TermCache]: Could not check the cache, keeping it in memory: {}", e.what());
+        Detach();
+    }
+}
+
+void TermCache::Detach() {
+    m_db = nullptr;
+    m_capacity = std::numeric_limits<size_t>::max();
+}
+
+void TermCache::LoadDictionary() {
+    if (m_dict_loaded || !m_db)
+        return;
+    m_dict_loaded = true;
+    try {
+        for (const auto& term : m_db->GetTerms())
+            m_dict.Intern(term);
+        m_stored_terms = m_dict.Size();
+        spdlog::info("[TermCache]: Loaded {} terms", m_dict.Size());
+    } catch (const std::exception& e) {
+        // The stored lists refer to ids in the stored dictionary, so they
+        // cannot be used without it.
+        spdlog::warn("[TermCache]: Could not load the dictionary, keeping the cache in memory: {}",
+                     e.what());
+        m_dict = TermDictionary{};
+        m_stored_terms = 0;
+        Detach();
+    }
+}
+
+void TermCache::SyncDictionary() {
+    if (!m_db)
+        return;
+    try {
+        const size_t stored = m_db->CountTerms();
+        if (stored < m_stored_terms) {
+            // Cleared by a process with another tokeniser (see the
+            // constructor), so the ids held here mean nothing there now.
+            spdlog::warn("[TermCache]: Another process rebuilt the stored lists, keeping the "
+                         "cache in memory");
+            Detach();
+            return;
+        }
+        if (stored == m_stored_terms)
+            return;
+        for (const auto& term : m_db->GetTerms(m_stored_terms)) {
+            // A term stored twice: stop, as at a gap in the ids.
+            if (m_dict.Intern(term) != m_stored_terms) {
+                m_dict.Truncate(m_stored_terms);
+                break;
+            }
+            ++m_stored_terms;
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("[TermCache]: Could not read new terms, keeping the cache in memory: {}",
+                     e.what());
+        Detach();
+    }
+}
+
+std::vector<TermList> TermCache::Get(const std::vector<Article>& articles) {
+    const auto shared = GetShared(articles);
+    std::vector<TermList> lists;
+    lists.reserve(shared.size());
+    for (const auto& terms : shared)
+        lists.push_back(*terms);
+    return lists;
+}
+
+std::vector<SharedTermList> TermCache::GetShared(const std::vector<Article>& articles) {
+    std::vector<const Article*> ptrs;
+    ptrs.reserve(articles.size());
+    for (const auto& a : articles)
+        ptrs.push_back(&a);
+
+    std::vector<SharedTermList> lists;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Fill(ptrs, &lists);
+    return lists;
+}
+
+void TermCache::Add(const std::vector<Article>& articles) {
+    std::vector<const Article*> ptrs;
+    ptrs.reserve(articles.size());
+    for (const auto& a : articles)
+        ptrs.push_back(&a);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Fill(ptrs, nullptr);
+}
+
+void TermCache::Remove(const std::vector<std::string>& links) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& link : links)
+        Erase(link);
+}
+
+std::vector<std::pair<TermList, int>>
+TermCache::Get(const std::vector<std::pair<Article, int>>& rated) {
+    std::vector<const Article*> ptrs;
+    ptrs.reserve(rated.size());
+    for (const auto& [article, rating] : rated)
+        ptrs.push_back(&article);
+
+    std::vector<SharedTermList> lists;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Fill(ptrs, &lists);
+    }
+    std::vector<std::pair<TermList, int>> out;
+    out.reserve(rated.size());
+    for (size_t i = 0; i < rated.size(); ++i)
+        out.emplace_back(*lists[i], rated[i].second);
+    return out;
+}
+
+void TermCache::Fill(const std::vector<const Article*>& articles,
+                     std::vector<SharedTermList>* lists) {
+    LoadDictionary();
+    for (int attempt = 1;; ++attempt) {
+        SyncDictionary();
+        if (TryFill(articles, lists))
+            return;
+        if (attempt == STORE_ATTEMPTS) {
+            spdlog::warn("[TermCache]: Term ids kept being taken by another process, keeping "
+                         "the cache in memory");
+            Detach();
+        }
+    }
+}
+
+bool TermCache::TryFill(const std::vector<const Article*>& articles,
+                        std::vector<SharedTermList>* lists) {
+    if (lists)
+        lists->assign(articles.size(), {});
+
+    // Hits in memory first; the misses are read back from the database in
+    // one batch.
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < articles.size(); ++i) {
+        auto it = m_entries.find(articles[i]->link);
+        if (it == m_entries.end() || it->second.content_hash != articles[i]->content_hash) {
+            misses.push_back(i);
+            continue;
+        }
+        m_recent.splice(m_recent.begin(), m_recent, it->second.recent);
+        if (lists)
+            (*lists)[i] = it->second.terms;
+    }
+    if (misses.empty())
+        return true;
+
+    std::unordered_map<std::string, DatabaseManager::ArticleTerms> stored;
+    if (m_db) {
+        std::vector<std::string> links;
+        links.reserve(misses.size());
+        for (size_t i : misses)
+            links.push_back(articles[i]->link);
+        try {
+            for (auto& row : m_db->GetArticleTerms(links))
+                stored.emplace(row.link, std::move(row));
+        } catch (const std::exception& e) {
+            spdlog::warn("[TermCache]: Could not read {} term lists: {}", links.size(), e.what());
+        }
+    }
+
+    std::vector<DatabaseManager::ArticleTerms> rows;
+    std::vector<std::string> inserted;
+    for (size_t i : misses) {
+        const Article& a = *articles[i];
+        // Repeated within `articles`: filled by its first occurrence.
+        auto cached = m_entries.find(a.link);
+        if (cached != m_entries.end() && cached->second.content_hash == a.content_hash) {
+            if (lists)
+                (*lists)[i] = cached->second.terms;
+            continue;
+        }
+        // Stored rows may only use ids the database holds, not ones
+        // interned below and not stored yet.
+        TermList terms;
+        auto row = stored.find(a.link);
+        if (row == stored.end() || row->second.content_hash != a.content_hash ||
+            !UnpackTerms(row->second.terms, m_stored_terms, terms)) {
+            terms = Ranker::Terms(a, m_dict, m_bigrams);
+            if (m_db)
+                rows.push_back({a.link, a.content_hash, PackTerms(terms)});
+        }
+        auto shared = std::make_shared<const TermList>(std::move(terms));
+        if (lists)
+            (*lists)[i] = shared;
+        Insert(a.link, a.content_hash, std::move(shared));
+        inserted.push_back(a.link);
+    }
+    if (!m_db || (rows.empty() && m_stored_terms == m_dict.Size()))
+        return true;
+
+    std::vector<std::string> new_terms;
+    for (size_t id = m_stored_terms; id < m_dict.Size(); ++id)
+        new_terms.push_back(m_dict.Term(static_cast<uint32_t>(id)));
+    try {
+        if (!m_db->StoreTerms(m_stored_terms, new_terms, rows)) {
+            // Another process stored terms under the ids interned here, so
+            // the lists just built would mean other terms to it.
+            for (const auto& link : inserted)
+                Erase(link);
+            m_dict.Truncate(m_stored_terms);
+            return false;
+        }
+        m_stored_terms = m_dict.Size();
+    } catch (const std::exception& e) {
+        // The ids interned here may be taken by another process meanwhile,
+        // so these lists can never be persisted as they are.
+        spdlog::warn("[TermCache]: Could not persist {} term lists, keeping them in memory: {}",
+                     rows.size(),
+                     e.what());
+        Detach();
+    }
+    return true;
+}
+
+void TermCache::Insert(const std::string& link, uint64_t content_hash, SharedTermList terms) {
+    auto it = m_entries.find(link);
+    if (it != m_entries.end()) {
+        it->second.content_hash = content_hash;
+        it->second.terms = std::move(terms);
+        m_recent.splice(m_recent.begin(), m_recent, it->second.recent);
+        return;
+    }
+    m_recent.push_front(link);
+    m_entries.emplace(link, Entry{content_hash, std::move(terms), m_recent.begin()});
+    while (m_entries.size() > m_capacity) {
+        m_entries.erase(m_recent.back());
+        m_recent.pop_back();
+    }
+}
+
+void TermCache::Erase(const std::string& link) {
+    auto it = m_entries.find(link);
+    if (it == m_entries.end())
+        return;
+    m_recent.erase(it->second.recent);
+    m_entries.erase(it);
+}
+
+TermDictionary TermCache::Dictionary() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    LoadDictionary();
+    return m_dict;
+}
+
+Ranker::ColumnMap TermCache::Columns(const Ranker& ranker) {
+    const uint64_t vocab = ranker.VocabularyHash();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    LoadDictionary();
+    if (vocab != m_columns_vocab) {
+        m_columns.clear();
+        m_columns_vocab = vocab;
+    }
+    ranker.MapColumns(m_dict, m_columns);
+    return m_columns;
+}
+
+void TermCache::Backfill() {
+    if (!m_db)
+        return;
+    try {
+        const auto missing = m_db->GetArticlesWithoutTerms();
+        if (missing.empty())
+            return;
+        std::vector<const Article*> ptrs;
+        ptrs.reserve(missing.size());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& a : missing) {
+            // Cached in memory but never persisted: tokenise again so the
+            // row (and its document frequencies) reach the DB.
+            Erase(a.link);
+            ptrs.push_back(&a);
+        }
+        Fill(ptrs, nullptr);
+        spdlog::info("[TermCache]: Backfilled {} articles", missing.size());
+    } catch (const std::exception& e) {
+        spdlog::warn("[TermCache]: Could not backfill term lists: {}", e.what());
+    }
+}
+
+size_t TermCache::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_db ? m_db->CountTermLists() : m_entries.size();
+}
+
+void TermCache::ForEach(const std::function<void(const std::string&, const TermList&)>& fn) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    LoadDictionary();
+    SyncDictionary();
+    if (!m_db) {
+        for (const auto& [link, entry] : m_entries)
+            fn(link, *entry.terms);
+        return;
+    }
+    // Only ids stored so far are known to be in the database's dictionary.
+    const size_t dict_size = m_stored_terms;
+    DatabaseManager* db = m_db;
+    lock.unlock();
+
+    TermList terms;
+    db->ForEachArticleTerms([&](DatabaseManager::ArticleTerms& row) {
+        if (UnpackTerms(row.terms, dict_size, terms))
+            fn(row.link, terms);
+    });
+}
+
+} // namespace Arxiv
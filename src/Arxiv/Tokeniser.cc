@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Tokeniser.hh"
+
+#include "Arxiv/Hash.hh"
+#include "Arxiv/LatexUtils.hh"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace Arxiv {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Stop-word list (common English words unlikely to be informative)
+// ---------------------------------------------------------------------------
+constexpr std::string_view STOP_WORDS[] = {
+    "a",       "an",     "the",   "and",    "or",   "of",    "in",    "on",     "to",
+    "is",      "are",    "was",   "were",   "be",   "been",  "being", "have",   "has",
+    "had",     "do",     "does",  "did",    "will", "would", "could", "should", "may",
+    "might",   "shall",  "can",   "for",    "from", "with",  "this",  "that",   "these",
+    "those",   "it",     "its",   "as",     "at",   "by",    "if",    "so",     "we",
+    "our",     "us",     "not",   "no",     "but",  "than",  "then",  "when",   "where",
+    "which",   "who",    "how",   "all",    "also", "more",  "into",  "about",  "such",
+    "their",   "they",   "them",  "what",   "each", "other", "some",  "any",    "both",
+    "through", "during", "up",    "down",   "out",  "over",  "under", "again",  "further",
+    "between", "while",  "after", "before", "only", "own",   "same",  "too",    "very",
+    "s",       "t",      "just",  "don",    "now",  "i",     "you",   "he",     "she"};
+
+constexpr size_t STOP_COUNT = std::size(STOP_WORDS);
+
+// ---------------------------------------------------------------------------
+// Perfect hash
+//
+// Each word's FNV-1a hash is mixed with a seed and masked to one of SLOTS
+// slots. The first seed that sends every word to a different slot is found
+// at compile time, so a lookup is one hash, one table load and at most one
+// comparison. Editing the list just makes the compiler search again.
+// ---------------------------------------------------------------------------
+
+constexpr size_t SLOTS = 1024;
+constexpr uint8_t EMPTY = 0xff;
+static_assert(STOP_COUNT < EMPTY, "slot indices are stored as uint8_t");
+
+struct StopTable {
+    uint64_t seed;
+    std::array<uint8_t, SLOTS> slots;
+};
+
+constexpr size_t stop_slot(uint64_t word_hash, uint64_t seed) {
+    return Hash::Mix(word_hash ^ seed) & (SLOTS - 1);
+}
+
+constexpr StopTable build_stop_table() {
+    std::array<uint64_t, STOP_COUNT> hashes{};
+    for (size_t i = 0; i < STOP_COUNT; ++i)
+        hashes[i] = Hash::Fnv1a(STOP_WORDS[i]);
+
+    for (uint64_t seed = 1;; ++seed) {
+        StopTable table{seed, {}};
+        for (auto& slot : table.slots)
+            slot = EMPTY;
+        bool perfect = true;
+        for (size_t i = 0; i < STOP_COUNT && perfect; ++i) {
+            auto& slot = table.slots[stop_slot(hashes[i], seed)];
+            perfect = slot == EMPTY;
+            slot = static_cast<uint8_t>(i);
+        }
+        if (perfect)
+            return table;
+    }
+}
+
+constexpr StopTable STOP_TABLE = build_stop_table();
+
+constexpr bool is_alnum(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+constexpr char to_lower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c; }
+
+// Shorter tokens are dropped.
+constexpr size_t MIN_TOKEN_LENGTH = 3;
+
+} // namespace
+
+const std::vector<std::string_view>& Tokeniser::operator()(std::string_view text) {
+    StripLatex(text, m_buffer);
+    m_tokens.clear();
+
+    // Lower-case in place, so each token is a view straight into m_buffer.
+    const size_t n = m_buffer.size();
+    size_t start = 0;
+    for (size_t i = 0; i <= n; ++i) {
+        if (i < n && is_alnum(m_buffer[i])) {
+            m_buffer[i] = to_lower(m_buffer[i]);
+            continue;
+        }
+        const std::string_view token(m_buffer.data() + start, i - start);
+        if (token.size() >= MIN_TOKEN_LENGTH && !IsStopWord(token))
+            m_tokens.push_back(token);
+        start = i + 1;
+    }
+    return m_tokens;
+}
+
+bool Tokeniser::IsStopWord(std::string_view word) {
+    const uint8_t i = STOP_TABLE.slots[stop_slot(Hash::Fnv1a(word), STOP_TABLE.seed)];
+    return i != EMPTY && STOP_WORDS[i] == word;
+}
+
+uint64_t Tokeniser::Fingerprint() {
+    // Bump the tag whenever the token rules change.
+    static const uint64_t hash = [] {
+        std::array<std::string_view, STOP_COUNT> words{};
+        std::copy(std::begin(STOP_WORDS), std::end(STOP_WORDS), words.begin());
+        std::sort(words.begin(), words.end());
+        uint64_t h = Hash::Fnv1a("tokeniser/2 ascii_alnum min_length=3");
+        for (auto w : words) {
+            h = Hash::Fnv1a(w, h);
+            h = Hash::Fnv1a(" ", h);
+        }
+        return h;
+    }();
+    return hash;
+}
+
+} // namespace Arxiv
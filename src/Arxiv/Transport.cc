@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Transport.hh"
+
+#include "Arxiv/Hash.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <thread>
+
+#include "cpr/cpr.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+using Arxiv::CprTransport;
+using Arxiv::FixtureTransport;
+using Arxiv::HttpResponse;
+
+namespace {
+
+// Keep path-safe characters; everything else becomes '_'.
+std::string sanitize(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                          (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '_' || c == '+' ||
+                          c == '/';
+        out += safe ? c : '_';
+    }
+    return out;
+}
+
+std::string_view strip_scheme(std::string_view url) {
+    auto pos = url.find("://");
+    return pos == std::string_view::npos ? url : url.substr(pos + 3);
+}
+
+} // namespace
+
+HttpResponse CprTransport::Perform(const std::string& url,
+                                   std::chrono::milliseconds timeout,
+                                   const CancellationToken* cancel) {
+    cpr::Session session;
+    session.SetUrl(cpr::Url{url});
+    if (timeout.count() > 0)
+        session.SetTimeout(cpr::Timeout{timeout});
+    if (cancel) {
+        // Returning false from the progress callback aborts the transfer.
+        session.SetProgressCallback(cpr::ProgressCallback{
+            [cancel](auto, auto, auto, auto, intptr_t) { return !cancel->IsCancelled(); }});
+    }
+    cpr::Response resp = session.Get();
+    if (cancel && cancel->IsCancelled())
+        return {};
+    return {resp.status_code, std::move(resp.text)};
+}
+
+FixtureTransport::FixtureTransport(std::filesystem::path root, std::chrono::milliseconds latency)
+    : m_root{std::move(root)}
+    , m_latency{latency} {}
+
+std::filesystem::path FixtureTransport::KeyFor(const std::string& url) {
+    std::string_view rest = strip_scheme(url);
+    std::string_view query;
+    if (auto q = rest.find('?'); q != std::string_view::npos) {
+        query = rest.substr(q + 1);
+        rest = rest.substr(0, q);
+    }
+    while (!rest.empty() && rest.back() == '/')
+        rest.remove_suffix(1);
+
+    std::string key = sanitize(rest);
+    if (!query.empty())
+        key += fmt::format("@{:016x}", Hash::Fnv1a(query));
+    return std::filesystem::path(key);
+}
+
+HttpResponse FixtureTransport::Perform(const std::string& url,
+                                       std::chrono::milliseconds /*timeout*/,
+                                       const CancellationToken* cancel) {
+    ++m_requests;
+    // Sleep in short slices so cancellation behaves like an aborted transfer.
+    constexpr std::chrono::milliseconds slice{5};
+    const auto wake = std::chrono::steady_clock::now() + m_latency.load();
+    for (auto now = std::chrono::steady_clock::now(); now < wake;
+         now = std::chrono::steady_clock::now()) {
+        if (CancellationToken::IsCancelled(cancel))
+            return {};
+        const std::chrono::steady_clock::duration left = wake - now;
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(slice, left));
+    }
+
+    auto path = m_root / KeyFor(url);
+    if (!std::filesystem::is_regular_file(path)) {
+        const auto base = KeyFor(url.substr(0, url.find('?')));
+        path = m_root / base;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        spdlog::debug("[Transport]: No fixture for {} ({})", url, path.string());
+        return {404, {}};
+    }
+    std::ostringstream body;
+    body << in.rdbuf();
+    return {200, body.str()};
+}
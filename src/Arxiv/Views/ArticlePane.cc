@@ -142,8 +142,10 @@ void ArxivApp::SetupArticlePane() {
 
         UpdateVisibleRange();
 
-        bool show_scores =
-            (core.GetFilterView() == AppCore::FilterView::Recommended) && core.IsRankerTrained();
+        // Scores come from the column AppCore filled when it built the view.
+        const auto& scores = core.GetCurrentScores();
+        bool show_scores = (core.GetFilterView() == AppCore::FilterView::Recommended) &&
+                           scores.size() == articles.size();
 
         // Fixed widths for non-title columns (chars).
         // title gets the remaining space.
@@ -221,7 +223,7 @@ void ArxivApp::SetupArticlePane() {
             // Compute score badge if needed.
             std::string score_str;
             if (show_scores) {
-                float score = core.GetPredictedScore(article);
+                float score = scores[i];
                 char buf[16];
                 std::snprintf(buf, sizeof(buf), "[%.1f★]", static_cast<double>(score));
                 score_str = buf;
@@ -73,6 +73,11 @@ void ArxivApp::SetupMainRenderer() {
         case AppCore::FilterView::Unread:
             filter_label = "Unread";
             break;
+        case AppCore::FilterView::Related:
+            filter_label = "Related";
+            if (core.IsRelatedBuilding())
+                filter_detail = "building…";
+            break;
         case AppCore::FilterView::TagBase:
             filter_label = "#" + core.GetTagNameForFilter(core.GetFilterIndex());
             break;
@@ -514,6 +519,17 @@ bool ArxivApp::HandleGlobalEvent(ftxui::Event event) {
         return true;
     }
 
+    // "More like this": list the articles nearest the focused one
+    if (key_bindings.matches(event, KeyBindings::Action::ShowRelated)) {
+        const auto& articles = core.GetCurrentArticles();
+        if (!articles.empty()) {
+            const auto link = articles[static_cast<size_t>(core.GetArticleIndex())].link;
+            spdlog::info("show_related link={}", link);
+            core.ShowRelated(link);
+        }
+        return true;
+    }
+
     // Open selected (or focused) article(s) in the default browser
     if (key_bindings.matches(event, KeyBindings::Action::OpenInBrowser)) {
         auto links = core.GetLinksToOpen();
@@ -564,6 +580,8 @@ bool ArxivApp::HandleGlobalEvent(ftxui::Event event) {
             err_msg = "";
             return true;
         }
+        // Start unwinding fetches and training now so teardown only joins.
+        core.CancelBackgroundWork();
         screen.Exit();
         return true;
     }
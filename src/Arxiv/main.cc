@@ -5,12 +5,14 @@
 #include "Arxiv/App.hh"
 #include "Arxiv/Config.hh"
 #include "Arxiv/CrashHandler.hh"
+#include "Arxiv/Daemon.hh"
 #include "Arxiv/DatabaseManager.hh"
 #include "Arxiv/Fetcher.hh"
 #include "Arxiv/Paths.hh"
 #include "Arxiv/Replay.hh"
 
 #include <chrono>
+#include <csignal>
 #include <cstring>
 #include <ctime>
 #include <iostream>
@@ -32,6 +34,15 @@ static std::string MakeSessionId() {
     return std::string(buf) + "-" + std::to_string(getpid());
 }
 
+// Set while --daemon is serving so SIGINT/SIGTERM can stop it cleanly
+// (Daemon::Stop only writes to a pipe, so it is safe in a handler).
+static Arxiv::Daemon* g_daemon = nullptr;
+
+extern "C" void StopDaemon(int) {
+    if (g_daemon)
+        g_daemon->Stop();
+}
+
 // Rotating logger: up to 5 MB per file, keep 3 rotated files.
 // Default level is debug; --trace enables trace-level output.
 void CreateLogger(bool trace_mode, const std::filesystem::path& log_path) {
@@ -52,6 +63,7 @@ int main(int argc, char* argv[]) {
     std::string export_yaml_path;
     bool trace_mode = false;
     bool fetch_only = false;
+    bool daemon_mode = false;
     for (int i = 1; i < argc; ++i) {
         if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
             replay_file = argv[++i];
@@ -63,6 +75,8 @@ int main(int argc, char* argv[]) {
             trace_mode = true;
         } else if (std::strcmp(argv[i], "--fetch") == 0) {
             fetch_only = true;
+        } else if (std::strcmp(argv[i], "--daemon") == 0) {
+            daemon_mode = true;
         }
     }
 
@@ -82,17 +96,57 @@ int main(int argc, char* argv[]) {
         config.set_download_dir((paths.data_dir / "downloads").string());
     config.set_db_file((paths.data_dir / "articles.db").string());
     config.set_ranker_file((paths.data_dir / "ranker.bin").string());
+    config.set_daemon_socket(Arxiv::Daemon::DefaultSocketPath(paths.state_dir.string()));
+
+    // Background daemon: own the DB, fetcher and ranker, and serve TUI/GUI
+    // clients over a Unix socket until SIGINT/SIGTERM.
+    if (daemon_mode) {
+        if (Arxiv::DaemonClient::Connect(config.get_daemon_socket())) {
+            std::cerr << "A daemon is already running on " << config.get_daemon_socket() << "\n";
+            return 1;
+        }
+        spdlog::info("Daemon mode: starting");
+        std::signal(SIGPIPE, SIG_IGN);
+        Arxiv::AppCore core(
+            config,
+            std::make_unique<Arxiv::DatabaseManager>(config.get_db_file()),
+            std::make_unique<Arxiv::Fetcher>(config.get_topics(), config.get_download_dir()),
+            Arxiv::AppCore::FetchMode::Async);
+        core.ReloadKeywords();
+        try {
+            Arxiv::Daemon daemon(core, config.get_daemon_socket());
+            g_daemon = &daemon;
+            std::signal(SIGINT, StopDaemon);
+            std::signal(SIGTERM, StopDaemon);
+            std::cout << "Serving on " << daemon.SocketPath() << "\n";
+            daemon.Run(config.get_auto_refresh_minutes() > 0);
+            g_daemon = nullptr;
+            // Abort any fetch still in flight before ~Daemon joins it.
+            core.CancelBackgroundWork();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        spdlog::info("Daemon mode: stopped");
+        return 0;
+    }
 
     // Headless feed fetch: update the DB and exit without opening the TUI.
-    // Suitable for use in a cron job to keep the database current.
+    // Suitable for use in a cron job to keep the database current. With a
+    // daemon running, the daemon fetches and stores instead.
     if (fetch_only) {
         spdlog::info("Fetch-only mode: fetching articles");
-        Arxiv::Fetcher fetcher(config.get_topics(), config.get_download_dir());
+        auto fetcher = Arxiv::MakeFetcher(config);
         Arxiv::DatabaseManager db(config.get_db_file());
-        auto articles = fetcher.Fetch();
+        fetcher->SetKnownItemFilter([&db](const std::string& link, uint64_t hash) {
+            return db.IsKnownArticle(link, hash);
+        });
+        auto articles = fetcher->Fetch();
         db.AddArticles(articles);
-        std::cout << "Fetched " << articles.size() << " article(s).\n";
-        spdlog::info("Fetch-only mode: done ({} articles)", articles.size());
+        const auto* via_daemon = dynamic_cast<const Arxiv::DaemonFetcher*>(fetcher.get());
+        const std::size_t count = via_daemon ? via_daemon->LastFetchedCount() : articles.size();
+        std::cout << "Fetched " << count << " article(s).\n";
+        spdlog::info("Fetch-only mode: done ({} articles)", count);
         return 0;
     }
 
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "AllocationCounter.hh"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+
+} // namespace
+
+namespace arxiv_tui {
+namespace test {
+
+void BeginCounting() {
+    allocations = 0;
+    counting = true;
+}
+
+std::size_t EndCounting() {
+    counting = false;
+    return allocations;
+}
+
+} // namespace test
+} // namespace arxiv_tui
+
+// Replaces the global operator new for the whole binary; it only counts
+// between BeginCounting and EndCounting, on the calling thread.
+void* operator new(std::size_t size) {
+    if (counting)
+        ++allocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
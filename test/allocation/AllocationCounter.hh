@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+
+namespace arxiv_tui {
+namespace test {
+
+// Heap allocation counting for the allocation tests and the benchmarks.
+// AllocationCounter.cc replaces the global operator new, so it is linked
+// only into the targets test/CMakeLists.txt builds with the matching
+// warning suppression, never into unit_tests. Counts are per thread.
+
+// Start counting this thread's allocations from zero.
+void BeginCounting();
+// Stop counting; returns the allocations since BeginCounting.
+std::size_t EndCounting();
+
+// Allocations made by `fn` on this thread.
+template <typename Fn> std::size_t count_allocations(Fn&& fn) {
+    BeginCounting();
+    fn();
+    return EndCounting();
+}
+
+} // namespace test
+} // namespace arxiv_tui
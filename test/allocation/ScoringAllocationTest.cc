@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+// Built into allocation_tests, which links AllocationCounter.cc; see
+// AllocationCounter.hh.
+
+#include "AllocationCounter.hh"
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/TermCache.hh"
+#include "Arxiv/Tokeniser.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Arxiv;
+using arxiv_tui::test::count_allocations;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<Article> corpus(int n) {
+    std::vector<Article> articles;
+    for (int i = 0; i < n; ++i) {
+        Article a;
+        a.link = "https://arxiv.org/abs/tok." + std::to_string(i);
+        a.title = (i % 2 ? "Quantum field theory on the lattice " : "Cooking with neural networks ") +
+                  std::to_string(i);
+        a.abstract = "We study $\\alpha_s$ corrections to \\textbf{renormalisation} group flows "
+                     "and their extraordinarily-long-hyphenated consequences for experiment " +
+                     std::to_string(i);
+        articles.push_back(a);
+    }
+    return articles;
+}
+
+// ---------------------------------------------------------------------------
+// Allocation-free scoring
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Scoring does not allocate per article", "[tokeniser][ranker]") {
+    const auto articles = corpus(400);
+    std::vector<std::pair<Article, int>> rated;
+    for (int i = 0; i < 8; ++i)
+        rated.emplace_back(articles[static_cast<size_t>(i)], i % 2 ? 5 : 1);
+
+    // Each check runs once to let the reused buffers grow to fit the
+    // corpus, then counts a second identical pass.
+
+    SECTION("Tokeniser, once its buffers have grown") {
+        Tokeniser tokenise;
+        std::size_t n = 0;
+        auto pass = [&] {
+            for (const auto& a : articles) {
+                n += tokenise(a.title).size();
+                n += tokenise(a.abstract).size();
+            }
+        };
+        pass();
+        REQUIRE(count_allocations(pass) == 0);
+        REQUIRE(n > 0);
+    }
+
+    for (int hash_bits : {0, 12}) {
+        INFO("hash_bits = " << hash_bits);
+        Ranker ranker(hash_bits);
+        ranker.FitVocabulary(articles);
+        REQUIRE(ranker.Train(rated));
+
+        float total = 0.0f;
+        auto predict_all = [&] {
+            for (const auto& a : articles)
+                total += ranker.Predict(a);
+        };
+        predict_all();
+        REQUIRE(count_allocations(predict_all) == 0);
+        REQUIRE(total > 0.0f);
+
+        // The batch allocates its score and hidden-layer arrays, and nothing
+        // that grows with the number of articles.
+        const std::vector<Article> few(articles.begin(), articles.begin() + 10);
+        ranker.PredictBatch(articles, 1);
+        const auto small = count_allocations([&] { ranker.PredictBatch(few, 1); });
+        const auto large = count_allocations([&] { ranker.PredictBatch(articles, 1); });
+        REQUIRE(large == small);
+    }
+}
+
+TEST_CASE("Scoring cached term lists does not allocate per article", "[term_cache][ranker]") {
+    // The path AppCore::GetPredictedScores takes: lists shared out of the
+    // TermCache, scored through the column map.
+    const auto articles = corpus(400);
+    const std::vector<Article> few(articles.begin(), articles.begin() + 10);
+    std::vector<std::pair<Article, int>> rated;
+    for (int i = 0; i < 8; ++i)
+        rated.emplace_back(articles[static_cast<size_t>(i)], i % 2 ? 5 : 1);
+
+    for (int hash_bits : {0, 12}) {
+        INFO("hash_bits = " << hash_bits);
+        TermCache cache(nullptr, hash_bits > 0);
+        Ranker ranker(hash_bits);
+        const auto docs = cache.Get(articles);
+        ranker.FitVocabulary(docs, cache.Dictionary());
+        REQUIRE(ranker.Train(cache.Get(rated), cache.Columns(ranker)));
+
+        // Per batch: the list and score arrays, the hidden-layer matrix and
+        // the column map copy; nothing that grows with the batch.
+        float total = 0.0f;
+        auto score = [&](const std::vector<Article>& batch) {
+            const auto shared = cache.GetShared(batch);
+            for (float s : ranker.PredictBatch(shared, cache.Columns(ranker), 1))
+                total += s;
+        };
+        score(articles);
+        const auto small = count_allocations([&] { score(few); });
+        const auto large = count_allocations([&] { score(articles); });
+        REQUIRE(large == small);
+        REQUIRE(total > 0.0f);
+    }
+}
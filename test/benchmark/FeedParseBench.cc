@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+// ---------------------------------------------------------------------------
+// Feed-parsing throughput benchmarks
+//
+// Measures Fetcher::ParseFeed / ParseAtomFeed on the sample feeds in
+// test/fixtures/feeds, with their items repeated to realistic daily-listing
+// and backfill sizes. Each run gets its own copy of the document moved into
+// the parser, exactly as Fetch() and FetchSince() hand over response bodies,
+// so the numbers cover parsing alone.
+//
+// Not registered with CTest. Run ./benchmarks (optionally with
+// --benchmark-samples N) and divide the mean by the item count in the
+// benchmark name for per-item cost.
+// ---------------------------------------------------------------------------
+
+#include "Arxiv/Article.hh"
+#include "Arxiv/Fetcher.hh"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::string read_fixture(const std::string& name) {
+    std::ifstream in(fs::path(ARXIV_TUI_FIXTURES_DIR) / "feeds" / name, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+/// Repeat the elements between the first `open` tag and the `close` tag of
+/// the container until the document holds at least `count` of them.
+static std::string inflate(const std::string& doc,
+                           const std::string& open,
+                           const std::string& close,
+                           size_t count,
+                           size_t per_copy) {
+    const auto first = doc.find(open);
+    const auto last = doc.find(close);
+    if (first == std::string::npos || last == std::string::npos || per_copy == 0)
+        return doc;
+    const std::string head = doc.substr(0, first);
+    const std::string body = doc.substr(first, last - first);
+    const std::string tail = doc.substr(last);
+
+    std::string out = head;
+    out.reserve(head.size() + body.size() * (count / per_copy + 1) + tail.size());
+    for (size_t n = 0; n < count; n += per_copy)
+        out += body;
+    out += tail;
+    return out;
+}
+
+template <typename Parse>
+static void bench_parse(const std::string& name, const std::string& doc, Parse parse) {
+    BENCHMARK_ADVANCED(name.c_str())(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::string> inputs(static_cast<size_t>(meter.runs()), doc);
+        meter.measure([&](int i) { return parse(std::move(inputs[static_cast<size_t>(i)])); });
+    };
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Feed parse throughput", "[benchmark][fetcher]") {
+    const Arxiv::Fetcher fetcher({"hep-ph"});
+
+    const std::string rss = read_fixture("hep-ph.rss");
+    const std::string atom = read_fixture("hep-ph.atom");
+    const auto rss_items = fetcher.ParseFeed(rss).size();
+    const auto atom_items = fetcher.ParseAtomFeed(atom).size();
+    REQUIRE(rss_items > 0);
+    REQUIRE(atom_items > 0);
+
+    // A busy hep-ph day announces a few hundred items; FetchSince pages hold
+    // 200 entries and a long backfill can span thousands.
+    for (size_t n : {std::size_t{300}, std::size_t{3000}}) {
+        const auto rss_doc = inflate(rss, "<item>", "</channel>", n, rss_items);
+        const auto atom_doc = inflate(atom, "<entry>", "</feed>", n, atom_items);
+        REQUIRE(fetcher.ParseFeed(rss_doc).size() >= n);
+        REQUIRE(fetcher.ParseAtomFeed(atom_doc).size() >= n);
+
+        bench_parse("ParseFeed rss " + std::to_string(n) + " items", rss_doc, [&](std::string d) {
+            return fetcher.ParseFeed(std::move(d));
+        });
+        bench_parse("ParseAtomFeed atom " + std::to_string(n) + " items",
+                    atom_doc,
+                    [&](std::string d) { return fetcher.ParseAtomFeed(std::move(d)); });
+    }
+
+    BENCHMARK("ParseDate RFC-822") {
+        return fetcher.ParseDate("Mon, 25 Mar 2024 00:00:00 -0400");
+    };
+    BENCHMARK("ParseDate ISO-8601") {
+        return fetcher.ParseDate("2024-03-22T17:59:42Z");
+    };
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+// ---------------------------------------------------------------------------
+// End-to-end ingest benchmark
+//
+// Runs the refresh pipeline — Fetcher::Fetch over a FixtureTransport, then
+// DatabaseManager::AddArticles into an on-disk database — for feeds of 1k,
+// 10k and 100k generated items, with no network. Each size runs once (a
+// 100k ingest takes seconds), so this reports wall-clock stage timings
+// rather than Catch2 BENCHMARK statistics.
+//
+// Hidden from the default run:
+//   ./benchmarks "[ingest]"
+// Set ARXIV_TUI_BENCH_LATENCY_MS to inject per-request latency.
+// ---------------------------------------------------------------------------
+
+#include "Arxiv/Article.hh"
+#include "Arxiv/DatabaseManager.hh"
+#include "Arxiv/Fetcher.hh"
+#include "Arxiv/Transport.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/// An RSS document in the rss.arxiv.org layout with `count` distinct items.
+/// One item in four carries LaTeX markup so the transcoder's slow path is
+/// exercised at a realistic rate.
+static std::string make_feed(size_t count) {
+    std::string xml = R"(<?xml version='1.0' encoding='UTF-8'?>
+<rss xmlns:arxiv="http://arxiv.org/schemas/atom" xmlns:dc="http://purl.org/dc/elements/1.1/" version="2.0">
+  <channel>
+    <title>hep-ph updates on arXiv.org</title>
+)";
+    char id[16];
+    for (size_t i = 0; i < count; ++i) {
+        std::snprintf(id, sizeof(id), "24%02zu.%05zu", 1 + i / 100000, i % 100000);
+        const bool latex = i % 4 == 0;
+        xml += "    <item>\n      <title>";
+        xml += latex ? "Constraints on \\textbf{dark photons} from $\\gamma\\gamma$ data "
+                     : "Constraints on dark photons from diphoton data ";
+        xml += std::to_string(i);
+        xml += "</title>\n      <link>https://arxiv.org/abs/";
+        xml += id;
+        xml += "</link>\n      <description>arXiv:";
+        xml += id;
+        xml += "v1 Announce Type: new\nAbstract: ";
+        for (int s = 0; s < 6; ++s) {
+            xml += latex ? "We compute the $\\mathcal{O}(\\alpha_s)$ corrections following "
+                           "Schr\\\"oder and find the \\emph{heavy-top limit} adequate. "
+                         : "We compute the next-to-leading order corrections and find the "
+                           "heavy-top limit adequate across the kinematic range. ";
+        }
+        xml += "</description>\n      <category>hep-ph</category>\n"
+               "      <pubDate>Mon, 25 Mar 2024 00:00:00 -0400</pubDate>\n"
+               "      <arxiv:announce_type>new</arxiv:announce_type>\n"
+               "      <dc:creator>A. Author, B. Author, C. Author</dc:creator>\n    </item>\n";
+    }
+    xml += "  </channel>\n</rss>\n";
+    return xml;
+}
+
+static double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Ingest throughput over recorded fixtures", "[.ingest][benchmark]") {
+    const char* env_latency = std::getenv("ARXIV_TUI_BENCH_LATENCY_MS");
+    const std::chrono::milliseconds latency{env_latency ? std::atol(env_latency) : 0};
+    const auto root =
+        fs::temp_directory_path() / ("arxiv_ingest_bench_" + std::to_string(::getpid()));
+
+    std::printf("%10s %12s %12s %12s %14s\n",
+                "articles",
+                "fetch ms",
+                "insert ms",
+                "total ms",
+                "articles/s");
+    for (size_t n : {std::size_t{1000}, std::size_t{10000}, std::size_t{100000}}) {
+        fs::remove_all(root);
+        fs::create_directories(root);
+        const auto feed_path =
+            root / Arxiv::FixtureTransport::KeyFor("http://rss.arxiv.org/rss/hep-ph");
+        fs::create_directories(feed_path.parent_path());
+        std::ofstream(feed_path, std::ios::binary) << make_feed(n);
+
+        Arxiv::Fetcher fetcher({"hep-ph"},
+                               (root / "downloads").string(),
+                               std::make_unique<Arxiv::FixtureTransport>(root, latency));
+        Arxiv::DatabaseManager db((root / "bench.db").string());
+
+        const auto start = Clock::now();
+        auto articles = fetcher.Fetch();
+        const double fetch_ms = ms_since(start);
+        const auto insert_start = Clock::now();
+        db.AddArticles(articles);
+        const double insert_ms = ms_since(insert_start);
+        const double total_ms = ms_since(start);
+
+        REQUIRE(articles.size() == n);
+        std::printf("%10zu %12.1f %12.1f %12.1f %14.0f\n",
+                    n,
+                    fetch_ms,
+                    insert_ms,
+                    total_ms,
+                    static_cast<double>(n) / (total_ms / 1000.0));
+    }
+    fs::remove_all(root);
+}
@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+// ---------------------------------------------------------------------------
+// LaTeX transcoder benchmarks
+//
+// Compares the memchr fast path (no metacharacters — most titles and author
+// lists) with a markup-heavy abstract, for each entry point.
+// ---------------------------------------------------------------------------
+
+#include "Arxiv/LatexUtils.hh"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+TEST_CASE("LaTeX transcode throughput", "[benchmark][latex]") {
+    const std::string plain =
+        "We study the production of Higgs boson pairs in gluon fusion at next-to-leading order "
+        "and compare the full top-mass dependence with the heavy-top limit across the "
+        "kinematic range accessible at the high-luminosity LHC.";
+    const std::string marked =
+        "We compute \\textbf{NLO} corrections to $gg \\to HH$ with the full $m_t$ dependence, "
+        "following G\\\"unter and Sch\\'{e}ma. The \\emph{heavy-top limit} overestimates "
+        "$\\sigma$ by up to 15\\% near threshold \\cite{ref}; see \\textit{e.g.} "
+        "$$\\int_0^1 dx\\, f(x)$$ for the \\texttt{HPAIR} comparison.";
+
+    BENCHMARK("StripLatex plain") { return Arxiv::StripLatex(plain); };
+    BENCHMARK("StripLatex marked") { return Arxiv::StripLatex(marked); };
+    BENCHMARK("LatexToMarkdown plain") { return Arxiv::LatexToMarkdown(plain); };
+    BENCHMARK("LatexToMarkdown marked") { return Arxiv::LatexToMarkdown(marked); };
+    BENCHMARK("TranscodeLatex marked") { return Arxiv::TranscodeLatex(marked); };
+}
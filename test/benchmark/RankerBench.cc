@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+// ---------------------------------------------------------------------------
+// Ranker benchmarks
+//
+// "[ranker]" times each stage of the ranking pipeline — tokenising,
+// fitting the vocabulary, vectorising, training, the three predictors and
+// Save/Load — on synthetic corpora of 1k, 10k and 100k articles, training
+// on 10, 100 and 10k ratings. Every stage runs on one thread and reports
+// ns and heap allocations per item (article, rating, or file for
+// Save/Load) and the peak RSS while it ran. The table goes to stdout and
+// the same rows, as JSON, to $ARXIV_TUI_BENCH_JSON (default
+// ranker_bench.json) for comparing releases.
+//
+// "[quantise]" scores a batch of 100k pre-tokenised articles with a hashed
+// ranker at a few feature-space sizes, once with the fp32 weights and once
+// after Ranker::Quantise. Tokenising is done up front, so the timings are
+// the vectoriser and the network — at 2^20 columns the first layer no
+// longer fits in cache and the int8 copy's smaller rows show.
+//
+// Batches take long enough that wall-clock timings (best of three) are
+// reported rather than Catch2 BENCHMARK statistics. Hidden from the
+// default run:
+//   ./benchmarks "[ranker]"
+//   ./benchmarks "[quantise]"
+// ---------------------------------------------------------------------------
+
+#include "allocation/AllocationCounter.hh"
+#include "Arxiv/Article.hh"
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/Terms.hh"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/// `count` articles drawn from a 50k-word vocabulary: an 8-word title and a
+/// 60-word abstract each, so every article touches a few hundred columns.
+static std::vector<Arxiv::Article> make_articles(size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> word(0, 49999);
+    auto words = [&](int n) {
+        std::string text;
+        for (int i = 0; i < n; ++i)
+            text += "term" + std::to_string(word(rng)) + " ";
+        return text;
+    };
+    std::vector<Arxiv::Article> articles(count);
+    for (size_t i = 0; i < count; ++i) {
+        articles[i].link = "https://arxiv.org/abs/bench." + std::to_string(i);
+        articles[i].title = words(8);
+        articles[i].abstract = words(60);
+    }
+    return articles;
+}
+
+/// Best of three runs of `fn`, in milliseconds.
+template <typename Fn> static double best_ms(Fn fn) {
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = Clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        best = run == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+/// Forget the process's peak RSS so far, where the kernel allows it (Linux
+/// 4.0+), so the next reading covers one stage only.
+static void reset_peak_rss() {
+#ifdef __linux__
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+/// Peak resident set size in KiB.
+static long peak_rss_kib() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+/// One row of the "[ranker]" report.
+struct Sample {
+    std::string stage;
+    size_t articles;
+    size_t ratings;
+    size_t items; // what the per-item figures divide by
+    double ns_per_item;
+    double allocations_per_item;
+    long peak_rss_kib;
+};
+
+/// Time `runs` calls of `fn` (best of), counting the last one's
+/// allocations, and print the row.
+template <typename Fn>
+static Sample measure(
+    const char* stage, size_t articles, size_t ratings, size_t items, int runs, Fn fn) {
+    reset_peak_rss();
+    double best = 0.0;
+    size_t counted = 0;
+    for (int run = 0; run < runs; ++run) {
+        const bool last = run == runs - 1;
+        if (last)
+            arxiv_tui::test::BeginCounting();
+        const auto start = Clock::now();
+        fn();
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (last)
+            counted = arxiv_tui::test::EndCounting();
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+    const auto n = static_cast<double>(items);
+    Sample sample{stage,
+                  articles,
+                  ratings,
+                  items,
+                  best / n,
+                  static_cast<double>(counted) / n,
+                  peak_rss_kib()};
+    std::printf("%-16s %9zu %8zu %14.0f %14.2f %12.1f\n",
+                stage,
+                articles,
+                ratings,
+                sample.ns_per_item,
+                sample.allocations_per_item,
+                static_cast<double>(sample.peak_rss_kib) / 1024.0);
+    return sample;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Ranker pipeline cost per stage", "[.ranker][benchmark]") {
+    const fs::path model_path =
+        fs::temp_directory_path() / ("arxiv_ranker_bench_" + std::to_string(::getpid()) + ".bin");
+    const char* env_json = std::getenv("ARXIV_TUI_BENCH_JSON");
+    const std::string json_path = env_json ? env_json : "ranker_bench.json";
+    std::vector<Sample> samples;
+
+    std::printf("%-16s %9s %8s %14s %14s %12s\n",
+                "stage",
+                "articles",
+                "ratings",
+                "ns/item",
+                "allocs/item",
+                "peak MiB");
+    for (size_t n : {size_t{1000}, size_t{10000}, size_t{100000}}) {
+        const auto articles = make_articles(n);
+        Arxiv::TermDictionary dict;
+        std::vector<Arxiv::TermList> docs;
+        samples.push_back(measure("tokenise", n, 0, n, 3, [&] {
+            dict = Arxiv::TermDictionary{};
+            docs.clear();
+            for (const auto& article : articles)
+                docs.push_back(Arxiv::Ranker::Terms(article, dict, false));
+        }));
+
+        Arxiv::Ranker ranker;
+        samples.push_back(
+            measure("fit_vocabulary", n, 0, n, 3, [&] { ranker.FitVocabulary(docs, dict); }));
+
+        Arxiv::Ranker::ColumnMap columns;
+        ranker.MapColumns(dict, columns);
+        Arxiv::Ranker::SparseVector vec;
+        samples.push_back(measure("vectorise", n, 0, n, 3, [&] {
+            for (const auto& terms : docs)
+                ranker.Features(terms, columns, vec);
+        }));
+
+        // A training run is too slow to repeat; the last one's model is
+        // scored below.
+        for (size_t r : {size_t{10}, size_t{100}, size_t{10000}}) {
+            if (r > n)
+                continue;
+            std::vector<std::pair<Arxiv::TermList, int>> rated;
+            for (size_t i = 0; i < r; ++i)
+                rated.emplace_back(docs[i], 1 + static_cast<int>(i % 5));
+            samples.push_back(measure("train", n, r, r, 1, [&] {
+                REQUIRE(ranker.Train(rated, columns, false, nullptr, 1));
+            }));
+        }
+
+        std::vector<float> scores;
+        samples.push_back(measure("predict_batch", n, 0, n, 3, [&] {
+            scores = ranker.PredictBatch(docs, columns, 1);
+        }));
+        REQUIRE(scores.size() == n);
+        float sum = 0.0f;
+        samples.push_back(measure("predict", n, 0, n, 3, [&] {
+            for (const auto& article : articles)
+                sum += ranker.Predict(article);
+        }));
+        ranker.FitKeywords({"term1", "term22", "term333", "term4444", "term5555"});
+        samples.push_back(measure("predict_keyword", n, 0, n, 3, [&] {
+            for (const auto& article : articles)
+                sum += ranker.PredictKeyword(article);
+        }));
+        REQUIRE(sum > 0.0f);
+
+        samples.push_back(measure(
+            "save", n, 0, 1, 3, [&] { REQUIRE(ranker.Save(model_path.string())); }));
+        Arxiv::Ranker loaded;
+        samples.push_back(measure(
+            "load", n, 0, 1, 3, [&] { REQUIRE(loaded.Load(model_path.string())); }));
+        fs::remove(model_path);
+    }
+
+    nlohmann::json report;
+    report["benchmark"] = "ranker";
+    report["version"] = ARXIV_TUI_VERSION;
+    report["results"] = nlohmann::json::array();
+    for (const auto& s : samples) {
+        report["results"].push_back({{"stage", s.stage},
+                                     {"articles", s.articles},
+                                     {"ratings", s.ratings},
+                                     {"items", s.items},
+                                     {"ns_per_item", s.ns_per_item},
+                                     {"allocations_per_item", s.allocations_per_item},
+                                     {"peak_rss_kib", s.peak_rss_kib}});
+    }
+    std::ofstream(json_path) << report.dump(2) << "\n";
+    std::printf("Wrote %s\n", json_path.c_str());
+}
+
+TEST_CASE("Ranker int8 scoring throughput", "[.quantise][benchmark]") {
+    constexpr size_t BATCH = 100000;
+    const auto articles = make_articles(BATCH);
+    Arxiv::TermDictionary dict;
+    std::vector<Arxiv::TermList> docs;
+    docs.reserve(BATCH);
+    for (const auto& article : articles)
+        docs.push_back(Arxiv::Ranker::Terms(article, dict, true));
+
+    std::vector<std::pair<Arxiv::TermList, int>> rated;
+    for (size_t i = 0; i < 200; ++i)
+        rated.emplace_back(docs[i], 1 + static_cast<int>(i % 5));
+
+    std::printf("%10s %8s %12s %12s %14s %14s %10s\n",
+                "features",
+                "threads",
+                "fp32 ms",
+                "int8 ms",
+                "fp32 art/s",
+                "int8 art/s",
+                "max err");
+    for (int hash_bits : {12, 16, 20}) {
+        Arxiv::Ranker fp32{hash_bits};
+        Arxiv::Ranker::ColumnMap columns;
+        fp32.MapColumns(dict, columns);
+        REQUIRE(fp32.Train(rated, columns));
+        Arxiv::Ranker int8 = fp32;
+        int8.Quantise();
+
+        for (unsigned threads : {1u, 0u}) {
+            std::vector<float> fp32_scores, int8_scores;
+            const double fp32_ms =
+                best_ms([&] { fp32_scores = fp32.PredictBatch(docs, columns, threads); });
+            const double int8_ms =
+                best_ms([&] { int8_scores = int8.PredictBatch(docs, columns, threads); });
+
+            float max_error = 0.0f;
+            for (size_t i = 0; i < BATCH; ++i)
+                max_error = std::max(max_error, std::abs(fp32_scores[i] - int8_scores[i]));
+            REQUIRE(max_error < 0.1f);
+
+            std::printf("%10zu %8s %12.1f %12.1f %14.0f %14.0f %10.4f\n",
+                        size_t{1} << hash_bits,
+                        threads == 0 ? "all" : "1",
+                        fp32_ms,
+                        int8_ms,
+                        static_cast<double>(BATCH) / (fp32_ms / 1000.0),
+                        static_cast<double>(BATCH) / (int8_ms / 1000.0),
+                        static_cast<double>(max_error));
+        }
+    }
+}
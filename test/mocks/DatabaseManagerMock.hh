@@ -29,6 +29,9 @@ class DatabaseManagerMock : public Arxiv::DatabaseManager {
         m_expectations.push_back(NAMED_ALLOW_CALL(*this, AddArticle(ANY(Arxiv::Article))));
         m_expectations.push_back(
             NAMED_ALLOW_CALL(*this, AddArticles(ANY(std::vector<Arxiv::Article>))));
+        // Default: nothing is known, so the fetcher keeps every feed item
+        m_expectations.push_back(
+            NAMED_ALLOW_CALL(*this, IsKnownArticle(ANY(std::string), ANY(uint64_t))).RETURN(false));
         // Default: rated articles list is empty unless overridden
         m_expectations.push_back(NAMED_ALLOW_CALL(*this, GetRatedArticles())
                                      .RETURN(Arxiv::DatabaseManager::RatedArticleList{}));
@@ -102,7 +105,8 @@ class DatabaseManagerMock : public Arxiv::DatabaseManager {
     MAKE_MOCK1(DeleteArticle, void(const std::string&), override);
     MAKE_MOCK1(MarkArticleRead, void(const std::string&), override);
     MAKE_MOCK0(GetUnreadArticles, std::vector<Arxiv::Article>(), override);
-    MAKE_MOCK1(PruneArticles, void(int), override);
+    MAKE_MOCK2(IsKnownArticle, bool(const std::string&, uint64_t), override);
+    MAKE_MOCK1(PruneArticles, std::vector<std::string>(int), override);
     MAKE_MOCK1(AddProject, void(const std::string&), override);
     MAKE_MOCK1(RemoveProject, void(const std::string&), override);
     MAKE_MOCK0(GetProjects, std::vector<std::string>(), override);
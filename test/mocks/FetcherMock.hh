@@ -22,6 +22,11 @@ class FetcherMock : public Arxiv::Fetcher {
             NAMED_ALLOW_CALL(*this, Fetch()).RETURN(std::vector<Arxiv::Article>{}));
         m_expectations.push_back(NAMED_ALLOW_CALL(*this, FetchSince(ANY(std::string)))
                                      .RETURN(std::vector<Arxiv::Article>{}));
+        // Default: batch lookups resolve each id through FetchBibTeX, so the
+        // per-id responses set via setBibTeXResponse apply to both paths.
+        m_expectations.push_back(
+            NAMED_ALLOW_CALL(*this, FetchBibTeXBatch(ANY(std::vector<std::string>)))
+                .RETURN(resolveEach(_1)));
     }
 
     // Mock methods using trompeloeil
@@ -31,6 +36,7 @@ class FetcherMock : public Arxiv::Fetcher {
     MAKE_MOCK2(DownloadPaper, bool(const std::string&, const std::string&), override);
     MAKE_MOCK1(GetPaperAbstract, std::string(const std::string&), override);
     MAKE_MOCK1(FetchBibTeX, std::string(const std::string&), override);
+    MAKE_MOCK1(FetchBibTeXBatch, BibTeXMap(const std::vector<std::string>&), override);
 
     // Helper methods for testing
     void setFetchResponse(const std::vector<Arxiv::Article>& articles) {
@@ -64,6 +70,16 @@ class FetcherMock : public Arxiv::Fetcher {
 
   private:
     std::vector<std::unique_ptr<trompeloeil::expectation>> m_expectations;
+
+    BibTeXMap resolveEach(const std::vector<std::string>& paper_ids) {
+        BibTeXMap resolved;
+        for (const auto& id : paper_ids) {
+            auto bib = FetchBibTeX(id);
+            if (!bib.empty())
+                resolved[id] = bib;
+        }
+        return resolved;
+    }
 };
 
 } // namespace test
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/AhoCorasick.hh"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Arxiv::AhoCorasick;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// (end offset, pattern id) of every match, in the order reported.
+static std::vector<std::pair<size_t, size_t>> matches(const AhoCorasick& matcher,
+                                                      const std::string& text) {
+    std::vector<std::pair<size_t, size_t>> found;
+    matcher.ForEachMatch(text, [&](size_t id, size_t end) { found.emplace_back(end, id); });
+    return found;
+}
+
+static std::string lower(std::string s) {
+    for (char& c : s)
+        c = c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c;
+    return s;
+}
+
+// The same matches found the slow way: every pattern at every end offset.
+static std::vector<std::pair<size_t, size_t>> brute_force(const std::vector<std::string>& patterns,
+                                                          const std::string& text) {
+    const std::string folded = lower(text);
+    std::vector<std::pair<size_t, size_t>> found;
+    for (size_t end = 1; end <= text.size(); ++end) {
+        std::vector<std::pair<size_t, size_t>> here; // (length, id)
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            const std::string p = lower(patterns[id]);
+            if (!p.empty() && p.size() <= end && folded.compare(end - p.size(), p.size(), p) == 0)
+                here.emplace_back(p.size(), id);
+        }
+        // Longest first, then by id: the order the failure chain visits them.
+        std::sort(here.begin(), here.end(), [](const auto& a, const auto& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        for (const auto& [length, id] : here)
+            found.emplace_back(end, id);
+    }
+    return found;
+}
+
+// ---------------------------------------------------------------------------
+// Matching
+// ---------------------------------------------------------------------------
+
+TEST_CASE("AhoCorasick finds overlapping patterns", "[aho_corasick]") {
+    const std::vector<std::string> patterns{"he", "she", "his", "hers"};
+    const AhoCorasick matcher(patterns);
+    REQUIRE(matcher.Patterns() == 4);
+
+    // u s h e r s: "she" and "he" end at 4, "hers" at 6.
+    const auto found = matches(matcher, "ushers");
+    REQUIRE(found == std::vector<std::pair<size_t, size_t>>{{4, 1}, {4, 0}, {6, 3}});
+    CHECK(matcher.Matches("ushers"));
+    CHECK_FALSE(matcher.Matches("hush, sir"));
+}
+
+TEST_CASE("AhoCorasick ignores ASCII case", "[aho_corasick]") {
+    const AhoCorasick matcher({"Neural Network", "qcd"});
+    CHECK(matcher.Matches("deep NEURAL network training"));
+    CHECK(matcher.Matches("Lattice QCD"));
+    CHECK_FALSE(matcher.Matches("neural-network"));
+
+    // Only ASCII letters fold.
+    const AhoCorasick accented({"é"});
+    CHECK(accented.Matches("caf\xc3\xa9"));
+    CHECK_FALSE(accented.Matches("CAF\xc3\x89"));
+}
+
+TEST_CASE("AhoCorasick reports duplicate and nested patterns separately", "[aho_corasick]") {
+    const AhoCorasick matcher({"ab", "AB", "b", "", "abab"});
+    std::vector<size_t> ids;
+    matcher.ForEachMatch("abab", [&](size_t id, size_t) { ids.push_back(id); });
+    // "ab" and "AB" at 2 and 4, "b" at 2 and 4, "abab" at 4; never "".
+    CHECK(ids == std::vector<size_t>{0, 1, 2, 4, 0, 1, 2});
+
+    std::vector<uint8_t> seen;
+    CHECK(matcher.CountDistinct("abab", seen) == 4);
+    CHECK(matcher.CountDistinct("xbx", seen) == 1);
+    CHECK(matcher.CountDistinct("", seen) == 0);
+}
+
+TEST_CASE("AhoCorasick without patterns matches nothing", "[aho_corasick]") {
+    std::vector<uint8_t> seen;
+    const AhoCorasick none;
+    CHECK_FALSE(none.Matches("anything"));
+    CHECK(none.CountDistinct("anything", seen) == 0);
+
+    const AhoCorasick empty({"", ""});
+    CHECK(empty.Patterns() == 2);
+    CHECK_FALSE(empty.Matches("anything"));
+    CHECK(empty.CountDistinct("anything", seen) == 0);
+}
+
+TEST_CASE("AhoCorasick agrees with a brute-force search", "[aho_corasick]") {
+    // A small alphabet makes overlaps and shared prefixes common.
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> letter(0, 5);
+    std::uniform_int_distribution<int> length(0, 5);
+    auto word = [&](int n) {
+        std::string s;
+        for (int i = 0; i < n; ++i)
+            s += "abAB c"[letter(rng)];
+        return s;
+    };
+
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::string> patterns;
+        for (int i = 0; i < 20; ++i)
+            patterns.push_back(word(length(rng)));
+        const std::string text = word(60);
+        const AhoCorasick matcher(patterns);
+        REQUIRE(matches(matcher, text) == brute_force(patterns, text));
+
+        std::vector<uint8_t> seen;
+        size_t distinct = 0;
+        for (const auto& p : patterns)
+            distinct += !p.empty() && lower(text).find(lower(p)) != std::string::npos;
+        REQUIRE(matcher.CountDistinct(text, seen) == distinct);
+        REQUIRE(matcher.Matches(text) == (distinct > 0));
+    }
+}
@@ -4,14 +4,18 @@
 
 #include <Arxiv/AppCore.hh>
 #include <Arxiv/Config.hh>
+#include <Arxiv/RelatedIndex.hh>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <chrono>
 #include <cstdio>
 #include <fixtures/test_data.hh>
 #include <fstream>
 #include <mocks/DatabaseManagerMock.hh>
 #include <mocks/FetcherMock.hh>
+#include <thread>
 #include <unistd.h>
 
 using namespace Arxiv;
@@ -315,6 +319,272 @@ TEST_CASE("AppCore rating and recommendation", "[app][ranking]") {
     }
 }
 
+TEST_CASE("AppCore score column", "[app][ranking]") {
+    Config config("test/fixtures/test_config.yml");
+    config.set_ranker_file("/tmp/arxiv_tui_apptest_scores_" + std::to_string(::getpid()) + ".bin");
+    std::remove(config.get_ranker_file().c_str());
+
+    // Today's articles with opposite vocabularies and ratings, so the ranker
+    // trains on construction and the scores differ.
+    auto db = std::make_unique<DatabaseManager>(":memory:");
+    for (int i = 0; i < 6; ++i) {
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/score." + std::to_string(i);
+        a.title = (i % 2 ? "Quantum field theory " : "Cooking recipes ") + std::to_string(i);
+        a.category = i % 3 ? "cs.AI" : "cs.LG";
+        a.date = std::chrono::system_clock::now();
+        db->AddArticle(a);
+        db->SetRating(a.link, i % 2 ? 5 : 1);
+    }
+    Arxiv::AppCore core(config, std::move(db), std::make_unique<FetcherMock>());
+    REQUIRE(core.IsRankerTrained());
+
+    SECTION("Ranked views carry one score per article, best first") {
+        core.SetRecommendThreshold(1.0f);
+        core.SetFilterIndex(AppCore::FilterView::Recommended);
+        const auto& articles = core.GetCurrentArticles();
+        const auto& scores = core.GetCurrentScores();
+        REQUIRE(articles.size() == 6);
+        REQUIRE(scores.size() == articles.size());
+        for (size_t i = 0; i < articles.size(); ++i) {
+            REQUIRE(scores[i] == core.GetPredictedScore(articles[i]));
+            if (i > 0)
+                REQUIRE(scores[i - 1] >= scores[i]);
+        }
+    }
+
+    SECTION("Category filtering keeps the column aligned") {
+        core.SetRecommendThreshold(1.0f);
+        core.SetFilterIndex(AppCore::FilterView::Recommended);
+        core.SetActiveCategories({"cs.AI"});
+        const auto& articles = core.GetCurrentArticles();
+        const auto& scores = core.GetCurrentScores();
+        REQUIRE(articles.size() == 4);
+        REQUIRE(scores.size() == articles.size());
+        for (size_t i = 0; i < articles.size(); ++i)
+            REQUIRE(scores[i] == core.GetPredictedScore(articles[i]));
+    }
+
+    SECTION("Other views are unscored") {
+        core.SetFilterIndex(AppCore::FilterView::All);
+        REQUIRE(core.GetCurrentArticles().size() == 6);
+        REQUIRE(core.GetCurrentScores().empty());
+    }
+
+    std::remove(config.get_ranker_file().c_str());
+}
+
+TEST_CASE("AppCore online updates", "[app][ranking]") {
+    Config config("test/fixtures/test_config.yml");
+    config.set_retrain_interval(100);
+    config.set_ranker_file("/tmp/arxiv_tui_apptest_online_" + std::to_string(::getpid()) + ".bin");
+    std::remove(config.get_ranker_file().c_str());
+
+    auto db = std::make_unique<DatabaseManager>(":memory:");
+    for (int i = 0; i < 6; ++i) {
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/online." + std::to_string(i);
+        a.title = (i % 2 ? "Quantum field theory " : "Cooking recipes ") + std::to_string(i);
+        a.date = std::chrono::system_clock::now();
+        db->AddArticle(a);
+        db->SetRating(a.link, i % 2 ? 5 : 1);
+    }
+    Arxiv::AppCore core(config, std::move(db), std::make_unique<FetcherMock>());
+    REQUIRE(core.IsRankerTrained());
+    core.SetRecommendThreshold(1.0f);
+    core.SetFilterIndex(AppCore::FilterView::Recommended);
+
+    SECTION("A rating moves the model without waiting for a retrain") {
+        const Article cooking = core.GetCurrentArticles().back();
+        const float before = core.GetPredictedScore(cooking);
+
+        core.RateArticle(cooking.link, 5);
+        core.WaitForOnlineUpdates();
+        REQUIRE_FALSE(core.IsTraining());
+        REQUIRE(core.PendingRatings() == 1);
+        REQUIRE(core.GetPredictedScore(cooking) > before);
+
+        // The view picks the new scores up on its next refetch.
+        core.TryRefetchIfNeeded();
+        const auto& articles = core.GetCurrentArticles();
+        const auto& scores = core.GetCurrentScores();
+        REQUIRE(scores.size() == articles.size());
+        for (size_t i = 0; i < articles.size(); ++i)
+            REQUIRE(scores[i] == core.GetPredictedScore(articles[i]));
+    }
+
+    SECTION("Readers keep scoring while updates are published") {
+        const auto articles = core.GetCurrentArticles();
+        std::atomic<bool> done{false};
+        bool in_range = true;
+        std::thread reader([&] {
+            while (!done.load()) {
+                for (float score : core.GetPredictedScores(articles))
+                    in_range = in_range && score >= 1.0f && score <= 5.0f;
+            }
+        });
+        for (int i = 0; i < 20; ++i)
+            core.RateArticle(articles[static_cast<size_t>(i) % articles.size()].link, 5);
+        core.WaitForOnlineUpdates();
+        done = true;
+        reader.join();
+        REQUIRE(in_range);
+    }
+
+    SECTION("A stored article outside the view is read from the database") {
+        const Article cooking = core.GetCurrentArticles().back();
+        const float before = core.GetPredictedScore(cooking);
+
+        core.SetFilterIndex(AppCore::FilterView::Bookmarks);
+        REQUIRE(core.GetCurrentArticles().empty());
+        core.RateArticle(cooking.link, 5);
+        core.WaitForOnlineUpdates();
+        REQUIRE(core.GetPredictedScore(cooking) > before);
+    }
+
+    SECTION("Rating an unknown link leaves the model alone") {
+        const Article first = core.GetCurrentArticles().front();
+        const float before = core.GetPredictedScore(first);
+        core.RateArticle("https://arxiv.org/abs/not.shown", 5);
+        core.WaitForOnlineUpdates();
+        REQUIRE(core.GetPredictedScore(first) == before);
+    }
+
+    std::remove(config.get_ranker_file().c_str());
+}
+
+TEST_CASE("AppCore related papers", "[app][related]") {
+    Config config("test/fixtures/test_config.yml");
+    config.set_ranker_file("/tmp/arxiv_tui_apptest_related_" + std::to_string(::getpid()) + ".bin");
+    const std::string index_path =
+        "/tmp/arxiv_tui_apptest_related_" + std::to_string(::getpid()) + ".related.bin";
+    std::remove(config.get_ranker_file().c_str());
+    std::remove(index_path.c_str());
+
+    // Unrated articles on two topics: the index is built from the fitted
+    // vocabulary alone.
+    auto db = std::make_unique<DatabaseManager>(":memory:");
+    for (int i = 0; i < 6; ++i) {
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/related." + std::to_string(i);
+        a.title = (i % 2 ? "Quantum field theory " : "Cooking recipes ") + std::to_string(i);
+        a.date = std::chrono::system_clock::now();
+        db->AddArticle(a);
+    }
+    Arxiv::AppCore core(config, std::move(db), std::make_unique<FetcherMock>());
+    REQUIRE_FALSE(core.IsRankerTrained());
+    // Built before a Sync constructor returns; the untrained model is refitted
+    // next launch rather than saved.
+    REQUIRE_FALSE(core.IsRelatedBuilding());
+    REQUIRE_FALSE(std::ifstream(config.get_ranker_file()).good());
+
+    SECTION("Nearest articles first, without the article itself") {
+        core.ShowRelated("https://arxiv.org/abs/related.1");
+        REQUIRE(core.GetFilterView() == AppCore::FilterView::Related);
+        REQUIRE(core.GetRelatedLink() == "https://arxiv.org/abs/related.1");
+        const auto& articles = core.GetCurrentArticles();
+        REQUIRE(articles.size() == 5);
+        for (size_t i = 0; i < 2; ++i) {
+            REQUIRE((articles[i].link == "https://arxiv.org/abs/related.3" ||
+                     articles[i].link == "https://arxiv.org/abs/related.5"));
+        }
+        for (const auto& article : articles)
+            REQUIRE(article.link != "https://arxiv.org/abs/related.1");
+    }
+
+    SECTION("Showing another article from the view refetches") {
+        core.ShowRelated("https://arxiv.org/abs/related.1");
+        core.ShowRelated("https://arxiv.org/abs/related.0");
+        const auto& articles = core.GetCurrentArticles();
+        REQUIRE(articles.size() == 5);
+        REQUIRE((articles[0].link == "https://arxiv.org/abs/related.2" ||
+                 articles[0].link == "https://arxiv.org/abs/related.4"));
+    }
+
+    SECTION("Deleted articles leave the view") {
+        core.SetFilterIndex(AppCore::FilterView::All);
+        const std::string deleted = core.GetCurrentArticles()[0].link;
+        core.DeleteCurrentOrSelected();
+        const std::string shown = deleted == "https://arxiv.org/abs/related.0"
+                                      ? "https://arxiv.org/abs/related.1"
+                                      : "https://arxiv.org/abs/related.0";
+        core.ShowRelated(shown);
+        REQUIRE(core.GetCurrentArticles().size() == 4);
+        for (const auto& article : core.GetCurrentArticles())
+            REQUIRE(article.link != deleted);
+    }
+
+    SECTION("Articles outside the index have no neighbours") {
+        core.ShowRelated("https://arxiv.org/abs/not.stored");
+        REQUIRE(core.GetCurrentArticles().empty());
+    }
+
+    SECTION("Deleted articles leave the saved index") {
+        core.SetFilterIndex(AppCore::FilterView::All);
+        const std::string deleted = core.GetCurrentArticles()[0].link;
+        core.DeleteCurrentOrSelected();
+        RelatedIndex saved;
+        REQUIRE(saved.Load(index_path));
+        REQUIRE(saved.Size() == 5);
+        REQUIRE_FALSE(saved.Contains(deleted));
+    }
+
+    std::remove(config.get_ranker_file().c_str());
+    std::remove(index_path.c_str());
+}
+
+TEST_CASE("AppCore prunes the related index", "[app][related][prune]") {
+    const std::string base = "/tmp/arxiv_tui_apptest_prune_" + std::to_string(::getpid());
+    Config config("test/fixtures/test_config.yml");
+    config.set_ranker_file(base + ".bin");
+    const std::string index_path = base + ".related.bin";
+    const std::string db_path = base + ".db";
+    std::remove(config.get_ranker_file().c_str());
+    std::remove(index_path.c_str());
+    std::remove(db_path.c_str());
+
+    // Rated articles are never pruned and train a model, so the second run
+    // loads the model and index rather than rebuilding them.
+    const std::string old_link = "https://arxiv.org/abs/prune.old";
+    {
+        auto db = std::make_unique<DatabaseManager>(db_path);
+        for (int i = 0; i < 6; ++i) {
+            Article a = sample_articles[0];
+            a.link = "https://arxiv.org/abs/prune." + std::to_string(i);
+            a.title = (i % 2 ? "Quantum field theory " : "Cooking recipes ") + std::to_string(i);
+            a.date = std::chrono::system_clock::now();
+            db->AddArticle(a);
+            db->SetRating(a.link, i % 2 ? 5 : 1);
+        }
+        Article old = sample_articles[0];
+        old.link = old_link;
+        old.title = "Quantum field theory of old";
+        old.date = std::chrono::system_clock::now() - std::chrono::hours(24 * 100);
+        db->AddArticle(old);
+        Arxiv::AppCore core(config, std::move(db), std::make_unique<FetcherMock>());
+        REQUIRE(core.IsRankerTrained());
+    }
+    RelatedIndex saved;
+    REQUIRE(saved.Load(index_path));
+    REQUIRE(saved.Contains(old_link));
+
+    config.set_max_article_age_days(30);
+    {
+        Arxiv::AppCore core(config,
+                            std::make_unique<DatabaseManager>(db_path),
+                            std::make_unique<FetcherMock>());
+        core.ShowRelated("https://arxiv.org/abs/prune.1");
+        REQUIRE(core.GetCurrentArticles().size() == 5);
+    }
+    REQUIRE(saved.Load(index_path));
+    REQUIRE(saved.Size() == 6);
+    REQUIRE_FALSE(saved.Contains(old_link));
+
+    std::remove(config.get_ranker_file().c_str());
+    std::remove(index_path.c_str());
+    std::remove(db_path.c_str());
+}
+
 TEST_CASE("AppCore sub-project hierarchy", "[app][projects]") {
     Config config("test/fixtures/test_config.yml");
     auto db = std::make_unique<DatabaseManagerMock>();
@@ -1096,7 +1366,9 @@ TEST_CASE("AppCore startup pruning", "[app][prune]") {
         ALLOW_CALL(*db_ptr, GetProjects()).RETURN(std::vector<std::string>{});
 
         int pruned_days = -1;
-        ALLOW_CALL(*db_ptr, PruneArticles(ANY(int))).LR_SIDE_EFFECT(pruned_days = _1);
+        ALLOW_CALL(*db_ptr, PruneArticles(ANY(int)))
+            .LR_SIDE_EFFECT(pruned_days = _1)
+            .RETURN(std::vector<std::string>{});
 
         Config cfg("test/fixtures/test_config.yml");
         cfg.set_max_article_age_days(45);
@@ -1114,7 +1386,9 @@ TEST_CASE("AppCore startup pruning", "[app][prune]") {
         ALLOW_CALL(*db_ptr, GetProjects()).RETURN(std::vector<std::string>{});
 
         bool called = false;
-        ALLOW_CALL(*db_ptr, PruneArticles(ANY(int))).LR_SIDE_EFFECT(called = true);
+        ALLOW_CALL(*db_ptr, PruneArticles(ANY(int)))
+            .LR_SIDE_EFFECT(called = true)
+            .RETURN(std::vector<std::string>{});
 
         AppCore core(config, std::move(db), std::move(fetcher));
         REQUIRE_FALSE(called);
@@ -134,6 +134,36 @@ TEST_CASE("AppCore::GetArticlesForFollowedAuthors returns articles matching any
     }
 }
 
+TEST_CASE("AppCore::GetArticlesForFollowedAuthors follows changes to the list",
+          "[author][appcore]") {
+    DatabaseManagerMock* db = nullptr;
+    FetcherMock* fetcher = nullptr;
+    auto core = make_core(db, fetcher);
+
+    // sample_articles[0].authors = "John Doe, Jane Smith"
+    std::vector<std::string> followed{"nobody at all"};
+    ALLOW_CALL(*db, GetFollowedAuthors()).LR_RETURN(followed);
+    ALLOW_CALL(*db, GetRecent(ANY(int))).RETURN(arxiv_tui::test::fixtures::sample_articles);
+    REQUIRE(core->GetArticlesForFollowedAuthors().empty());
+
+    SECTION("A newly followed author is matched, ignoring case") {
+        followed.push_back("JANE SMITH");
+        auto results = core->GetArticlesForFollowedAuthors();
+        REQUIRE(!results.empty());
+        for (const auto& a : results)
+            REQUIRE_THAT(a.authors, ContainsSubstring("Jane Smith"));
+    }
+
+    SECTION("An unfollowed author is no longer matched") {
+        followed = {"Jane Smith"};
+        REQUIRE(!core->GetArticlesForFollowedAuthors().empty());
+        followed.clear();
+        REQUIRE(core->GetArticlesForFollowedAuthors().empty());
+        followed = {"nobody at all"};
+        REQUIRE(core->GetArticlesForFollowedAuthors().empty());
+    }
+}
+
 TEST_CASE("AppCore::GetArticlesForFollowedAuthors returns empty when no followed authors",
           "[author][appcore]") {
     DatabaseManagerMock* db = nullptr;
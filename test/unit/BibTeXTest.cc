@@ -187,6 +187,41 @@ TEST_CASE("AppCore::ExportArticlesBibTeX — multiple articles", "[bibtex][appco
     fs::remove(tmp);
 }
 
+TEST_CASE("AppCore::ExportArticlesBibTeX — batched InspireHEP lookup", "[bibtex][appcore]") {
+    DatabaseManagerMock* db_ptr = nullptr;
+    FetcherMock* fetcher_ptr = nullptr;
+    auto core = make_core(db_ptr, fetcher_ptr);
+
+    fs::path tmp = fs::temp_directory_path() / "bibtex_batch_test.bib";
+    fs::remove(tmp);
+
+    auto articles = arxiv_tui::test::fixtures::sample_articles;
+    const std::string inspire_bib = "@article{Doe:2024abc,\n    eprint = \"2403.12345\"\n}\n";
+
+    SECTION("resolves all ids in one batch and falls back only for misses") {
+        Arxiv::Fetcher::BibTeXMap hits{{"2403.12345", inspire_bib}};
+        REQUIRE_CALL(*fetcher_ptr,
+                     FetchBibTeXBatch(std::vector<std::string>{"2403.12345", "2403.12346"}))
+            .RETURN(hits);
+        FORBID_CALL(*fetcher_ptr, FetchBibTeX(trompeloeil::_));
+
+        REQUIRE(core->ExportArticlesBibTeX(articles, tmp.string()));
+
+        std::string content = read_file(tmp);
+        REQUIRE_THAT(content, ContainsSubstring("Doe:2024abc"));
+        // The miss is constructed from article metadata.
+        REQUIRE_THAT(content, ContainsSubstring("2403.12346"));
+        REQUIRE_THAT(content, ContainsSubstring("Another Test Article"));
+    }
+
+    SECTION("does not query InspireHEP when the output path is unwritable") {
+        FORBID_CALL(*fetcher_ptr, FetchBibTeXBatch(trompeloeil::_));
+        REQUIRE_FALSE(core->ExportArticlesBibTeX(articles, "/no_such_dir/out.bib"));
+    }
+
+    fs::remove(tmp);
+}
+
 // ---------------------------------------------------------------------------
 // AppCore::ExportProjectBibTeX — project
 // ---------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/BloomFilter.hh"
+#include "Arxiv/Hash.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+
+using namespace Arxiv;
+
+static uint64_t key(uint64_t i) {
+    return Hash::Fnv1a("https://arxiv.org/abs/" + std::to_string(i));
+}
+
+TEST_CASE("BloomFilter", "[bloom]") {
+    SECTION("Empty filter contains nothing") {
+        BloomFilter filter(1000);
+        REQUIRE(filter.Size() == 0);
+        REQUIRE_FALSE(filter.MightContain(key(1)));
+    }
+
+    SECTION("No false negatives") {
+        BloomFilter filter(10000);
+        for (uint64_t i = 0; i < 10000; ++i)
+            filter.Add(key(i));
+        REQUIRE(filter.Size() == 10000);
+        for (uint64_t i = 0; i < 10000; ++i)
+            REQUIRE(filter.MightContain(key(i)));
+    }
+
+    SECTION("False-positive rate stays near the target at capacity") {
+        BloomFilter filter(10000, 0.01);
+        for (uint64_t i = 0; i < 10000; ++i)
+            filter.Add(key(i));
+        size_t false_positives = 0;
+        for (uint64_t i = 10000; i < 110000; ++i)
+            if (filter.MightContain(key(i)))
+                ++false_positives;
+        // 1% target over 100k probes; allow generous slack for hash variance.
+        REQUIRE(false_positives < 2000);
+    }
+
+    SECTION("Capacity has a floor") {
+        REQUIRE(BloomFilter(0).Capacity() >= 64);
+    }
+}
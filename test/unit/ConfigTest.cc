@@ -11,6 +11,7 @@
 #include <fstream>
 #include <string>
 #include <unistd.h>
+#include <vector>
 
 using Arxiv::Config;
 
@@ -68,6 +69,20 @@ TEST_CASE("Config: auto_refresh_minutes defaults to 0 when absent from file", "[
     REQUIRE(loaded.get_auto_refresh_minutes() == 0);
 }
 
+TEST_CASE("Config: announcement_holidays round-trips through save/load", "[config]") {
+    TempConfig tmp;
+
+    Config cfg;
+    cfg.set_topics({"cs.AI"});
+    cfg.set_download_dir("/tmp");
+    cfg.set_announcement_holidays({"2026-12-24", "2026-12-31"});
+    cfg.save_to_file(tmp.path);
+
+    Config loaded(tmp.path);
+    REQUIRE(loaded.get_announcement_holidays() ==
+            std::vector<std::string>{"2026-12-24", "2026-12-31"});
+}
+
 // ---------------------------------------------------------------------------
 // Config round-trip: recommend_threshold and retrain_interval
 // ---------------------------------------------------------------------------
@@ -98,6 +113,48 @@ TEST_CASE("Config: retrain_interval round-trips through save/load", "[config]")
     REQUIRE(loaded.get_retrain_interval() == 10);
 }
 
+TEST_CASE("Config: ranker_hash_bits round-trips through save/load", "[config]") {
+    TempConfig tmp;
+
+    Config cfg;
+    cfg.set_topics({"hep-ph"});
+    cfg.set_download_dir("/tmp");
+    REQUIRE(cfg.get_ranker_hash_bits() == 0);
+    cfg.set_ranker_hash_bits(14);
+    cfg.save_to_file(tmp.path);
+
+    Config loaded(tmp.path);
+    REQUIRE(loaded.get_ranker_hash_bits() == 14);
+}
+
+TEST_CASE("Config: ranker_quantise round-trips through save/load", "[config]") {
+    TempConfig tmp;
+
+    Config cfg;
+    cfg.set_topics({"hep-ph"});
+    cfg.set_download_dir("/tmp");
+    REQUIRE_FALSE(cfg.get_ranker_quantise());
+    cfg.set_ranker_quantise(true);
+    cfg.save_to_file(tmp.path);
+
+    Config loaded(tmp.path);
+    REQUIRE(loaded.get_ranker_quantise());
+}
+
+TEST_CASE("Config: ranker_search round-trips through save/load", "[config]") {
+    TempConfig tmp;
+
+    Config cfg;
+    cfg.set_topics({"hep-ph"});
+    cfg.set_download_dir("/tmp");
+    REQUIRE_FALSE(cfg.get_ranker_search());
+    cfg.set_ranker_search(true);
+    cfg.save_to_file(tmp.path);
+
+    Config loaded(tmp.path);
+    REQUIRE(loaded.get_ranker_search());
+}
+
 // ---------------------------------------------------------------------------
 // Config round-trip: obsidian_vault
 // ---------------------------------------------------------------------------
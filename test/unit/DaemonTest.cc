@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/AppCore.hh"
+#include "Arxiv/Config.hh"
+#include "Arxiv/Daemon.hh"
+#include "Arxiv/DatabaseManager.hh"
+#include "Arxiv/Fetcher.hh"
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/TermCache.hh"
+#include "Arxiv/Transport.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fixtures/test_data.hh>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Arxiv;
+using namespace arxiv_tui::test::fixtures;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr auto FEED_URL = "http://rss.arxiv.org/rss/cs.AI";
+
+// An AppCore over an in-memory DB and a FixtureTransport rooted at a fresh
+// temp dir. The feed starts unrecorded (404), so nothing is stored until a
+// test calls record_feed(). Given `stored` articles, the DB is a file
+// holding them (and their term lists) that attach() can share, the ranker
+// hashes features so every core has the same vectoriser, and it retrains
+// as soon as there are enough ratings to.
+struct DaemonFixture {
+    fs::path root;
+    Config cfg;
+    std::unique_ptr<AppCore> core;
+
+    explicit DaemonFixture(const std::vector<Article>& stored = {}) {
+        root = fs::temp_directory_path() / ("arxiv_daemon_" + std::to_string(::getpid()));
+        fs::remove_all(root);
+        fs::create_directories(root);
+        cfg.set_topics({"cs.AI"});
+        cfg.set_download_dir((root / "downloads").string());
+        cfg.set_ranker_file((root / "ranker.bin").string());
+        std::string db_path = ":memory:";
+        if (!stored.empty()) {
+            db_path = (root / "articles.db").string();
+            cfg.set_db_file(db_path);
+            cfg.set_ranker_hash_bits(Ranker::MIN_HASH_BITS);
+            cfg.set_retrain_interval(Ranker::MIN_TRAIN);
+            DatabaseManager db(db_path);
+            db.AddArticles(stored);
+            TermCache(&db, true).Add(stored);
+        }
+        core = std::make_unique<AppCore>(
+            cfg,
+            std::make_unique<DatabaseManager>(db_path),
+            std::make_unique<Fetcher>(cfg.get_topics(),
+                                      cfg.get_download_dir(),
+                                      std::make_unique<FixtureTransport>(root)));
+        core->SetFilterIndex(AppCore::FilterView::All);
+    }
+    ~DaemonFixture() { fs::remove_all(root); }
+
+    void record_feed() {
+        auto path = root / FixtureTransport::KeyFor(FEED_URL);
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << sample_rss_response;
+    }
+
+    std::string socket_path() const { return (root / "daemon.sock").string(); }
+
+    // A second core on the same files that fetches through the daemon, as
+    // the TUI starts while one is running.
+    std::unique_ptr<AppCore> attach() const {
+        auto tui = std::make_unique<AppCore>(
+            cfg,
+            std::make_unique<DatabaseManager>(cfg.get_db_file()),
+            std::make_unique<DaemonFetcher>(
+                socket_path(), cfg.get_topics(), cfg.get_download_dir()));
+        tui->SetFilterIndex(AppCore::FilterView::All);
+        return tui;
+    }
+};
+
+// Runs a Daemon on a background thread for the lifetime of the object.
+struct RunningDaemon {
+    Daemon daemon;
+    std::thread thread;
+
+    RunningDaemon(AppCore& core, const std::string& path)
+        : daemon(core, path)
+        , thread([this] { daemon.Run(); }) {}
+    ~RunningDaemon() {
+        daemon.Stop();
+        thread.join();
+    }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Request dispatch
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Daemon::Handle", "[daemon]") {
+    DaemonFixture fx;
+    Daemon daemon(*fx.core, fx.socket_path());
+
+    SECTION("ping reports the serving process") {
+        auto reply = daemon.Handle({{"id", 1}, {"op", "ping"}});
+        REQUIRE(reply["id"] == 1);
+        REQUIRE(reply["ok"] == true);
+        REQUIRE(reply["result"]["pid"] == ::getpid());
+    }
+
+    SECTION("Unknown ops and bad params are error replies") {
+        auto unknown = daemon.Handle({{"id", 2}, {"op", "explode"}});
+        REQUIRE(unknown["ok"] == false);
+        auto missing = daemon.Handle({{"id", 3}, {"op", "rate"}});
+        REQUIRE(missing["ok"] == false);
+        REQUIRE(missing["id"] == 3);
+    }
+
+    SECTION("fetch stores new articles") {
+        fx.record_feed();
+        auto fetched = daemon.Handle({{"op", "fetch"}});
+        REQUIRE(fetched["result"]["added"] == 1);
+        fx.core->FetchArticles();
+        REQUIRE(fx.core->GetCurrentArticles().size() == 1);
+        REQUIRE(fx.core->GetCurrentArticles()[0].link == "https://arxiv.org/abs/2403.12345");
+
+        // Unchanged on the second pass, so nothing new is stored.
+        REQUIRE(daemon.Handle({{"op", "fetch"}})["result"]["added"] == 0);
+    }
+
+    SECTION("rate stores the rating") {
+        fx.record_feed();
+        daemon.Handle({{"op", "fetch"}});
+        const json params = {{"link", "https://arxiv.org/abs/2403.12345"}, {"rating", 4}};
+        REQUIRE(daemon.Handle({{"op", "rate"}, {"params", params}})["ok"] == true);
+        REQUIRE(fx.core->GetArticleRating("https://arxiv.org/abs/2403.12345") == 4);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Socket transport
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Daemon serves several clients over its socket", "[daemon]") {
+    DaemonFixture fx;
+    RunningDaemon running(*fx.core, fx.socket_path());
+
+    auto a = DaemonClient::Connect(fx.socket_path());
+    auto b = DaemonClient::Connect(fx.socket_path());
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(b->Call("subscribe") == true);
+
+    SECTION("A second daemon on the same socket is refused") {
+        REQUIRE_THROWS(Daemon(*fx.core, fx.socket_path()));
+    }
+
+    SECTION("fetch replies after the fetch and notifies subscribers") {
+        fx.record_feed();
+        REQUIRE(a->Call("fetch")["added"] == 1);
+        auto event = b->NextEvent(std::chrono::seconds{5});
+        REQUIRE(event);
+        REQUIRE((*event)["event"] == "new_articles");
+        REQUIRE((*event)["count"] == 1);
+    }
+
+    SECTION("Error replies surface as exceptions") {
+        REQUIRE_THROWS(a->Call("explode"));
+        REQUIRE(a->Call("ping")["pid"] == ::getpid());
+    }
+
+    SECTION("DaemonFetcher delegates to the daemon") {
+        fx.record_feed();
+        DaemonFetcher fetcher(fx.socket_path(), {"cs.AI"});
+        REQUIRE(fetcher.Fetch().empty());
+        REQUIRE(fetcher.LastFetchedCount() == 1);
+    }
+}
+
+TEST_CASE("A core attached to the daemon", "[daemon]") {
+    const char* topics[] = {"planning agents", "theorem provers", "game playing"};
+    std::vector<Article> stored;
+    for (int i = 0; i < 3; ++i) {
+        Article a;
+        a.link = "https://arxiv.org/abs/2401.0000" + std::to_string(i);
+        a.title = std::string("Learned world models for ") + topics[i];
+        a.abstract = std::string("We study ") + topics[i] + " with learned models.";
+        a.category = "cs.AI";
+        stored.push_back(a);
+    }
+    DaemonFixture fx(stored);
+    RunningDaemon running(*fx.core, fx.socket_path());
+    fx.record_feed();
+    // Its startup fetch goes through the daemon.
+    auto tui = fx.attach();
+
+    SECTION("Finds related papers among those the daemon fetched") {
+        tui->ShowRelated("https://arxiv.org/abs/2403.12345");
+        REQUIRE(tui->GetCurrentArticles().size() == stored.size());
+    }
+
+    SECTION("Ratings go to the daemon, whose model it loads") {
+        tui->RateArticle(stored[0].link, 5);
+        REQUIRE(fx.core->PendingRatings() == 1);
+        REQUIRE(tui->GetArticleRating(stored[0].link) == 5);
+        tui->RateArticle(stored[1].link, 1);
+        tui->RateArticle(stored[2].link, 5);
+        REQUIRE_FALSE(tui->IsTraining());
+
+        // Published once the daemon's retrain saves it.
+        for (int tick = 0; tick < 1000 && !tui->IsRankerTrained(); ++tick) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            tui->TryRefetchIfNeeded();
+        }
+        REQUIRE(tui->IsRankerTrained());
+        REQUIRE(tui->PendingRatings() == 0);
+    }
+}
+
+TEST_CASE("DaemonClient::Connect without a daemon", "[daemon]") {
+    REQUIRE_FALSE(DaemonClient::Connect("/nonexistent/arxiv-tui.sock"));
+}
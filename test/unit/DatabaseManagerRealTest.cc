@@ -159,7 +159,7 @@ TEST_CASE("Real DB: PruneArticles", "[database][real]") {
     db.AddArticle(sample_articles[1]); // recent
 
     SECTION("Old unprotected article is deleted") {
-        db.PruneArticles(30);
+        REQUIRE(db.PruneArticles(30) == std::vector<std::string>{old.link});
         auto articles = db.GetRecent(-1);
         REQUIRE(articles.size() == 1);
         REQUIRE(articles[0].link == sample_articles[1].link);
@@ -167,25 +167,25 @@ TEST_CASE("Real DB: PruneArticles", "[database][real]") {
 
     SECTION("Old bookmarked article is preserved") {
         db.ToggleBookmark(old.link, true);
-        db.PruneArticles(30);
+        REQUIRE(db.PruneArticles(30).empty());
         REQUIRE(db.GetRecent(-1).size() == 2);
     }
 
     SECTION("Old rated article is preserved") {
         db.SetRating(old.link, 4);
-        db.PruneArticles(30);
+        REQUIRE(db.PruneArticles(30).empty());
         REQUIRE(db.GetRecent(-1).size() == 2);
     }
 
     SECTION("Old article in a project is preserved") {
         db.AddProject("Keepers");
         db.LinkArticleToProject(old.link, "Keepers");
-        db.PruneArticles(30);
+        REQUIRE(db.PruneArticles(30).empty());
         REQUIRE(db.GetRecent(-1).size() == 2);
     }
 
     SECTION("PruneArticles(0) is a no-op") {
-        db.PruneArticles(0);
+        REQUIRE(db.PruneArticles(0).empty());
         REQUIRE(db.GetRecent(-1).size() == 2);
     }
 }
@@ -367,6 +367,57 @@ TEST_CASE("Real DB: SearchArticles", "[database][real]") {
 // ---------------------------------------------------------------------------
 // Ratings
 // ---------------------------------------------------------------------------
+TEST_CASE("Real DB: known-article lookup", "[database][real]") {
+    DatabaseManager db(":memory:");
+    Article a = sample_articles[0];
+    a.content_hash = 0x1234abcd5678ef00;
+
+    SECTION("Unknown before insert, known after") {
+        REQUIRE_FALSE(db.IsKnownArticle(a.link, a.content_hash));
+        db.AddArticle(a);
+        REQUIRE(db.IsKnownArticle(a.link, a.content_hash));
+    }
+
+    SECTION("Content hash round-trips through the articles table") {
+        db.AddArticle(a);
+        auto articles = db.GetRecent(-1);
+        REQUIRE(articles.size() == 1);
+        REQUIRE(articles[0].content_hash == a.content_hash);
+    }
+
+    SECTION("A changed hash or another link is not known") {
+        db.AddArticle(a);
+        REQUIRE_FALSE(db.IsKnownArticle(a.link, a.content_hash + 1));
+        REQUIRE_FALSE(db.IsKnownArticle(sample_articles[1].link, a.content_hash));
+    }
+
+    SECTION("Hash 0 (pre-migration rows) is never known") {
+        a.content_hash = 0;
+        db.AddArticle(a);
+        REQUIRE_FALSE(db.IsKnownArticle(a.link, 0));
+    }
+
+    SECTION("Deleted articles are no longer known") {
+        db.AddArticle(a);
+        db.DeleteArticle(a.link);
+        REQUIRE_FALSE(db.IsKnownArticle(a.link, a.content_hash));
+    }
+
+    SECTION("Stays exact past the filter's initial capacity") {
+        std::vector<Article> batch;
+        for (uint64_t i = 1; i <= 5000; ++i) {
+            Article b = a;
+            b.link = "https://arxiv.org/abs/bulk." + std::to_string(i);
+            b.content_hash = i;
+            batch.push_back(b);
+        }
+        db.AddArticles(batch);
+        for (uint64_t i = 1; i <= 5000; ++i)
+            REQUIRE(db.IsKnownArticle("https://arxiv.org/abs/bulk." + std::to_string(i), i));
+        REQUIRE_FALSE(db.IsKnownArticle("https://arxiv.org/abs/bulk.1", 2));
+    }
+}
+
 TEST_CASE("Real DB: ratings", "[database][real]") {
     DatabaseManager db(":memory:");
     db.AddArticle(sample_articles[0]);
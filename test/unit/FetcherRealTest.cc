@@ -3,11 +3,17 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <Arxiv/Fetcher.hh>
+#include <Arxiv/Transport.hh>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <cstdint>
 #include <filesystem>
 #include <fixtures/test_data.hh>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace Arxiv;
 using namespace Catch::Matchers;
@@ -111,6 +117,22 @@ TEST_CASE("Fetcher::ParseFeed (RSS)", "[fetcher][real][rss]") {
         REQUIRE(articles.empty());
     }
 
+    SECTION("Known-item filter drops stored items and sees the raw content hash") {
+        const auto first = fetcher.ParseFeed(sample_rss_response);
+        REQUIRE(first.size() == 1);
+        REQUIRE(first[0].content_hash != 0);
+
+        std::vector<std::pair<std::string, uint64_t>> seen;
+        fetcher.SetKnownItemFilter([&](const std::string& link, uint64_t hash) {
+            seen.emplace_back(link, hash);
+            return hash == first[0].content_hash;
+        });
+        REQUIRE(fetcher.ParseFeed(sample_rss_response).empty());
+        REQUIRE(seen.size() == 1);
+        REQUIRE(seen[0].first == "https://arxiv.org/abs/2403.12345");
+        REQUIRE(seen[0].second == first[0].content_hash);
+    }
+
     std::filesystem::remove_all(tmp);
 }
 
@@ -152,9 +174,46 @@ TEST_CASE("Fetcher::ParseAtomFeed", "[fetcher][real][atom]") {
         REQUIRE(fetcher.ParseAtomFeed(R"(<?xml version="1.0"?><root/>)").empty());
     }
 
+    SECTION("Known-item filter drops stored entries but still counts them") {
+        const auto all = fetcher.ParseAtomFeed(ATOM_FEED);
+        REQUIRE(all.size() == 2);
+        fetcher.SetKnownItemFilter([&](const std::string& link, uint64_t hash) {
+            return link == all[0].link && hash == all[0].content_hash;
+        });
+        size_t entries = 0;
+        auto fresh = fetcher.ParseAtomFeed(ATOM_FEED, &entries);
+        REQUIRE(entries == 2);
+        REQUIRE(fresh.size() == 1);
+        REQUIRE(fresh[0].link == all[1].link);
+    }
+
     std::filesystem::remove_all(tmp);
 }
 
+// ---------------------------------------------------------------------------
+// ContentHash
+// ---------------------------------------------------------------------------
+TEST_CASE("Fetcher::ContentHash", "[fetcher][real]") {
+    const auto base = Fetcher::ContentHash("Title", "Abstract", "A. Author", "v1");
+
+    SECTION("Is stable and never zero") {
+        REQUIRE(base != 0);
+        REQUIRE(Fetcher::ContentHash("Title", "Abstract", "A. Author", "v1") == base);
+        REQUIRE(Fetcher::ContentHash("", "", "") != 0);
+    }
+
+    SECTION("Changes with every field") {
+        REQUIRE(Fetcher::ContentHash("Title!", "Abstract", "A. Author", "v1") != base);
+        REQUIRE(Fetcher::ContentHash("Title", "Abstract.", "A. Author", "v1") != base);
+        REQUIRE(Fetcher::ContentHash("Title", "Abstract", "B. Author", "v1") != base);
+        REQUIRE(Fetcher::ContentHash("Title", "Abstract", "A. Author", "v2") != base);
+    }
+
+    SECTION("Field boundaries are significant") {
+        REQUIRE(Fetcher::ContentHash("ab", "c", "") != Fetcher::ContentHash("a", "bc", ""));
+    }
+}
+
 // ---------------------------------------------------------------------------
 // ParseDate (RSS pubDate)
 // ---------------------------------------------------------------------------
@@ -173,6 +232,29 @@ TEST_CASE("Fetcher::ParseDate", "[fetcher][real]") {
     SECTION("Returns nullopt for obviously invalid input") {
         REQUIRE_FALSE(fetcher.ParseDate("not-a-date").has_value());
     }
+
+    SECTION("Parses RFC-822 pubDate and applies the zone offset") {
+        auto rss = fetcher.ParseDate("Mon, 25 Mar 2024 08:00:00 -0400");
+        auto iso = fetcher.ParseDate("2024-03-25T12:00:00Z");
+        REQUIRE(rss.has_value());
+        REQUIRE(rss == iso);
+    }
+
+    SECTION("Accepts RFC-822 without weekday or seconds, with named zone") {
+        REQUIRE(fetcher.ParseDate("25 Mar 2024 07:00 EST") ==
+                fetcher.ParseDate("2024-03-25T12:00:00Z"));
+    }
+
+    SECTION("ISO-8601 offsets and fractional seconds") {
+        REQUIRE(fetcher.ParseDate("2024-03-25T13:30:00.250+01:30") ==
+                fetcher.ParseDate("2024-03-25T12:00:00Z"));
+    }
+
+    SECTION("Rejects out-of-range fields and trailing garbage") {
+        REQUIRE_FALSE(fetcher.ParseDate("2024-02-30T00:00:00Z").has_value());
+        REQUIRE_FALSE(fetcher.ParseDate("Mon, 25 Foo 2024 00:00:00 GMT").has_value());
+        REQUIRE_FALSE(fetcher.ParseDate("Mon, 25 Mar 2024 00:00:00 GMT trailing").has_value());
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -189,6 +271,11 @@ TEST_CASE("Fetcher::ParseAtomDate", "[fetcher][real]") {
     SECTION("Returns nullopt for too-short string") {
         REQUIRE_FALSE(fetcher.ParseAtomDate("2026").has_value());
     }
+
+    SECTION("Truncates to the UTC day") {
+        REQUIRE(fetcher.ParseAtomDate("2026-05-10T23:59:59-04:00") ==
+                fetcher.ParseAtomDate("2026-05-10T00:00:00Z"));
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -216,34 +303,6 @@ TEST_CASE("Fetcher::ReplaceLatexAccents", "[fetcher][real][latex]") {
     }
 }
 
-// ---------------------------------------------------------------------------
-// StyleLatex
-// ---------------------------------------------------------------------------
-TEST_CASE("Fetcher::StyleLatex", "[fetcher][real][latex]") {
-    Fetcher fetcher({"hep-ph"});
-
-    SECTION("Strips \\textit{} completely") {
-        REQUIRE(fetcher.StyleLatex("\\textit{hello}") == "hello");
-    }
-
-    SECTION("Strips \\textbf{} completely") {
-        REQUIRE(fetcher.StyleLatex("\\textbf{bold}") == "bold");
-    }
-
-    SECTION("Strips nested formatting commands") {
-        REQUIRE(fetcher.StyleLatex("\\textit{\\textbf{word}}") == "word");
-    }
-
-    SECTION("Leaves plain text unchanged") {
-        REQUIRE(fetcher.StyleLatex("plain text") == "plain text");
-    }
-
-    SECTION("Replaces $...$ math delimiters") {
-        auto result = fetcher.StyleLatex("Energy is $E=mc^2$.");
-        REQUIRE_THAT(result, ContainsSubstring("E=mc^2"));
-    }
-}
-
 // ---------------------------------------------------------------------------
 // LatexToMarkdown
 // ---------------------------------------------------------------------------
@@ -369,3 +428,133 @@ TEST_CASE("Fetcher::ConstructPaperUrl", "[fetcher][real]") {
                 "https://arxiv.org/pdf/2403.12345");
     }
 }
+
+// ---------------------------------------------------------------------------
+// InspireHEP batch BibTeX
+// ---------------------------------------------------------------------------
+TEST_CASE("Fetcher::ParseInspireBibTeX", "[fetcher][real][bibtex]") {
+    static const std::string BATCH = R"(@article{Smith:2026abc,
+    author = "Smith, Alice",
+    title = "{Quantum Corrections to Higgs Production}",
+    eprint = "2605.28788",
+    archivePrefix = "arXiv",
+    primaryClass = "hep-ph",
+    year = "2026"
+}
+
+@article{Davis:2026xyz,
+    author = "Davis, Carol",
+    title = "{Updated Lattice QCD Results}",
+    eprint = {2605.28789},
+    archivePrefix = "arXiv"
+}
+
+@misc{NoEprint:2026,
+    title = "{No eprint here}"
+}
+)";
+
+    SECTION("Maps each entry to its eprint") {
+        auto entries = Fetcher::ParseInspireBibTeX(BATCH);
+        REQUIRE(entries.size() == 2);
+        REQUIRE_THAT(entries.at("2605.28788"), ContainsSubstring("Smith:2026abc"));
+        REQUIRE_THAT(entries.at("2605.28789"), ContainsSubstring("Davis:2026xyz"));
+    }
+
+    SECTION("Entries do not bleed into each other") {
+        auto entries = Fetcher::ParseInspireBibTeX(BATCH);
+        REQUIRE_FALSE(entries.at("2605.28788").find("Davis") != std::string::npos);
+        REQUIRE_FALSE(entries.at("2605.28789").find("NoEprint") != std::string::npos);
+    }
+
+    SECTION("Returns empty map for empty or non-BibTeX input") {
+        REQUIRE(Fetcher::ParseInspireBibTeX("").empty());
+        REQUIRE(Fetcher::ParseInspireBibTeX("<html>rate limited</html>").empty());
+    }
+}
+
+TEST_CASE("Fetcher::FetchBibTeXBatch", "[fetcher][real][bibtex]") {
+    Fetcher fetcher({"hep-ph"});
+
+    SECTION("Empty id list makes no request") {
+        REQUIRE(fetcher.FetchBibTeXBatch({}).empty());
+        REQUIRE(fetcher.FetchBibTeXBatch({"", ""}).empty());
+    }
+
+    SECTION("Unreachable stand-in server yields no hits instead of throwing") {
+        fetcher.SetInspireBaseUrl("http://127.0.0.1:9");
+        REQUIRE(fetcher.FetchBibTeXBatch({"2605.28788", "2605.28789"}).empty());
+    }
+}
+
+TEST_CASE("Fetcher::FetchBibTeXBatch over recorded InspireHEP replies", "[fetcher][bibtex]") {
+    const std::string base = "https://inspire.test/api";
+    auto root = std::filesystem::temp_directory_path() / "arxiv_fetcher_inspire";
+    std::filesystem::remove_all(root);
+
+    // 30 ids: one full chunk and a chunk of 5, in the sorted order the
+    // queries are built in.
+    const size_t n = Fetcher::INSPIRE_BATCH_SIZE + 5;
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < n; ++i)
+        ids.push_back("2605." + std::to_string(10000 + i));
+    auto chunk_url = [&](size_t begin, size_t end) {
+        std::string query;
+        for (size_t i = begin; i < end; ++i)
+            query += (i > begin ? "+or+eprint+" : "eprint+") + ids[i];
+        return base + "/literature?q=" + query + "&size=" + std::to_string(end - begin) +
+               "&format=bibtex";
+    };
+    auto entry = [](const std::string& eprint) {
+        return "@article{Key:" + eprint + ",\n    eprint = \"" + eprint + "\"\n}\n\n";
+    };
+
+    // The first chunk answers every id but ids[3], plus a record that was
+    // not asked for; the second chunk is not recorded, so it gets a 404.
+    std::string first;
+    for (size_t i = 0; i < Fetcher::INSPIRE_BATCH_SIZE; ++i)
+        if (i != 3)
+            first += entry(ids[i]);
+    first += entry("2605.99999");
+    auto path = root / FixtureTransport::KeyFor(chunk_url(0, Fetcher::INSPIRE_BATCH_SIZE));
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << first;
+
+    auto transport = std::make_unique<FixtureTransport>(root);
+    auto* fixtures = transport.get();
+    Fetcher fetcher({"hep-ph"}, (root / "downloads").string(), std::move(transport));
+    fetcher.SetInspireBaseUrl(base);
+
+    // Shuffled, with a duplicate and an empty id.
+    std::vector<std::string> request(ids.rbegin(), ids.rend());
+    request.push_back(ids[0]);
+    request.push_back("");
+    auto resolved = fetcher.FetchBibTeXBatch(request);
+
+    SECTION("One request per chunk of INSPIRE_BATCH_SIZE") {
+        REQUIRE(fixtures->RequestCount() == 2);
+    }
+
+    SECTION("Entries map back to their eprints") {
+        REQUIRE(resolved.size() == Fetcher::INSPIRE_BATCH_SIZE - 1);
+        for (size_t i = 0; i < Fetcher::INSPIRE_BATCH_SIZE; ++i) {
+            if (i == 3)
+                continue;
+            REQUIRE(resolved.count(ids[i]) == 1);
+            REQUIRE_THAT(resolved.at(ids[i]), ContainsSubstring("Key:" + ids[i] + ","));
+        }
+    }
+
+    SECTION("Records for ids that were not requested are dropped") {
+        REQUIRE(resolved.count("2605.99999") == 0);
+    }
+
+    SECTION("Misses are left out for the caller's fallback") {
+        // Absent from a successful reply, and in a failed chunk.
+        REQUIRE(resolved.count(ids[3]) == 0);
+        for (size_t i = Fetcher::INSPIRE_BATCH_SIZE; i < n; ++i)
+            REQUIRE(resolved.count(ids[i]) == 0);
+    }
+
+    std::filesystem::remove_all(root);
+}
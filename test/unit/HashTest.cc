@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Hash.hh"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+using namespace Arxiv;
+
+static uint64_t xxh64(const std::string& s, uint64_t seed = 0) {
+    return Hash::Xxh64(s.data(), s.size(), seed);
+}
+
+TEST_CASE("Hash::Xxh64 matches the reference implementation", "[hash]") {
+    SECTION("Short inputs take the tail-only path") {
+        REQUIRE(xxh64("") == 0xEF46DB3751D8E999ULL);
+        REQUIRE(xxh64("a") == 0xD24EC4F1A98C6E5BULL);
+        REQUIRE(xxh64("abc") == 0x44BC2CF5AD770999ULL);
+    }
+
+    SECTION("Inputs of 32 bytes or more use the four-lane loop") {
+        REQUIRE(xxh64("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ULL);
+    }
+
+    SECTION("Every length hashes differently, and the seed matters") {
+        const std::string text(100, 'x');
+        std::vector<uint64_t> seen;
+        for (size_t n = 0; n <= text.size(); ++n)
+            seen.push_back(Hash::Xxh64(text.data(), n));
+        std::sort(seen.begin(), seen.end());
+        REQUIRE(std::unique(seen.begin(), seen.end()) == seen.end());
+        REQUIRE(xxh64("abc", 1) != xxh64("abc"));
+    }
+}
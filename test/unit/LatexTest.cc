@@ -97,3 +97,46 @@ TEST_CASE("StripLatex: unmatched $ does not crash", "[latex]") {
     std::string result;
     REQUIRE_NOTHROW(result = Arxiv::StripLatex("dangling $ sign"));
 }
+
+// ---------------------------------------------------------------------------
+// TranscodeLatex — single-pass plain + Markdown rendering
+// ---------------------------------------------------------------------------
+
+TEST_CASE("TranscodeLatex: text without metacharacters passes through", "[latex]") {
+    REQUIRE_FALSE(Arxiv::HasLatexMarkup("Higgs pair production at the LHC"));
+    auto forms = Arxiv::TranscodeLatex("Higgs pair production at the LHC");
+    REQUIRE(forms.plain == "Higgs pair production at the LHC");
+    REQUIRE(forms.markdown == "Higgs pair production at the LHC");
+}
+
+TEST_CASE("TranscodeLatex: both forms agree with the single-form entry points", "[latex]") {
+    const std::string input =
+        "We present $\\hat{p}_T$ spectra for \\textbf{heavy-ion} collisions by G\\\"unter "
+        "and Sch\\'{e}ma using \\emph{jet \\textit{sub}structure} \\cite{ref}.";
+    auto forms = Arxiv::TranscodeLatex(input);
+    REQUIRE(forms.plain == Arxiv::StripLatex(input));
+    REQUIRE(forms.markdown == Arxiv::LatexToMarkdown(input));
+    REQUIRE(forms.markdown ==
+            "We present $\\hat{p}_T$ spectra for **heavy-ion** collisions by Günter "
+            "and Schéma using *jet *sub*structure* \\cite{ref}.");
+    REQUIRE_THAT(forms.plain, ContainsSubstring("Günter"));
+    REQUIRE_THAT(forms.plain, ContainsSubstring("substructure"));
+    REQUIRE_THAT(forms.plain, !ContainsSubstring("\\"));
+}
+
+TEST_CASE("TranscodeLatex: accent and letter macros", "[latex]") {
+    REQUIRE(Arxiv::LatexToMarkdown("\\v{S}koda \\c{c}a \\r{a}") == "Škoda ça å");
+    REQUIRE(Arxiv::LatexToMarkdown("Stra\\ss{}e, \\o ber") == "Straße, ø ber");
+    // Letter macros only match whole command names.
+    REQUIRE(Arxiv::LatexToMarkdown("$\\omega$ and \\left") == "$\\omega$ and \\left");
+}
+
+TEST_CASE("TranscodeLatex: escapes and malformed input", "[latex]") {
+    auto forms = Arxiv::TranscodeLatex("50\\% of \\textbf{open");
+    REQUIRE(forms.markdown == "50\\% of \\textbf{open");
+    REQUIRE_THAT(forms.plain, ContainsSubstring("50%"));
+    REQUIRE_THAT(forms.plain, ContainsSubstring("open"));
+
+    REQUIRE(Arxiv::LatexToMarkdown("trailing \\") == "trailing \\");
+    REQUIRE(Arxiv::ReplaceLatexAccents("\\textbf{Erd\\H{o}s} \\'e") == "\\textbf{Erd\\H{o}s} é");
+}
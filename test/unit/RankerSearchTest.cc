@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/RankerSearch.hh"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace Arxiv;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Ratings that follow the topic: physics 5, cooking 1.
+struct Rated {
+    TermDictionary dict;
+    std::vector<TermList> docs;
+    std::vector<std::pair<TermList, int>> rated;
+};
+
+static Rated rated_corpus(int n) {
+    const char* physics[] = {"quantum", "field", "gauge", "lattice", "hadron", "quark"};
+    const char* cooking[] = {"recipe", "flour", "baking", "yeast", "sourdough", "oven"};
+    Rated out;
+    for (int i = 0; i < n; ++i) {
+        const bool pos = i % 2 == 0;
+        const char** words = pos ? physics : cooking;
+        Article a;
+        a.link = "https://arxiv.org/abs/search." + std::to_string(i);
+        a.title = std::string(words[i % 6]) + " " + words[(i + 1) % 6] + " study";
+        a.abstract = std::string(words[(i + 2) % 6]) + " " + words[(i + 3) % 6] + " results " +
+                     std::to_string(i);
+        out.docs.push_back(Ranker::Terms(a, out.dict, true));
+        out.rated.emplace_back(out.docs.back(), pos ? 5 : 1);
+    }
+    return out;
+}
+
+static std::tuple<int, float, int, int> key(const Ranker::Hyperparameters& p) {
+    return {p.hidden, p.learning_rate, p.epochs, p.max_features};
+}
+
+// ---------------------------------------------------------------------------
+// Candidates
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RankerSearch candidates", "[ranker_search]") {
+    SECTION("The defaults come first, followed by distinct grid points") {
+        const RankerSearch search{Ranker{}};
+        const auto& candidates = search.Candidates();
+        REQUIRE(candidates.size() == static_cast<size_t>(RankerSearch::TRIALS));
+        REQUIRE(candidates.front() == Ranker::Hyperparameters{});
+        std::set<std::tuple<int, float, int, int>> distinct;
+        for (const auto& p : candidates)
+            distinct.insert(key(p));
+        REQUIRE(distinct.size() == candidates.size());
+    }
+
+    SECTION("The same seed draws the same candidates") {
+        REQUIRE(RankerSearch(Ranker{}, 8, 7).Candidates() ==
+                RankerSearch(Ranker{}, 8, 7).Candidates());
+        REQUIRE(RankerSearch(Ranker{}, 8, 7).Candidates() !=
+                RankerSearch(Ranker{}, 8, 8).Candidates());
+    }
+
+    SECTION("Trial counts are bounded by the grid") {
+        REQUIRE(RankerSearch(Ranker{}, 0).Candidates().size() == 1);
+        REQUIRE(RankerSearch(Ranker{}, 1000).Candidates().size() == 81);
+        // Three of the four hyperparameters for the hashed vectoriser.
+        const RankerSearch hashed(Ranker{12}, 1000);
+        REQUIRE(hashed.Candidates().size() == 27);
+        for (const auto& p : hashed.Candidates())
+            REQUIRE(p.max_features == Ranker::MAX_FEATURES);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Cross-validation
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RankerSearch cross-validation", "[ranker_search]") {
+    auto corpus = rated_corpus(40);
+    int fits = 0;
+    const RankerSearch::FitFn fit = [&](Ranker& r) {
+        ++fits;
+        r.FitVocabulary(corpus.docs, corpus.dict);
+    };
+    const RankerSearch::ColumnsFn columns = [&](const Ranker& r) {
+        Ranker::ColumnMap map;
+        r.MapColumns(corpus.dict, map);
+        return map;
+    };
+    const RankerSearch search(Ranker{}, 6);
+
+    SECTION("Too few ratings: nothing is fitted or trained") {
+        auto few = corpus.rated;
+        few.resize(RankerSearch::MIN_RATINGS - 1);
+        REQUIRE(search.Run(few, fit, columns).empty());
+        REQUIRE(fits == 0);
+    }
+
+    SECTION("Every candidate is scored, best first, better than guessing the mean") {
+        const auto trials = search.Run(corpus.rated, fit, columns, nullptr, 2);
+        REQUIRE(trials.size() == search.Candidates().size());
+        REQUIRE(std::is_sorted(trials.begin(), trials.end(), [](const auto& a, const auto& b) {
+            return a.mse < b.mse;
+        }));
+        for (const auto& candidate : search.Candidates())
+            REQUIRE(std::any_of(trials.begin(), trials.end(), [&](const auto& t) {
+                return t.params == candidate;
+            }));
+        // Ratings are 1 and 5 in equal measure: predicting 3 scores 4.
+        REQUIRE(trials.front().mse < 1.0f);
+
+        // One fit per distinct vocabulary size, however many folds.
+        std::set<int> sizes;
+        for (const auto& p : search.Candidates())
+            sizes.insert(p.max_features);
+        REQUIRE(fits == static_cast<int>(sizes.size()));
+    }
+
+    SECTION("The result does not depend on the worker count") {
+        const auto serial = search.Run(corpus.rated, fit, columns, nullptr, 1);
+        const auto parallel = search.Run(corpus.rated, fit, columns, nullptr, 4);
+        REQUIRE(serial.size() == parallel.size());
+        for (size_t i = 0; i < serial.size(); ++i) {
+            REQUIRE(serial[i].params == parallel[i].params);
+            REQUIRE(serial[i].mse == parallel[i].mse);
+        }
+    }
+
+    SECTION("The hashed vectoriser needs no fitting") {
+        const RankerSearch hashed(Ranker{12}, 4);
+        const RankerSearch::FitFn no_fit = [&](Ranker&) { ++fits; };
+        const auto trials = hashed.Run(corpus.rated, no_fit, columns, nullptr, 2);
+        REQUIRE(trials.size() == 4);
+        REQUIRE(fits == 1);
+        REQUIRE(trials.front().mse < 1.0f);
+    }
+
+    SECTION("A cancelled search returns nothing") {
+        CancellationToken cancel;
+        cancel.Cancel();
+        REQUIRE(search.Run(corpus.rated, fit, columns, &cancel).empty());
+    }
+}
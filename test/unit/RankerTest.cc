@@ -3,11 +3,14 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <Arxiv/Ranker.hh>
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <cmath>
+#include <cstdio>
 #include <fixtures/test_data.hh>
 #include <fstream>
+#include <iterator>
 
 using namespace Arxiv;
 using namespace arxiv_tui::test::fixtures;
@@ -96,6 +99,36 @@ TEST_CASE("Ranker predictions in valid range", "[ranker]") {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Ranker — cancellation
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker training honours cancellation", "[ranker]") {
+    std::vector<Article> corpus;
+    std::vector<std::pair<Article, int>> rated;
+    for (int i = 0; i < 6; ++i) {
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/cancel." + std::to_string(i);
+        a.title = "Article about topic " + std::to_string(i);
+        corpus.push_back(a);
+        rated.emplace_back(a, (i % 5) + 1);
+    }
+    Ranker ranker;
+    ranker.FitVocabulary(corpus);
+
+    SECTION("A cancelled run reports failure and leaves the model untrained") {
+        CancellationToken cancel;
+        cancel.Cancel();
+        REQUIRE_FALSE(ranker.Train(rated, false, &cancel));
+        REQUIRE_FALSE(ranker.IsTrained());
+    }
+
+    SECTION("An untouched token lets training complete") {
+        CancellationToken cancel;
+        REQUIRE(ranker.Train(rated, false, &cancel));
+        REQUIRE(ranker.IsTrained());
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Ranker — high-rated content scores higher than low-rated on average
 // ---------------------------------------------------------------------------
@@ -149,6 +182,93 @@ TEST_CASE("Ranker learns preference signal", "[ranker]") {
     REQUIRE(pos_score > neg_score);
 }
 
+// ---------------------------------------------------------------------------
+// Ranker — mini-batches across workers, with a validation split
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker mini-batch training", "[ranker]") {
+    // Enough ratings for several mini-batches and a held-out split.
+    const char* pos_words[] = {"quantum", "field", "gauge", "lattice", "hadron"};
+    const char* neg_words[] = {"cooking", "recipes", "baking", "pastry", "kitchen"};
+    std::vector<Article> corpus;
+    std::vector<std::pair<Article, int>> rated;
+    for (int i = 0; i < 300; ++i) {
+        const bool pos = i % 2 == 0;
+        const auto& words = pos ? pos_words : neg_words;
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/batch." + std::to_string(i);
+        a.title = std::string(words[i % 5]) + " " + words[(i / 5) % 5] + " study";
+        a.abstract = std::string(words[(i + 2) % 5]) + " results number" + std::to_string(i);
+        corpus.push_back(a);
+        rated.emplace_back(a, pos ? 5 : 1);
+    }
+    REQUIRE(rated.size() >= static_cast<size_t>(Ranker::MIN_VALIDATION));
+
+    Article pos_test = sample_articles[0];
+    pos_test.title = "Lattice gauge field";
+    pos_test.abstract = "Quantum hadron";
+    Article neg_test = sample_articles[0];
+    neg_test.title = "Pastry baking kitchen";
+    neg_test.abstract = "Cooking recipes";
+
+    auto train = [&](unsigned threads) {
+        Ranker ranker;
+        ranker.FitVocabulary(corpus);
+        REQUIRE(ranker.Train(rated, false, nullptr, threads));
+        return ranker;
+    };
+
+    SECTION("Learns the preference with one worker or several") {
+        for (unsigned threads : {1u, 4u}) {
+            Ranker ranker = train(threads);
+            REQUIRE(ranker.Predict(pos_test) > ranker.Predict(neg_test) + 1.0f);
+        }
+    }
+
+    SECTION("A fixed worker count gives identical weights") {
+        Ranker a = train(4);
+        Ranker b = train(4);
+        for (const auto& article : corpus)
+            REQUIRE(a.Predict(article) == b.Predict(article));
+    }
+
+    SECTION("Warm-starting a trained model keeps the learned preference") {
+        Ranker ranker = train(2);
+        REQUIRE(ranker.Train(rated, true, nullptr, 2));
+        REQUIRE(ranker.Predict(pos_test) > ranker.Predict(neg_test) + 1.0f);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Ranker — online updates
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker::Update", "[ranker]") {
+    std::vector<Article> corpus;
+    std::vector<std::pair<Article, int>> rated;
+    for (int i = 0; i < 6; ++i) {
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/online." + std::to_string(i);
+        a.title = (i % 2 ? "Quantum field theory " : "Cooking recipes ") + std::to_string(i);
+        corpus.push_back(a);
+        rated.emplace_back(a, i % 2 ? 5 : 1);
+    }
+    Ranker ranker;
+    ranker.FitVocabulary(corpus);
+
+    SECTION("Does nothing before the first training run") {
+        REQUIRE_FALSE(ranker.Update({{corpus[0], 5}}));
+        REQUIRE_FALSE(ranker.IsTrained());
+    }
+
+    SECTION("Moves the score of the rated article towards its rating") {
+        REQUIRE(ranker.Train(rated));
+        const float before = ranker.Predict(corpus[0]);
+        std::vector<std::pair<Article, int>> batch = {{corpus[0], 5}};
+        batch.insert(batch.end(), rated.begin() + 1, rated.end());
+        REQUIRE(ranker.Update(batch));
+        REQUIRE(ranker.Predict(corpus[0]) > before);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Ranker — boundary conditions
 // TDD: these tests were written before implementing the guarded behaviour.
@@ -274,4 +394,453 @@ TEST_CASE("Ranker persistence", "[ranker]") {
         Ranker trained = make_trained_ranker();
         REQUIRE_FALSE(trained.Save("/no/such/directory/ranker.bin"));
     }
+
+    SECTION("A corrupted byte anywhere in the file fails the checksum") {
+        const std::string path = "/tmp/arxiv_tui_test_corrupt.bin";
+        REQUIRE(make_trained_ranker().Save(path));
+        std::string bytes;
+        {
+            std::ifstream f(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(f), {});
+        }
+        REQUIRE(bytes.size() > 1024);
+        for (size_t at : {size_t{20}, size_t{200}, bytes.size() / 2, bytes.size() - 1}) {
+            std::string damaged = bytes;
+            damaged[at] = static_cast<char>(damaged[at] ^ 0x10);
+            {
+                std::ofstream f(path, std::ios::binary | std::ios::trunc);
+                f.write(damaged.data(), static_cast<std::streamsize>(damaged.size()));
+            }
+            Ranker r;
+            REQUIRE_FALSE(r.Load(path));
+            REQUIRE_FALSE(r.IsTrained());
+        }
+        {
+            std::ofstream f(path, std::ios::binary | std::ios::trunc);
+            f.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 64));
+        }
+        Ranker r;
+        REQUIRE_FALSE(r.Load(path));
+    }
+
+    SECTION("Version 1 files are still read") {
+        // Empty vocabulary, zero weights, b2 = 0: every article scores 3.
+        const std::string path = "/tmp/arxiv_tui_test_v1.bin";
+        {
+            std::ofstream f(path, std::ios::binary);
+            auto write_i32 = [&f](int32_t v) { f.write(reinterpret_cast<const char*>(&v), 4); };
+            f.write("RANK", 4);
+            write_i32(1);
+            write_i32(0);
+            const std::vector<float> zeros(
+                static_cast<size_t>(Ranker::MAX_FEATURES * (Ranker::HIDDEN_SIZE + 1) +
+                                    2 * Ranker::HIDDEN_SIZE + 1),
+                0.0f);
+            f.write(reinterpret_cast<const char*>(zeros.data()),
+                    static_cast<std::streamsize>(zeros.size() * sizeof(float)));
+            write_i32(1);
+        }
+        Ranker r;
+        REQUIRE(r.Load(path));
+        REQUIRE(r.IsTrained());
+        REQUIRE(r.Predict(sample_articles[0]) == 3.0f);
+    }
+
+    SECTION("A loaded model survives its file being replaced, and can be retrained") {
+        const std::string path = "/tmp/arxiv_tui_test_mapped.bin";
+        Ranker trained = make_trained_ranker();
+        REQUIRE(trained.Save(path));
+
+        Ranker loaded;
+        REQUIRE(loaded.Load(path));
+        Ranker copy = loaded;
+        const float before = loaded.Predict(sample_articles[0]);
+        REQUIRE(before == trained.Predict(sample_articles[0]));
+
+        // Overwrite the file the weights are mapped from.
+        REQUIRE(Ranker{}.Save(path));
+        REQUIRE(loaded.Predict(sample_articles[0]) == before);
+
+        // Training writes to its own copy of the weights, not the mapping.
+        std::vector<std::pair<Article, int>> rated;
+        for (int i = 0; i < Ranker::MIN_TRAIN; ++i) {
+            Article a = sample_articles[0];
+            a.link = "https://arxiv.org/abs/mapped." + std::to_string(i);
+            a.title = "Persistence test article " + std::to_string(i);
+            rated.emplace_back(a, i % 2 == 0 ? 5 : 1);
+        }
+        REQUIRE(loaded.Train(rated, true));
+        REQUIRE(loaded.Predict(sample_articles[0]) != before);
+        REQUIRE(copy.Predict(sample_articles[0]) == before);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Ranker — feature hashing
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker feature hashing", "[ranker]") {
+    std::vector<std::pair<Article, int>> rated;
+    auto base = sample_articles[0];
+    for (int i = 0; i < 4; ++i) {
+        Article pos = base;
+        pos.link = "https://arxiv.org/abs/hpos." + std::to_string(i);
+        pos.title = "Quantum physics field theory study " + std::to_string(i);
+        pos.abstract = "Quantum mechanics field equations physics particles";
+        rated.emplace_back(pos, 5);
+        Article neg = base;
+        neg.link = "https://arxiv.org/abs/hneg." + std::to_string(i);
+        neg.title = "Cooking recipes food preparation " + std::to_string(i);
+        neg.abstract = "Recipes food cooking ingredients baking";
+        rated.emplace_back(neg, 1);
+    }
+    Article pos_test = base;
+    pos_test.title = "Quantum field theory particles";
+    pos_test.abstract = "Physics quantum mechanics equations particles";
+    Article neg_test = base;
+    neg_test.title = "Cooking food recipes";
+    neg_test.abstract = "Food cooking baking ingredients";
+
+    SECTION("Bit counts are clamped; 0 keeps the vocabulary") {
+        REQUIRE_FALSE(Ranker{}.IsHashed());
+        REQUIRE_FALSE(Ranker{0}.IsHashed());
+        REQUIRE(Ranker{3}.HashBits() == Ranker::MIN_HASH_BITS);
+        REQUIRE(Ranker{40}.HashBits() == Ranker::MAX_HASH_BITS);
+    }
+
+    SECTION("Trains without a vocabulary and learns the preference") {
+        Ranker ranker(12);
+        REQUIRE(ranker.Train(rated));
+        REQUIRE(ranker.Predict(pos_test) > ranker.Predict(neg_test));
+    }
+
+    SECTION("FitVocabulary changes nothing, so warm starts stay valid") {
+        Ranker ranker(12);
+        ranker.Train(rated);
+        const auto vocab = ranker.VocabularyHash();
+        const float before = ranker.Predict(pos_test);
+        ranker.FitVocabulary(sample_articles);
+        REQUIRE(ranker.VocabularyHash() == vocab);
+        REQUIRE(ranker.Predict(pos_test) == before);
+        REQUIRE(ranker.Train(rated, /*warm_start=*/true));
+    }
+
+    SECTION("Save/Load round-trip restores the hashed vectoriser") {
+        Ranker ranker(10);
+        ranker.Train(rated);
+        const std::string path = "/tmp/arxiv_tui_test_hashed_ranker.bin";
+        REQUIRE(ranker.Save(path));
+
+        Ranker loaded;
+        REQUIRE(loaded.Load(path));
+        REQUIRE(loaded.HashBits() == 10);
+        REQUIRE(loaded.VocabularyHash() == ranker.VocabularyHash());
+        REQUIRE(loaded.Predict(pos_test) == ranker.Predict(pos_test));
+        REQUIRE(loaded.Predict(neg_test) == ranker.Predict(neg_test));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Ranker — hyperparameters
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker hyperparameters", "[ranker]") {
+    std::vector<Article> corpus;
+    std::vector<std::pair<Article, int>> rated;
+    auto base = sample_articles[0];
+    for (int i = 0; i < 4; ++i) {
+        Article pos = base;
+        pos.link = "https://arxiv.org/abs/hpp." + std::to_string(i);
+        pos.title = "Quantum physics field theory study " + std::to_string(i);
+        pos.abstract = "Quantum mechanics field equations physics particles";
+        corpus.push_back(pos);
+        rated.emplace_back(pos, 5);
+        Article neg = base;
+        neg.link = "https://arxiv.org/abs/hpn." + std::to_string(i);
+        neg.title = "Cooking recipes food preparation " + std::to_string(i);
+        neg.abstract = "Recipes food cooking ingredients baking";
+        corpus.push_back(neg);
+        rated.emplace_back(neg, 1);
+    }
+    Article pos_test = base;
+    pos_test.title = "Quantum field theory particles";
+    pos_test.abstract = "Physics quantum mechanics equations particles";
+    Article neg_test = base;
+    neg_test.title = "Cooking food recipes";
+    neg_test.abstract = "Food cooking baking ingredients";
+
+    Ranker::Hyperparameters small;
+    small.hidden = 8;
+    small.learning_rate = 0.03f;
+    small.epochs = 50;
+    small.max_features = 128;
+
+    SECTION("Defaults are the constants; values are clamped to their bounds") {
+        const auto& defaults = Ranker{}.GetHyperparameters();
+        REQUIRE(defaults.hidden == Ranker::HIDDEN_SIZE);
+        REQUIRE(defaults.learning_rate == Ranker::LR);
+        REQUIRE(defaults.epochs == Ranker::EPOCHS);
+        REQUIRE(defaults.max_features == Ranker::MAX_FEATURES);
+
+        Ranker r;
+        r.SetHyperparameters({1, 0.01f, 0, 1 << 20});
+        REQUIRE(r.GetHyperparameters().hidden == Ranker::MIN_HIDDEN);
+        REQUIRE(r.GetHyperparameters().epochs == 1);
+        REQUIRE(r.GetHyperparameters().max_features == Ranker::MAX_VOCABULARY);
+        r.SetHyperparameters({1000, 0.01f, 10, 1});
+        REQUIRE(r.GetHyperparameters().hidden == Ranker::MAX_HIDDEN);
+        REQUIRE(r.GetHyperparameters().max_features == Ranker::MIN_VOCABULARY);
+    }
+
+    SECTION("The vocabulary survives unless max_features changes") {
+        Ranker r;
+        r.FitVocabulary(corpus);
+        r.Train(rated);
+        const auto vocab = r.VocabularyHash();
+
+        Ranker::Hyperparameters wider = r.GetHyperparameters();
+        wider.hidden = 16;
+        r.SetHyperparameters(wider);
+        REQUIRE_FALSE(r.IsTrained());
+        REQUIRE(r.VocabularyHash() == vocab);
+
+        r.SetHyperparameters(small);
+        REQUIRE(r.VocabularyHash() != vocab);
+    }
+
+    SECTION("A smaller network learns the preference and survives Save/Load") {
+        Ranker r;
+        r.SetHyperparameters(small);
+        r.FitVocabulary(corpus);
+        REQUIRE(r.Train(rated));
+        REQUIRE(r.Predict(pos_test) > r.Predict(neg_test));
+
+        const std::string path = "/tmp/arxiv_tui_test_hyperparameters.bin";
+        REQUIRE(r.Save(path));
+        Ranker loaded;
+        REQUIRE(loaded.Load(path));
+        REQUIRE(loaded.GetHyperparameters() == small);
+        REQUIRE(loaded.VocabularyHash() == r.VocabularyHash());
+        REQUIRE(loaded.Predict(pos_test) == r.Predict(pos_test));
+
+        // Quantised weights are sized by the hidden layer too.
+        loaded.Quantise();
+        REQUIRE(loaded.Save(path));
+        Ranker quantised;
+        REQUIRE(quantised.Load(path));
+        REQUIRE(quantised.IsQuantised());
+        REQUIRE(quantised.GetHyperparameters() == small);
+        REQUIRE(std::abs(quantised.Predict(pos_test) - r.Predict(pos_test)) < 0.05f);
+        std::remove(path.c_str());
+    }
+
+    SECTION("The hashed vectoriser keeps its columns") {
+        Ranker r(10);
+        r.SetHyperparameters(small);
+        REQUIRE(r.HashBits() == 10);
+        REQUIRE(r.Train(rated));
+        REQUIRE(r.Predict(pos_test) > r.Predict(neg_test));
+
+        const std::string path = "/tmp/arxiv_tui_test_hashed_hyperparameters.bin";
+        REQUIRE(r.Save(path));
+        Ranker loaded;
+        REQUIRE(loaded.Load(path));
+        REQUIRE(loaded.HashBits() == 10);
+        REQUIRE(loaded.GetHyperparameters() == small);
+        REQUIRE(loaded.Predict(neg_test) == r.Predict(neg_test));
+        std::remove(path.c_str());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Ranker — batched scoring
+// ---------------------------------------------------------------------------
+// ---------------------------------------------------------------------------
+// Ranker — sparse forward pass against a dense reference
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker matches a dense reference computation", "[ranker]") {
+    // A hashed model written as a version 2 file, whose W1 is hidden-major
+    // (W1[j][k] at j * features + k): Load transposes it to feature-major.
+    const int hash_bits = Ranker::MIN_HASH_BITS;
+    const size_t features = size_t{1} << hash_bits;
+    const auto units = static_cast<size_t>(Ranker::HIDDEN_SIZE);
+    std::vector<float> W1(units * features), b1(units), W2(units);
+    for (size_t j = 0; j < units; ++j) {
+        for (size_t k = 0; k < features; ++k)
+            W1[j * features + k] = std::sin(static_cast<float>(j * 131 + k * 7));
+        b1[j] = 0.05f * std::cos(static_cast<float>(j));
+        W2[j] = 0.5f * std::sin(static_cast<float>(3 * j + 1));
+    }
+    const float b2 = -0.1f;
+
+    const std::string legacy = "/tmp/arxiv_tui_test_dense_v2.bin";
+    {
+        std::ofstream f(legacy, std::ios::binary);
+        auto write_i32 = [&f](int32_t v) { f.write(reinterpret_cast<const char*>(&v), 4); };
+        auto write_floats = [&f](const std::vector<float>& v) {
+            f.write(reinterpret_cast<const char*>(v.data()),
+                    static_cast<std::streamsize>(v.size() * sizeof(float)));
+        };
+        f.write("RANK", 4);
+        write_i32(2);
+        write_i32(hash_bits);
+        write_floats(W1);
+        write_floats(b1);
+        write_floats(W2);
+        write_floats({b2});
+        write_i32(1);
+    }
+
+    // y = 1 + 4 sigmoid(W2 · ReLU(W1 x + b1) + b2), over the dense input.
+    auto reference = [&](const Ranker& ranker, const Article& article) {
+        TermDictionary dict;
+        const auto terms = Ranker::Terms(article, dict, true);
+        Ranker::ColumnMap columns;
+        ranker.MapColumns(dict, columns);
+        Ranker::SparseVector sparse;
+        ranker.Features(terms, columns, sparse);
+        std::vector<float> x(features, 0.0f);
+        for (const auto& [k, v] : sparse)
+            x[static_cast<size_t>(k)] = v;
+
+        float raw = b2;
+        for (size_t j = 0; j < units; ++j) {
+            float h = b1[j];
+            for (size_t k = 0; k < features; ++k)
+                h += W1[j * features + k] * x[k];
+            raw += W2[j] * std::max(h, 0.0f);
+        }
+        return 1.0f + 4.0f / (1.0f + std::exp(-raw));
+    };
+
+    Ranker loaded;
+    REQUIRE(loaded.Load(legacy));
+    REQUIRE(loaded.HashBits() == hash_bits);
+
+    // Saved feature-major in the current format, then mapped back.
+    const std::string current = "/tmp/arxiv_tui_test_dense_v3.bin";
+    REQUIRE(loaded.Save(current));
+    Ranker reloaded;
+    REQUIRE(reloaded.Load(current));
+
+    for (const auto& article : sample_articles) {
+        const float expected = reference(loaded, article);
+        // Only the summation order differs from the reference.
+        REQUIRE(std::abs(loaded.Predict(article) - expected) < 1e-5f);
+        REQUIRE(reloaded.Predict(article) == loaded.Predict(article));
+    }
+    // The weights make a difference, so a misplaced W1 entry would show.
+    REQUIRE(reference(loaded, sample_articles[0]) != reference(loaded, sample_articles[1]));
+    std::remove(legacy.c_str());
+    std::remove(current.c_str());
+}
+
+TEST_CASE("Ranker::PredictBatch", "[ranker]") {
+    Ranker ranker = make_trained_ranker();
+    REQUIRE(ranker.IsTrained());
+
+    // Enough articles to split across several workers.
+    std::vector<Article> batch;
+    for (int i = 0; i < 1000; ++i) {
+        Article a = sample_articles[static_cast<size_t>(i) % sample_articles.size()];
+        a.title += " topic " + std::to_string(i % 7);
+        batch.push_back(a);
+    }
+
+    SECTION("Scores match Predict exactly, in input order") {
+        for (unsigned threads : {1u, 4u, 0u}) {
+            auto scores = ranker.PredictBatch(batch, threads);
+            REQUIRE(scores.size() == batch.size());
+            for (size_t i = 0; i < batch.size(); ++i)
+                REQUIRE(scores[i] == ranker.Predict(batch[i]));
+        }
+    }
+
+    SECTION("An empty batch or an untrained model") {
+        REQUIRE(ranker.PredictBatch({}).empty());
+        Ranker untrained;
+        auto scores = untrained.PredictBatch(batch);
+        REQUIRE(scores.size() == batch.size());
+        REQUIRE(scores.front() == 0.0f);
+        REQUIRE(scores.back() == 0.0f);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Ranker — int8 quantisation
+// ---------------------------------------------------------------------------
+TEST_CASE("Ranker int8 quantisation", "[ranker]") {
+    const char* words[] = {"quantum", "field", "gauge",  "lattice", "hadron",
+                           "cooking", "baking", "pastry", "kitchen", "recipes"};
+    std::vector<Article> corpus;
+    std::vector<std::pair<Article, int>> rated;
+    for (int i = 0; i < 200; ++i) {
+        Article a = sample_articles[0];
+        a.link = "https://arxiv.org/abs/quant." + std::to_string(i);
+        a.title = std::string(words[i % 10]) + " " + words[(i / 10) % 10] + " study";
+        a.abstract = std::string(words[(i * 7) % 10]) + " " + words[(i + 3) % 10] + " results";
+        corpus.push_back(a);
+        rated.emplace_back(a, 1 + (i % 10) / 2);
+    }
+
+    for (int hash_bits : {0, 12}) {
+        INFO("hash_bits = " << hash_bits);
+        Ranker fp32{hash_bits};
+        fp32.FitVocabulary(corpus);
+        REQUIRE(fp32.Train(rated));
+        Ranker int8 = fp32;
+        int8.Quantise();
+        REQUIRE(int8.IsQuantised());
+        REQUIRE_FALSE(fp32.IsQuantised());
+
+        SECTION("Scores stay close to fp32") {
+            // On the 1-5 scale: well under the gap between star ratings.
+            float worst = 0.0f, total = 0.0f;
+            for (const auto& article : corpus) {
+                const float error = std::abs(int8.Predict(article) - fp32.Predict(article));
+                worst = std::max(worst, error);
+                total += error;
+            }
+            INFO("largest score error " << worst);
+            REQUIRE(worst < 0.05f);
+            REQUIRE(total / static_cast<float>(corpus.size()) < 0.01f);
+        }
+
+        SECTION("PredictBatch matches Predict exactly") {
+            auto scores = int8.PredictBatch(corpus, 4);
+            for (size_t i = 0; i < corpus.size(); ++i)
+                REQUIRE(scores[i] == int8.Predict(corpus[i]));
+        }
+
+        SECTION("Training drops the int8 copy") {
+            REQUIRE(int8.Update({rated[0]}));
+            REQUIRE_FALSE(int8.IsQuantised());
+            int8.Quantise();
+            REQUIRE(int8.Train(rated, true));
+            REQUIRE_FALSE(int8.IsQuantised());
+        }
+
+        SECTION("The int8 weights are saved and loaded back") {
+            const std::string path = "/tmp/arxiv_tui_test_quantised.bin";
+            REQUIRE(int8.Save(path));
+            Ranker loaded;
+            REQUIRE(loaded.Load(path));
+            REQUIRE(loaded.IsQuantised());
+            for (const auto& article : corpus)
+                REQUIRE(loaded.Predict(article) == int8.Predict(article));
+            std::remove(path.c_str());
+        }
+    }
+}
+
+TEST_CASE("Ranker::TopK", "[ranker]") {
+    const std::vector<float> scores = {2.0f, 4.5f, 1.0f, 4.5f, 3.0f};
+
+    SECTION("Best first, ties in input order") {
+        REQUIRE(Ranker::TopK(scores, 3) == std::vector<size_t>{1, 3, 4});
+        REQUIRE(Ranker::TopK(scores, scores.size()) == std::vector<size_t>{1, 3, 4, 0, 2});
+    }
+
+    SECTION("k beyond the batch returns everything") {
+        REQUIRE(Ranker::TopK(scores, 100).size() == scores.size());
+        REQUIRE(Ranker::TopK({}, 3).empty());
+    }
 }
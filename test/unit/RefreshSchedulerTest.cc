@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/RefreshScheduler.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ctime>
+
+using namespace Arxiv;
+using namespace std::chrono_literals;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static time_point utc(int y, int m, int d, int hour, int minute = 0) {
+    std::tm tm{};
+    tm.tm_year = y - 1900;
+    tm.tm_mon = m - 1;
+    tm.tm_mday = d;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    return std::chrono::system_clock::from_time_t(timegm(&tm));
+}
+
+// ---------------------------------------------------------------------------
+// Calendar
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RefreshScheduler::EasternOffset follows US daylight time", "[refresh][scheduler]") {
+    SECTION("Standard time in winter, daylight time in summer") {
+        REQUIRE(RefreshScheduler::EasternOffset(utc(2026, 1, 15, 12)) == -5h);
+        REQUIRE(RefreshScheduler::EasternOffset(utc(2026, 7, 15, 12)) == -4h);
+    }
+
+    SECTION("Switches at 02:00 local on the second Sunday of March") {
+        REQUIRE(RefreshScheduler::EasternOffset(utc(2026, 3, 8, 6, 59)) == -5h);
+        REQUIRE(RefreshScheduler::EasternOffset(utc(2026, 3, 8, 7)) == -4h);
+    }
+
+    SECTION("Switches back at 02:00 local on the first Sunday of November") {
+        REQUIRE(RefreshScheduler::EasternOffset(utc(2026, 11, 1, 5, 59)) == -4h);
+        REQUIRE(RefreshScheduler::EasternOffset(utc(2026, 11, 1, 6)) == -5h);
+    }
+
+    SECTION("FromEastern applies the offset in force on that date") {
+        REQUIRE(RefreshScheduler::FromEastern(2026, 1, 5, 20 * 60) == utc(2026, 1, 6, 1));
+        REQUIRE(RefreshScheduler::FromEastern(2026, 10, 15, 20 * 60) == utc(2026, 10, 16, 0));
+    }
+}
+
+TEST_CASE("RefreshScheduler mailing calendar", "[refresh][scheduler]") {
+    RefreshScheduler scheduler;
+    const auto friday_noon = utc(2026, 10, 16, 12);
+
+    SECTION("Mailings go out Sunday through Thursday") {
+        REQUIRE(scheduler.IsMailingDay(2026, 10, 18));       // Sunday
+        REQUIRE(scheduler.IsMailingDay(2026, 10, 22));       // Thursday
+        REQUIRE_FALSE(scheduler.IsMailingDay(2026, 10, 16)); // Friday
+        REQUIRE_FALSE(scheduler.IsMailingDay(2026, 10, 17)); // Saturday
+    }
+
+    SECTION("The weekend gap spans Thursday evening to Sunday evening") {
+        REQUIRE(scheduler.LastMailing(friday_noon) == utc(2026, 10, 16, 0));
+        REQUIRE(scheduler.NextMailing(friday_noon) == utc(2026, 10, 19, 0));
+    }
+
+    SECTION("A mailing is 'last' from its exact publish time") {
+        const auto sunday = utc(2026, 10, 19, 0);
+        REQUIRE(scheduler.LastMailing(sunday) == sunday);
+        REQUIRE(scheduler.NextMailing(sunday) == utc(2026, 10, 20, 0));
+    }
+
+    SECTION("Holidays from the config are skipped") {
+        RefreshScheduler holidays({}, {"2026-10-18", "not-a-date"});
+        REQUIRE_FALSE(holidays.IsMailingDay(2026, 10, 18));
+        REQUIRE(holidays.NextMailing(friday_noon) == utc(2026, 10, 20, 0));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Polling
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RefreshScheduler polling policy", "[refresh][scheduler]") {
+    RefreshScheduler scheduler;
+    const auto sunday_mailing = utc(2026, 10, 19, 0);
+
+    // Caught up with Thursday's mailing on Friday.
+    scheduler.RecordPoll(utc(2026, 10, 16, 12), 0);
+
+    SECTION("Sleeps through the weekend until the next mailing") {
+        REQUIRE(scheduler.NextDue() == sunday_mailing);
+    }
+
+    SECTION("Polls every minute while a mailing is fresh, then backs off") {
+        scheduler.RecordPoll(sunday_mailing, 0);
+        REQUIRE(scheduler.NextDue() == sunday_mailing + 1min);
+        scheduler.RecordPoll(sunday_mailing + 29min, 0);
+        REQUIRE(scheduler.NextDue() == sunday_mailing + 30min);
+
+        auto now = sunday_mailing + 30min;
+        const std::chrono::minutes expected[] = {
+            1min, 2min, 4min, 8min, 16min, 32min, 60min, 60min};
+        for (auto wait : expected) {
+            scheduler.RecordPoll(now, 0);
+            REQUIRE(scheduler.NextDue() - now == wait);
+            now = scheduler.NextDue();
+        }
+    }
+
+    SECTION("New articles end the dense window and reset the backoff") {
+        scheduler.RecordPoll(sunday_mailing + 3min, 7);
+        REQUIRE(scheduler.NextDue() == utc(2026, 10, 20, 0));
+    }
+
+    SECTION("The backoff never sleeps past the next mailing") {
+        auto now = sunday_mailing + 30min;
+        while (now < utc(2026, 10, 19, 23)) {
+            scheduler.RecordPoll(now, 0);
+            now = scheduler.NextDue();
+        }
+        scheduler.RecordPoll(now, 0);
+        REQUIRE(scheduler.NextDue() <= utc(2026, 10, 20, 0));
+    }
+
+    SECTION("Serialise and Restore round-trip the state") {
+        scheduler.RecordPoll(sunday_mailing + 45min, 0);
+        RefreshScheduler restored;
+        restored.Restore(scheduler.Serialise());
+        REQUIRE(restored.NextDue() == scheduler.NextDue());
+        restored.RecordPoll(scheduler.NextDue(), 0);
+        scheduler.RecordPoll(scheduler.NextDue(), 0);
+        REQUIRE(restored.NextDue() == scheduler.NextDue());
+
+        RefreshScheduler untouched;
+        untouched.Restore("garbage");
+        REQUIRE(untouched.NextDue() == time_point{});
+    }
+}
+
+TEST_CASE("RefreshScheduler treats the first poll as caught up", "[refresh][scheduler]") {
+    RefreshScheduler scheduler;
+    // Tuesday afternoon, nothing new: wait for Tuesday evening's mailing
+    // instead of backing off against Monday's.
+    scheduler.RecordPoll(utc(2026, 10, 20, 18), 0);
+    REQUIRE(scheduler.NextDue() == utc(2026, 10, 21, 0));
+}
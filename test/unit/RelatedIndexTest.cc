@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/RelatedIndex.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace Arxiv;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Signatures of three articles on each of three topics, under a hashed
+// ranker so no vocabulary has to be fitted.
+struct Signed {
+    std::vector<std::string> links;
+    std::vector<RelatedIndex::Signature> signatures;
+};
+
+static Signed sign_corpus() {
+    const char* topics[] = {"quantum chromodynamics lattice gluon confinement quark",
+                            "sourdough bread fermentation yeast flour baking",
+                            "convolutional neural network image classification training"};
+    Ranker ranker{16};
+    TermDictionary dict;
+    std::vector<TermList> docs;
+    Signed out;
+    for (int i = 0; i < 9; ++i) {
+        Article a;
+        a.link = "https://arxiv.org/abs/related." + std::to_string(i);
+        a.title = std::string(topics[i % 3]) + " part " + std::to_string(i);
+        a.abstract = std::string(topics[i % 3]) + " results " + std::to_string(i);
+        docs.push_back(Ranker::Terms(a, dict, true));
+        out.links.push_back(a.link);
+    }
+    Ranker::ColumnMap columns;
+    ranker.MapColumns(dict, columns);
+    Ranker::SparseVector vec;
+    for (const auto& terms : docs) {
+        ranker.Features(terms, columns, vec);
+        out.signatures.push_back(RelatedIndex::Sign(vec));
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Signatures
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RelatedIndex signatures", "[related]") {
+    const auto corpus = sign_corpus();
+    const auto& sig = corpus.signatures;
+
+    SECTION("Identical vectors sign identically") {
+        CHECK(RelatedIndex::Distance(sig[0], sig[0]) == 0);
+        CHECK(RelatedIndex::Sign({}) == RelatedIndex::Signature{});
+    }
+
+    SECTION("Articles on one topic are nearer than articles on another") {
+        for (size_t i = 0; i < sig.size(); ++i) {
+            for (size_t j = 0; j < sig.size(); ++j) {
+                if (i == j || i % 3 != j % 3)
+                    continue;
+                for (size_t k = 0; k < sig.size(); ++k) {
+                    if (k % 3 != i % 3)
+                        CHECK(RelatedIndex::Distance(sig[i], sig[j]) <
+                              RelatedIndex::Distance(sig[i], sig[k]));
+                }
+            }
+        }
+    }
+
+    SECTION("Scaling a vector does not change its signature") {
+        Ranker::SparseVector vec{{3, 0.5f}, {17, -0.25f}, {400, 0.75f}};
+        const auto a = RelatedIndex::Sign(vec);
+        for (auto& f : vec)
+            f.value *= 4.0f;
+        CHECK(RelatedIndex::Sign(vec) == a);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RelatedIndex queries", "[related]") {
+    const auto corpus = sign_corpus();
+    RelatedIndex index{42};
+    for (size_t i = 0; i < corpus.links.size(); ++i)
+        index.Add(corpus.links[i], corpus.signatures[i]);
+    REQUIRE(index.Size() == 9);
+    CHECK(index.Vocabulary() == 42);
+
+    SECTION("Nearest first, excluding the article itself") {
+        const auto related = index.Related(corpus.links[0], 8);
+        REQUIRE(related.size() == 8);
+        CHECK((related[0] == corpus.links[3] || related[0] == corpus.links[6]));
+        CHECK((related[1] == corpus.links[3] || related[1] == corpus.links[6]));
+        for (const auto& link : related)
+            CHECK(link != corpus.links[0]);
+    }
+
+    SECTION("At most k results") {
+        CHECK(index.Related(corpus.links[4], 2).size() == 2);
+        CHECK(index.Related(corpus.links[4], 100).size() == 8);
+        CHECK(index.Related(corpus.links[4], 0).empty());
+    }
+
+    SECTION("Unknown links have no neighbours") {
+        CHECK(index.Related("https://arxiv.org/abs/missing", 5).empty());
+    }
+
+    SECTION("Adding a known link replaces its signature") {
+        index.Add(corpus.links[0], corpus.signatures[1]);
+        CHECK(index.Size() == 9);
+        const auto related = index.Related(corpus.links[0], 2);
+        CHECK((related[0] == corpus.links[1] || related[0] == corpus.links[4] ||
+               related[0] == corpus.links[7]));
+    }
+
+    SECTION("Removing keeps the remaining entries queryable") {
+        index.Remove(corpus.links[0]);
+        index.Remove(corpus.links[0]);
+        CHECK(index.Size() == 8);
+        CHECK_FALSE(index.Contains(corpus.links[0]));
+        CHECK(index.Related(corpus.links[0], 5).empty());
+        for (size_t i = 1; i < corpus.links.size(); ++i) {
+            REQUIRE(index.Contains(corpus.links[i]));
+            const auto related = index.Related(corpus.links[i], 8);
+            CHECK(related.size() == 7);
+            const std::string& twin = corpus.links[i % 3 == 0 ? (i == 3 ? 6 : 3) : (i + 3) % 9];
+            CHECK((related[0] == twin || related[1] == twin));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RelatedIndex persistence", "[related]") {
+    const auto corpus = sign_corpus();
+    const fs::path path =
+        fs::temp_directory_path() / ("arxiv_related_" + std::to_string(::getpid()) + ".bin");
+    fs::remove(path);
+
+    RelatedIndex index{7};
+    for (size_t i = 0; i < corpus.links.size(); ++i)
+        index.Add(corpus.links[i], corpus.signatures[i]);
+    REQUIRE(index.Save(path.string()));
+
+    SECTION("Round trip") {
+        RelatedIndex loaded;
+        REQUIRE(loaded.Load(path.string()));
+        CHECK(loaded.Vocabulary() == 7);
+        CHECK(loaded.Size() == index.Size());
+        for (const auto& link : corpus.links)
+            CHECK(loaded.Related(link, 8) == index.Related(link, 8));
+    }
+
+    SECTION("A corrupt file is rejected and the index left alone") {
+        {
+            std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+            f.seekp(100);
+            f.put('\x5a');
+        }
+        RelatedIndex loaded{3};
+        loaded.Add(corpus.links[0], corpus.signatures[0]);
+        CHECK_FALSE(loaded.Load(path.string()));
+        CHECK(loaded.Vocabulary() == 3);
+        CHECK(loaded.Size() == 1);
+    }
+
+    SECTION("A truncated file is rejected") {
+        fs::resize_file(path, fs::file_size(path) - 5);
+        RelatedIndex loaded;
+        CHECK_FALSE(loaded.Load(path.string()));
+        CHECK(loaded.Size() == 0);
+    }
+
+    SECTION("A missing file is not an error") {
+        fs::remove(path);
+        RelatedIndex loaded;
+        CHECK_FALSE(loaded.Load(path.string()));
+    }
+
+    fs::remove(path);
+}
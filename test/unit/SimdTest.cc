@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Simd.hh"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Arxiv;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<float> random_floats(std::size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(n);
+    for (auto& x : v)
+        x = dist(rng);
+    return v;
+}
+
+static std::vector<int8_t> random_int8(std::size_t n, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-127, 127);
+    std::vector<int8_t> v(n);
+    for (auto& x : v)
+        x = static_cast<int8_t>(dist(rng));
+    return v;
+}
+
+static const Simd::Level LEVELS[] = {
+    Simd::Level::Scalar, Simd::Level::SSE2, Simd::Level::AVX2, Simd::Level::AVX512};
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Simd dispatch", "[simd]") {
+    SECTION("The scalar kernels are always available") {
+        REQUIRE(Simd::For(Simd::Level::Scalar).level == Simd::Level::Scalar);
+    }
+
+    SECTION("Unsupported levels fall back to the best supported one") {
+        for (auto level : LEVELS) {
+            const auto& kernels = Simd::For(level);
+            REQUIRE(kernels.level <= level);
+            REQUIRE(kernels.level <= Simd::Detect());
+        }
+        REQUIRE(Simd::For(Simd::Level::AVX512).level == Simd::For(Simd::Detect()).level);
+    }
+
+    SECTION("Active never exceeds the detected level") {
+        REQUIRE(Simd::Active().level <= Simd::Detect());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Kernels against the scalar reference
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Simd kernels match the scalar reference", "[simd]") {
+    const auto& scalar = Simd::For(Simd::Level::Scalar);
+    std::mt19937 rng(42);
+
+    // Every length up to a few full AVX-512 registers, so each tail path runs.
+    for (auto level : LEVELS) {
+        const auto& kernels = Simd::For(level);
+        INFO("kernels: " << kernels.name);
+        for (std::size_t n = 0; n <= 67; ++n) {
+            INFO("n = " << n);
+            auto x = random_floats(n, rng);
+            auto y = random_floats(n, rng);
+
+            auto expected = y;
+            auto actual = y;
+            scalar.axpy(n, 0.37f, x.data(), expected.data());
+            kernels.axpy(n, 0.37f, x.data(), actual.data());
+            for (std::size_t i = 0; i < n; ++i)
+                REQUIRE(actual[i] == Catch::Approx(expected[i]).epsilon(1e-5).margin(1e-6));
+
+            float reference = scalar.dot(n, x.data(), y.data());
+            REQUIRE(kernels.dot(n, x.data(), y.data()) ==
+                    Catch::Approx(reference).epsilon(1e-5).margin(1e-5));
+
+            // Integer accumulation is exact, including at the range limits.
+            auto q = random_int8(n, rng);
+            std::vector<int32_t> acc_expected(n, 1000), acc_actual(n, 1000);
+            for (int8_t a : {int8_t{-127}, int8_t{-3}, int8_t{127}}) {
+                scalar.axpy_i8(n, a, q.data(), acc_expected.data());
+                kernels.axpy_i8(n, a, q.data(), acc_actual.data());
+            }
+            REQUIRE(acc_actual == acc_expected);
+        }
+    }
+}
+
+TEST_CASE("Simd kernels leave memory past n untouched", "[simd]") {
+    std::mt19937 rng(7);
+    for (auto level : LEVELS) {
+        const auto& kernels = Simd::For(level);
+        INFO("kernels: " << kernels.name);
+        auto x = random_floats(32, rng);
+        std::vector<float> y(32, 1.0f);
+        kernels.axpy(13, 2.0f, x.data(), y.data());
+        for (std::size_t i = 13; i < y.size(); ++i)
+            REQUIRE(y[i] == 1.0f);
+
+        auto q = random_int8(32, rng);
+        std::vector<int32_t> acc(32, 1);
+        kernels.axpy_i8(13, 5, q.data(), acc.data());
+        for (std::size_t i = 13; i < acc.size(); ++i)
+            REQUIRE(acc[i] == 1);
+    }
+}
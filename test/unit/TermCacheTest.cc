@@ -0,0 +1,429 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/DatabaseManager.hh"
+#include "Arxiv/Ranker.hh"
+#include "Arxiv/TermCache.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace Arxiv;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<Article> corpus() {
+    const char* topics[] = {"quantum field theory", "cooking recipes", "neural networks"};
+    std::vector<Article> articles;
+    for (int i = 0; i < 12; ++i) {
+        Article a;
+        a.link = "https://arxiv.org/abs/terms." + std::to_string(i);
+        a.title = std::string(topics[i % 3]) + " study " + std::to_string(i);
+        a.abstract = "We examine $\\alpha$ scattering and " + std::string(topics[(i + 1) % 3]) +
+                     " with lattice methods.";
+        a.content_hash = 1000 + static_cast<uint64_t>(i);
+        articles.push_back(a);
+    }
+    return articles;
+}
+
+static std::vector<std::pair<Article, int>> ratings(const std::vector<Article>& articles) {
+    std::vector<std::pair<Article, int>> rated;
+    for (size_t i = 0; i < 6; ++i)
+        rated.emplace_back(articles[i], i % 3 == 0 ? 5 : 1);
+    return rated;
+}
+
+static bool same_terms(const TermList& a, const TermList& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].term != b[i].term || a[i].count != b[i].count)
+            return false;
+    }
+    return true;
+}
+
+// Each term's count, by spelling rather than by id.
+static std::map<std::string, uint32_t> spelled(const TermList& terms, const TermDictionary& dict) {
+    std::map<std::string, uint32_t> out;
+    for (const auto& t : terms)
+        out[dict.Term(t.term)] = t.count;
+    return out;
+}
+
+// Runs `before_store` ahead of the next StoreTerms, as another process
+// writing to the same file in between would.
+struct RacingDatabase : DatabaseManager {
+    using DatabaseManager::DatabaseManager;
+    std::function<void()> before_store;
+
+    bool StoreTerms(std::size_t first_id,
+                    const std::vector<std::string>& new_terms,
+                    const std::vector<ArticleTerms>& rows) override {
+        if (auto fn = std::exchange(before_store, {}))
+            fn();
+        return DatabaseManager::StoreTerms(first_id, new_terms, rows);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Ranker over term lists
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Ranker::Terms", "[terms]") {
+    TermDictionary dict;
+    Article a;
+    a.title = "Lattice gauge";
+    a.abstract = "Lattice simulations of the gauge field";
+    auto count_of = [&dict](const TermList& terms, const std::string& term) {
+        for (const auto& t : terms)
+            if (dict.Term(t.term) == term)
+                return t.count;
+        return 0u;
+    };
+
+    SECTION("Terms only, for the vocabulary vectoriser") {
+        // lattice, gauge, simulations, field.
+        auto terms = Ranker::Terms(a, dict, false);
+        REQUIRE(dict.Size() == 4);
+        REQUIRE(terms.size() == 4);
+        REQUIRE(count_of(terms, "lattice") == Ranker::TITLE_WEIGHT + 1);
+        REQUIRE(count_of(terms, "simulations") == 1);
+        REQUIRE(count_of(terms, "the") == 0);
+    }
+
+    SECTION("With bigrams, for the hashed vectoriser") {
+        auto terms = Ranker::Terms(a, dict, true);
+
+        // lattice, gauge, simulations, field and the bigrams "lattice gauge",
+        // "lattice simulations", "simulations gauge", "gauge field".
+        REQUIRE(dict.Size() == 8);
+        REQUIRE(terms.size() == 8);
+        REQUIRE(count_of(terms, "lattice") == Ranker::TITLE_WEIGHT + 1);
+        REQUIRE(count_of(terms, "lattice gauge") == Ranker::TITLE_WEIGHT);
+        REQUIRE(count_of(terms, "gauge lattice") == 0); // no bigram across fields
+
+        // Ids are stable as the dictionary grows.
+        Article b;
+        b.title = "Gauge theory";
+        auto more = Ranker::Terms(b, dict, true);
+        REQUIRE(dict.Size() == 10);
+        REQUIRE(same_terms(Ranker::Terms(a, dict, true), terms));
+    }
+
+    SECTION("The two modes are cached apart") {
+        REQUIRE(Ranker::TokeniserHash(false) != Ranker::TokeniserHash(true));
+    }
+}
+
+TEST_CASE("Ranker gives the same model from term lists and articles", "[terms][ranker]") {
+    const auto articles = corpus();
+    const auto rated = ratings(articles);
+
+    // 0: fitted vocabulary; 10: hashed terms and bigrams.
+    for (int hash_bits : {0, 10}) {
+        INFO("hash_bits = " << hash_bits);
+        Ranker from_articles(hash_bits);
+        from_articles.FitVocabulary(articles);
+        REQUIRE(from_articles.Train(rated));
+
+        TermCache cache(nullptr, hash_bits > 0);
+        Ranker from_terms(hash_bits);
+        const auto docs = cache.Get(articles);
+        from_terms.FitVocabulary(docs, cache.Dictionary());
+        REQUIRE(from_terms.VocabularyHash() == from_articles.VocabularyHash());
+        REQUIRE(from_terms.Train(cache.Get(rated), cache.Columns(from_terms)));
+
+        const auto expected = from_articles.PredictBatch(articles);
+        REQUIRE(from_terms.PredictBatch(docs, cache.Columns(from_terms)) == expected);
+        REQUIRE(from_articles.PredictBatch(docs, cache.Columns(from_articles)) == expected);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Document frequencies
+// ---------------------------------------------------------------------------
+
+TEST_CASE("DatabaseManager keeps document frequencies of stored lists", "[terms][database]") {
+    DatabaseManager db(":memory:");
+    // ids: 0 alpha, 1 beta, 2 gamma, 3 "alpha beta"
+    db.StoreTerms(0,
+                  {"alpha", "beta", "gamma", "alpha beta"},
+                  {{"a", 1, PackTerms({{0, 2}, {1, 1}, {3, 1}})},
+                   {"b", 1, PackTerms({{0, 1}, {2, 4}})},
+                   {"c", 1, PackTerms({{0, 1}, {1, 1}})}});
+    using Top = std::vector<std::pair<int, std::string>>;
+
+    SECTION("Counts lists, not occurrences, and skips bigrams") {
+        REQUIRE(db.CountTermLists() == 3);
+        REQUIRE(db.GetTopTerms(10) == Top{{3, "alpha"}, {2, "beta"}, {1, "gamma"}});
+        REQUIRE(db.GetTopTerms(1) == Top{{3, "alpha"}});
+    }
+
+    SECTION("Replacing a list moves its counts") {
+        db.StoreTerms(4, {}, {{"c", 2, PackTerms({{2, 1}})}});
+        REQUIRE(db.CountTermLists() == 3);
+        REQUIRE(db.GetTopTerms(10) == Top{{2, "gamma"}, {2, "alpha"}, {1, "beta"}});
+    }
+
+    SECTION("Deleting and pruning subtract, and terms left in no list are dropped") {
+        db.DeleteArticle("b");
+        REQUIRE(db.GetTopTerms(10) == Top{{2, "beta"}, {2, "alpha"}});
+        // Neither remaining link is a stored article.
+        db.PruneArticles(1);
+        REQUIRE(db.CountTermLists() == 0);
+        REQUIRE(db.GetTopTerms(10).empty());
+    }
+
+    SECTION("Clearing empties the table") {
+        db.ClearTerms();
+        REQUIRE(db.GetTopTerms(10).empty());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TermCache
+// ---------------------------------------------------------------------------
+
+TEST_CASE("TermCache", "[terms]") {
+    const fs::path path =
+        fs::temp_directory_path() / ("arxiv_terms_" + std::to_string(::getpid()) + ".db");
+    fs::remove(path);
+    auto articles = corpus();
+
+    std::vector<TermList> first;
+    {
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        first = cache.Get(articles);
+        REQUIRE(cache.Size() == articles.size());
+    }
+
+    SECTION("Lists survive a restart without re-tokenising") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        REQUIRE(cache.Size() == articles.size());
+        const auto dict_size = cache.Dictionary().Size();
+        auto again = cache.Get(articles);
+        REQUIRE(cache.Dictionary().Size() == dict_size);
+        for (size_t i = 0; i < articles.size(); ++i)
+            REQUIRE(same_terms(again[i], first[i]));
+    }
+
+    SECTION("Lists evicted from memory are read back from the database") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db, false, 4);
+        const auto dict_size = cache.Dictionary().Size();
+        for (int pass = 0; pass < 2; ++pass) {
+            auto again = cache.Get(articles);
+            for (size_t i = 0; i < articles.size(); ++i)
+                REQUIRE(same_terms(again[i], first[i]));
+        }
+        REQUIRE(cache.Dictionary().Size() == dict_size);
+        REQUIRE(cache.Size() == articles.size());
+    }
+
+    SECTION("ForEach streams every stored list") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db, false, 4);
+        size_t seen = 0;
+        cache.ForEach([&](const std::string& link, const TermList& terms) {
+            for (size_t i = 0; i < articles.size(); ++i)
+                if (articles[i].link == link) {
+                    REQUIRE(same_terms(terms, first[i]));
+                    ++seen;
+                }
+        });
+        REQUIRE(seen == articles.size());
+    }
+
+    SECTION("A changed article is re-tokenised") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        articles[0].title = "Entirely novel wording";
+        articles[0].content_hash = 7;
+        auto lists = cache.Get({articles[0]});
+        const auto dict = cache.Dictionary();
+        bool found = false;
+        for (const auto& t : lists[0])
+            found = found || dict.Term(t.term) == "novel";
+        REQUIRE(found);
+    }
+
+    SECTION("Deleting an article drops its row") {
+        {
+            DatabaseManager db(path.string());
+            db.DeleteArticle(articles[0].link);
+        }
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        REQUIRE(cache.Size() == articles.size() - 1);
+    }
+
+    SECTION("The frequency table fits the same vocabulary as the lists") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        Ranker from_lists;
+        auto docs = cache.Get(articles);
+        from_lists.FitVocabulary(docs, cache.Dictionary());
+        Ranker from_table;
+        from_table.FitVocabulary(db.GetTopTerms(Ranker::MAX_FEATURES), db.CountTermLists());
+        REQUIRE(db.CountTermLists() == articles.size());
+        REQUIRE(from_table.VocabularyHash() == from_lists.VocabularyHash());
+
+        // Still in step after a delete and a re-tokenised article.
+        db.DeleteArticle(articles[1].link);
+        articles[0].title = "Entirely novel wording";
+        articles[0].content_hash = 7;
+        std::vector<Article> remaining(articles.begin() + 2, articles.end());
+        remaining.push_back(articles[0]);
+        docs = cache.Get(remaining);
+        from_lists.FitVocabulary(docs, cache.Dictionary());
+        from_table.FitVocabulary(db.GetTopTerms(Ranker::MAX_FEATURES), db.CountTermLists());
+        REQUIRE(from_table.VocabularyHash() == from_lists.VocabularyHash());
+    }
+
+    SECTION("A missing frequency table is rebuilt from the lists") {
+        std::vector<std::pair<int, std::string>> expected;
+        {
+            DatabaseManager db(path.string());
+            expected = db.GetTopTerms(Ranker::MAX_FEATURES);
+        }
+        sqlite3* raw = nullptr;
+        REQUIRE(sqlite3_open(path.string().c_str(), &raw) == SQLITE_OK);
+        REQUIRE(sqlite3_exec(raw, "DROP TABLE term_df", nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(raw);
+
+        DatabaseManager db(path.string());
+        REQUIRE_FALSE(expected.empty());
+        REQUIRE(db.GetTopTerms(Ranker::MAX_FEATURES) == expected);
+    }
+
+    SECTION("Backfill tokenises stored articles without lists") {
+        DatabaseManager db(path.string());
+        db.AddArticles(articles);
+        Article extra = articles[0];
+        extra.link = "https://arxiv.org/abs/terms.extra";
+        db.AddArticle(extra);
+        REQUIRE(db.GetArticlesWithoutTerms().size() == 1);
+
+        TermCache cache(&db);
+        cache.Backfill();
+        REQUIRE(db.GetArticlesWithoutTerms().empty());
+        REQUIRE(db.CountTermLists() == articles.size() + 1);
+    }
+
+    SECTION("A different tokeniser discards everything") {
+        {
+            DatabaseManager db(path.string());
+            db.SetMetadata(TermCache::TOKENISER_KEY, "stale");
+        }
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        REQUIRE(cache.Size() == 0);
+        REQUIRE(cache.Dictionary().Size() == 0);
+        REQUIRE(db.GetTerms().empty());
+        REQUIRE(db.GetTopTerms(Ranker::MAX_FEATURES).empty());
+    }
+
+    SECTION("Switching to bigrams discards the lists built without them") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db, true);
+        REQUIRE(cache.Size() == 0);
+        auto lists = cache.Get({articles[0]});
+        REQUIRE(lists[0].size() > first[0].size());
+        REQUIRE(cache.Size() == 1);
+    }
+
+    SECTION("Column maps follow the ranker's vocabulary") {
+        DatabaseManager db(path.string());
+        TermCache cache(&db);
+        Ranker ranker;
+        ranker.FitVocabulary(articles);
+        auto columns = cache.Columns(ranker);
+        REQUIRE(columns.size() == cache.Dictionary().Size());
+
+        Ranker other;
+        other.FitVocabulary({articles[1]});
+        REQUIRE(other.VocabularyHash() != ranker.VocabularyHash());
+        auto other_columns = cache.Columns(other);
+        REQUIRE(other_columns != columns);
+        REQUIRE(cache.Columns(ranker) == columns);
+    }
+
+    fs::remove(path);
+}
+
+TEST_CASE("TermCache shared by two processes", "[terms]") {
+    const fs::path path =
+        fs::temp_directory_path() / ("arxiv_terms_shared_" + std::to_string(::getpid()) + ".db");
+    fs::remove(path);
+    const auto articles = corpus();
+    const std::vector<Article> daemon_articles(articles.begin(), articles.begin() + 6);
+    const std::vector<Article> tui_articles(articles.begin() + 6, articles.end());
+
+    TermCache reference;
+    const auto expected = reference.Get(articles);
+    const auto reference_dict = reference.Dictionary();
+    auto require_spelled = [&](const std::string& link,
+                               const TermList& terms,
+                               const TermDictionary& dict) {
+        for (size_t i = 0; i < articles.size(); ++i)
+            if (articles[i].link == link)
+                REQUIRE(spelled(terms, dict) == spelled(expected[i], reference_dict));
+    };
+
+    {
+        RacingDatabase tui_db(path.string());
+        DatabaseManager daemon_db(path.string());
+        TermCache tui(&tui_db);
+        TermCache daemon(&daemon_db);
+        tui.Get({tui_articles[0]});
+
+        SECTION("Terms stored by the other are read in with its lists") {
+            daemon.Get(daemon_articles);
+            auto lists = tui.Get(daemon_articles);
+            // Read back rather than re-tokenised into ids of its own.
+            REQUIRE(tui.Dictionary().Size() == daemon.Dictionary().Size());
+            const auto dict = tui.Dictionary();
+            for (size_t i = 0; i < daemon_articles.size(); ++i)
+                require_spelled(daemon_articles[i].link, lists[i], dict);
+        }
+
+        SECTION("Lists whose ids were taken meanwhile are rebuilt") {
+            tui_db.before_store = [&] { daemon.Get(daemon_articles); };
+            auto lists = tui.Get(tui_articles);
+            REQUIRE(!tui_db.before_store);
+            const auto dict = tui.Dictionary();
+            for (size_t i = 0; i < tui_articles.size(); ++i)
+                require_spelled(tui_articles[i].link, lists[i], dict);
+        }
+    }
+
+    // Every list either process stored reads back the same in a third.
+    DatabaseManager db(path.string());
+    const auto terms = db.GetTerms();
+    REQUIRE(terms.size() == db.CountTerms());
+    REQUIRE(std::set<std::string>(terms.begin(), terms.end()).size() == terms.size());
+    TermCache cache(&db);
+    const auto dict = cache.Dictionary();
+    size_t seen = 0;
+    cache.ForEach([&](const std::string& link, const TermList& list) {
+        require_spelled(link, list, dict);
+        ++seen;
+    });
+    REQUIRE(seen == cache.Size());
+    fs::remove(path);
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Tokeniser.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Arxiv;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<std::string> tokens_of(Tokeniser& tokenise, std::string_view text) {
+    const auto& views = tokenise(text);
+    return {views.begin(), views.end()};
+}
+
+// ---------------------------------------------------------------------------
+// Tokeniser
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Tokeniser splits, lower-cases and filters", "[tokeniser]") {
+    Tokeniser tokenise;
+
+    SECTION("Alphanumeric runs of three or more characters, lower-cased") {
+        REQUIRE(tokens_of(tokenise, "The QCD beta-function at NNLO, in 4d") ==
+                std::vector<std::string>{"qcd", "beta", "function", "nnlo"});
+    }
+
+    SECTION("LaTeX markup is stripped first") {
+        REQUIRE(tokens_of(tokenise, "Bounds on $m_\\nu$ from \\emph{Planck}") ==
+                std::vector<std::string>{"bounds", "planck"});
+    }
+
+    SECTION("Non-ASCII bytes split tokens") {
+        REQUIRE(tokens_of(tokenise, "Schrödinger equation") ==
+                std::vector<std::string>{"schr", "dinger", "equation"});
+    }
+
+    SECTION("Empty and all-stop-word text yield nothing") {
+        REQUIRE(tokenise("").empty());
+        REQUIRE(tokenise("which of these were those").empty());
+    }
+
+    SECTION("Views stay valid until the next call") {
+        const auto& first = tokenise("Gravitational waves");
+        REQUIRE(first.size() == 2);
+        REQUIRE(first[1] == "waves");
+    }
+}
+
+TEST_CASE("Tokeniser stop-word table", "[tokeniser]") {
+    for (const char* word : {"the", "and", "between", "further", "through", "she", "a"})
+        REQUIRE(Tokeniser::IsStopWord(word));
+    for (const char* word : {"", "them2", "thee", "quantum", "betwee", "furthers"})
+        REQUIRE_FALSE(Tokeniser::IsStopWord(word));
+}
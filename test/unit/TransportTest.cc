@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2024-2026 Josh Isaacson
+//
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "Arxiv/Article.hh"
+#include "Arxiv/Cancellation.hh"
+#include "Arxiv/Fetcher.hh"
+#include "Arxiv/Transport.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fixtures/test_data.hh>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace Arxiv;
+using namespace arxiv_tui::test::fixtures;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static fs::path make_fixture_dir(const std::string& name) {
+    auto dir = fs::temp_directory_path() / (name + "_" + std::to_string(::getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static void write_fixture(const fs::path& root, const std::string& url, const std::string& body) {
+    auto path = root / FixtureTransport::KeyFor(url);
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << body;
+}
+
+// ---------------------------------------------------------------------------
+// FixtureTransport
+// ---------------------------------------------------------------------------
+
+TEST_CASE("FixtureTransport::KeyFor", "[transport]") {
+    SECTION("Drops the scheme and keeps host and path") {
+        REQUIRE(FixtureTransport::KeyFor("https://arxiv.org/pdf/2403.15001") ==
+                fs::path("arxiv.org/pdf/2403.15001"));
+        REQUIRE(FixtureTransport::KeyFor("http://rss.arxiv.org/rss/hep-ph+hep-ex") ==
+                fs::path("rss.arxiv.org/rss/hep-ph+hep-ex"));
+    }
+
+    SECTION("Distinct queries map to distinct files on the same endpoint") {
+        auto a = FixtureTransport::KeyFor("https://export.arxiv.org/api/query?start=0");
+        auto b = FixtureTransport::KeyFor("https://export.arxiv.org/api/query?start=200");
+        REQUIRE(a != b);
+        REQUIRE(a.parent_path() == fs::path("export.arxiv.org/api"));
+        REQUIRE(a.filename().string().rfind("query@", 0) == 0);
+    }
+}
+
+TEST_CASE("FixtureTransport::Get", "[transport]") {
+    auto root = make_fixture_dir("arxiv_fixture_transport");
+    FixtureTransport transport(root);
+
+    SECTION("Serves the recorded body") {
+        write_fixture(root, "https://arxiv.org/pdf/2403.15001", std::string("%PDF\0bin", 8));
+        auto resp = transport.Get("https://arxiv.org/pdf/2403.15001");
+        REQUIRE(resp.status_code == 200);
+        REQUIRE(resp.text == std::string("%PDF\0bin", 8));
+        REQUIRE(transport.RequestCount() == 1);
+    }
+
+    SECTION("Exact query match wins over the query-less fallback") {
+        write_fixture(root, "https://inspirehep.net/api/literature", "generic");
+        write_fixture(root, "https://inspirehep.net/api/literature?q=eprint+1", "specific");
+        REQUIRE(transport.Get("https://inspirehep.net/api/literature?q=eprint+1").text ==
+                "specific");
+        REQUIRE(transport.Get("https://inspirehep.net/api/literature?q=eprint+2").text ==
+                "generic");
+    }
+
+    SECTION("Missing fixture is a 404") {
+        REQUIRE(transport.Get("https://arxiv.org/pdf/0000.00000").status_code == 404);
+    }
+
+    SECTION("Injected latency delays the reply") {
+        transport.SetLatency(std::chrono::milliseconds{20});
+        auto start = std::chrono::steady_clock::now();
+        transport.Get("https://arxiv.org/pdf/0000.00000");
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{20});
+    }
+
+    SECTION("Cancellation cuts the latency short") {
+        write_fixture(root, "https://arxiv.org/pdf/2403.15001", "%PDF");
+        transport.SetLatency(std::chrono::seconds{10});
+        CancellationToken cancel;
+        std::thread canceller([&cancel] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            cancel.Cancel();
+        });
+        auto start = std::chrono::steady_clock::now();
+        auto resp = transport.Get(
+            "https://arxiv.org/pdf/2403.15001", std::chrono::milliseconds{0}, &cancel);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        canceller.join();
+        REQUIRE(resp.status_code == 0);
+        REQUIRE(resp.text.empty());
+        REQUIRE(elapsed < std::chrono::milliseconds{100});
+    }
+
+    SECTION("An already-cancelled request is never issued") {
+        CancellationToken cancel;
+        cancel.Cancel();
+        REQUIRE(transport.Get("https://arxiv.org/pdf/2403.15001", {}, &cancel).status_code == 0);
+        REQUIRE(transport.RequestCount() == 0);
+    }
+
+    fs::remove_all(root);
+}
+
+// ---------------------------------------------------------------------------
+// Fetcher over FixtureTransport
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Fetcher runs offline against a FixtureTransport", "[transport][fetcher]") {
+    auto root = make_fixture_dir("arxiv_fixture_fetcher");
+    write_fixture(root, "http://rss.arxiv.org/rss/hep-ph", sample_rss_response);
+    write_fixture(root, "https://arxiv.org/pdf/2403.12345", "%PDF-1.5");
+
+    auto transport = std::make_unique<FixtureTransport>(root);
+    auto* fixtures = transport.get();
+    Fetcher fetcher({"hep-ph"}, (root / "downloads").string(), std::move(transport));
+
+    SECTION("Fetch parses the recorded feed") {
+        auto articles = fetcher.Fetch();
+        REQUIRE(articles.size() == 1);
+        REQUIRE(articles[0].link == "https://arxiv.org/abs/2403.12345");
+        REQUIRE(fixtures->RequestCount() == 1);
+    }
+
+    SECTION("DownloadPaper writes the recorded PDF") {
+        REQUIRE(fetcher.DownloadPaper("2403.12345", "2403.12345.pdf"));
+        std::ifstream pdf(root / "downloads" / "2403.12345.pdf", std::ios::binary);
+        std::string body((std::istreambuf_iterator<char>(pdf)), std::istreambuf_iterator<char>());
+        REQUIRE(body == "%PDF-1.5");
+    }
+
+    SECTION("Unrecorded BibTeX lookup yields no hit") {
+        REQUIRE(fetcher.FetchBibTeX("2403.12345").empty());
+    }
+
+    SECTION("A cancelled fetcher stops before issuing requests") {
+        CancellationToken cancel;
+        fetcher.SetCancellationToken(&cancel);
+        cancel.Cancel();
+        REQUIRE(fetcher.Fetch().empty());
+        REQUIRE(fetcher.FetchSince("2024-03-01").empty());
+        REQUIRE(fixtures->RequestCount() == 0);
+    }
+
+    fs::remove_all(root);
+}